@@ -133,6 +133,8 @@ class Opene57Conan(ConanFile):
 
         lib_suffix = "-d" if self.settings.build_type == "Debug" else ""
         self.cpp_info.libs = [f"openE57{lib_suffix}", f"openE57las{lib_suffix}"]
+        if self.settings.os in ["Linux", "FreeBSD"]:
+            self.cpp_info.system_libs.append("pthread")
 
         self.cpp_info.defines.append(f"E57_REFIMPL_REVISION_ID={self.name}-{self.version}")
         if self.options.xml_backend == "xerces":
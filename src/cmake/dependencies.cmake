@@ -21,6 +21,9 @@ endfunction()
 
 include(${CMAKE_CURRENT_LIST_DIR}/xml_backend.cmake)
 
+# Threads are used for reading ahead in CompressedVectorReader
+find_package(Threads REQUIRED)
+
 # Find doctest (Required by Tests)
 if(BUILD_TESTS)
   find_package(doctest REQUIRED)
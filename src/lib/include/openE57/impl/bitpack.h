@@ -0,0 +1,156 @@
+/*
+ * bitpack.h - Packing and extraction of fixed width integers in E57 bitpacked bytestreams.
+ *
+ * Copyright (c) 2024 openE57 Contributors
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BITPACK_H
+#define BITPACK_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace e57
+{
+namespace utils
+{
+  /**
+   * @brief Implementations of the bitpack routines, all of them give bit-identical results.
+   */
+  enum class BitpackEngine
+  {
+    Scalar, //!< Portable one value at a time implementation
+    Sse41,  //!< x86-64 SSE4.1, unpacks widths up to 24 bits with byte shuffles, packs and quantizes two values per instruction
+    Avx2,   //!< x86-64 AVX2, unpacks all widths with shuffles or gathers, packs and quantizes four values per instruction
+    Neon    //!< ARMv8 NEON, unpacks widths up to 25 bits with table lookups, packs two values per instruction, quantizes with the scalar code
+  };
+
+  /**
+   * @brief Extracts fixed width unsigned values from a little endian bitstream, as written by the E57 bitpack codec.
+   * @details Value k occupies bits firstBit + k * bits ... firstBit + (k + 1) * bits - 1 of buf, where bit n is bit (n % 8) of byte n / 8.
+   * Only the first size bytes of buf are read, so firstBit + count * bits must not exceed 8 * size.
+   * Widths the vector engines don't cover, and values too close to the end of buf for a full vector load, are extracted by the scalar engine.
+   */
+  void unpack_bits(const void*    buf,      //!< Start of the bitstream
+                   std::size_t    size,     //!< Number of readable bytes at buf
+                   std::size_t    firstBit, //!< Bit offset of the first value
+                   unsigned       bits,     //!< Width of each value, 1 to 32
+                   std::size_t    count,    //!< Number of values to extract
+                   std::uint32_t* out       //!< Destination for count values
+                   ) noexcept;
+
+  /**
+   * @brief Extracts fixed width unsigned values of up to 64 bits from a little endian bitstream.
+   * @details Same as the 32 bit version, for widths 1 to 64.
+   */
+  void unpack_bits(const void*    buf,      //!< Start of the bitstream
+                   std::size_t    size,     //!< Number of readable bytes at buf
+                   std::size_t    firstBit, //!< Bit offset of the first value
+                   unsigned       bits,     //!< Width of each value, 1 to 64
+                   std::size_t    count,    //!< Number of values to extract
+                   std::uint64_t* out       //!< Destination for count values
+                   ) noexcept;
+
+  /**
+   * @brief Appends fixed width unsigned values to a little endian bitstream, the inverse of unpack_bits().
+   * @details The stream is written a 64 bit word at a time.  The last, incomplete, word is kept in pending, of which the low pendingBits bits are used,
+   * and is continued by the next call.  Values must not have bits set at or above bit number bits.
+   * At most (pendingBits + count * bits) / 64 words are stored at out.
+   *
+   * @return the number of 64 bit words stored at out
+   */
+  std::size_t pack_bits(const std::uint32_t* values,      //!< Values to append
+                        std::size_t          count,       //!< Number of values
+                        unsigned             bits,        //!< Width of each value, 1 to 32
+                        std::uint64_t&       pending,     //!< Incomplete last word of the stream, updated
+                        unsigned&            pendingBits, //!< Number of bits used in pending (0 to 63), updated
+                        void*                out          //!< Destination for the completed words, need not be aligned
+                        ) noexcept;
+
+  /**
+   * @brief Appends fixed width unsigned values of up to 64 bits to a little endian bitstream.
+   * @details Same as the 32 bit version, for widths 1 to 64.  Values this wide don't gain from merging in vector registers, so this is always scalar.
+   *
+   * @return the number of 64 bit words stored at out
+   */
+  std::size_t pack_bits(const std::uint64_t* values,      //!< Values to append
+                        std::size_t          count,       //!< Number of values
+                        unsigned             bits,        //!< Width of each value, 1 to 64
+                        std::uint64_t&       pending,     //!< Incomplete last word of the stream, updated
+                        unsigned&            pendingBits, //!< Number of bits used in pending (0 to 63), updated
+                        void*                out          //!< Destination for the completed words, need not be aligned
+                        ) noexcept;
+
+  /**
+   * @brief Converts real values to the raw values of a ScaledInteger field, relative to its minimum.
+   * @details out[k] = floor((values[k] - offset) / scale + 0.5) - minimum, computed exactly as the scalar expression in double precision.
+   * The range maximum - minimum must fit in 32 bits, and minimum and maximum must be exactly representable as doubles (magnitude at most 2^53).
+   *
+   * @return true if every value was within minimum and maximum, false otherwise (out is then unspecified)
+   */
+  [[nodiscard]] bool quantize(const double*  values,  //!< Contiguous real values
+                              std::size_t    count,   //!< Number of values
+                              double         scale,   //!< Field scale, non zero
+                              double         offset,  //!< Field offset
+                              std::int64_t   minimum, //!< Field minimum raw value
+                              std::int64_t   maximum, //!< Field maximum raw value
+                              std::uint32_t* out      //!< Destination for count raw values
+                              ) noexcept;
+
+  /**
+   * @brief Same as unpack_bits(), with the given engine.
+   * @details If the engine is not supported by the running CPU, the scalar engine is used instead.  Same for the other engine overloads below.
+   */
+  void unpack_bits(const void* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, std::uint32_t* out,
+                   BitpackEngine engine //!< Implementation to use
+                   ) noexcept;
+  void unpack_bits(const void* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, std::uint64_t* out,
+                   BitpackEngine engine //!< Implementation to use
+                   ) noexcept;
+  std::size_t pack_bits(const std::uint32_t* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits, void* out,
+                        BitpackEngine engine //!< Implementation to use
+                        ) noexcept;
+  [[nodiscard]] bool quantize(const double* values, std::size_t count, double scale, double offset, std::int64_t minimum, std::int64_t maximum,
+                              std::uint32_t* out,
+                              BitpackEngine  engine //!< Implementation to use
+                              ) noexcept;
+
+  /**
+   * @brief Checks if the running CPU supports a bitpack engine.
+   *
+   * @return true if the engine can be used, false otherwise
+   */
+  [[nodiscard]] bool bitpack_engine_supported(BitpackEngine engine) noexcept;
+
+  /**
+   * @brief Obtains the engine that the bitpack routines dispatch to on the running CPU.
+   *
+   * @return the selected engine
+   */
+  [[nodiscard]] BitpackEngine bitpack_engine() noexcept;
+} // namespace utils
+} // namespace e57
+
+#endif // BITPACK_H
@@ -0,0 +1,87 @@
+/*
+ * crc32c.h - CRC32C (Castagnoli) checksums used for E57 page checksums.
+ *
+ * Copyright (c) 2024 openE57 Contributors
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace e57
+{
+namespace utils
+{
+  /**
+   * @brief Implementations of the CRC32C computation, all of them give bit-identical results.
+   */
+  enum class Crc32cEngine
+  {
+    Table,      //!< Portable table driven implementation from impl/crc.h
+    Sse42,      //!< x86-64 SSE4.2 crc32 instruction
+    Sse42Clmul, //!< x86-64 SSE4.2 crc32 on three interleaved streams, recombined with PCLMULQDQ (for long runs)
+    Armv8       //!< ARMv8 CRC32 extension
+  };
+
+  /**
+   * @brief Computes the CRC32C of a buffer with the fastest engine supported by the running CPU.
+   * @details The result is the same as CRC::Calculate(buf, size, CRC::CRC_32_C()) from impl/crc.h.
+   *
+   * @return the checksum
+   */
+  [[nodiscard]] std::uint32_t crc32c(const void* buf, //!< Start of the bytes to checksum
+                                     std::size_t size //!< Number of bytes to checksum
+                                     ) noexcept;
+
+  /**
+   * @brief Computes the CRC32C of a buffer with the given engine.
+   * @details If the engine is not supported by the running CPU, the table engine is used instead.
+   *
+   * @return the checksum
+   */
+  [[nodiscard]] std::uint32_t crc32c(const void*  buf,   //!< Start of the bytes to checksum
+                                     std::size_t  size,  //!< Number of bytes to checksum
+                                     Crc32cEngine engine //!< Implementation to use
+                                     ) noexcept;
+
+  /**
+   * @brief Checks if the running CPU supports a CRC32C engine.
+   *
+   * @return true if the engine can be used, false otherwise
+   */
+  [[nodiscard]] bool crc32c_engine_supported(Crc32cEngine engine) noexcept;
+
+  /**
+   * @brief Obtains the engine that crc32c(buf, size) dispatches to on the running CPU.
+   *
+   * @return the selected engine
+   */
+  [[nodiscard]] Crc32cEngine crc32c_engine() noexcept;
+} // namespace utils
+} // namespace e57
+
+#endif // CRC32C_H
@@ -32,12 +32,26 @@
 #define E57FOUNDATIONIMPL_H_INCLUDED
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 // Define the following symbol adds some functions to the API for implementation purposes.
@@ -234,6 +248,8 @@ template <typename RegisterT>
 class BitpackIntegerDecoder;
 class E57XmlParser;
 class Encoder;
+class CompressedVectorSection;
+class PacketReadCache;
 
 /// Version numbers of ASTM standard that this library supports
 constexpr uint32_t E57_FORMAT_MAJOR = 1; // Changed from 0 to 1 by SC
@@ -280,6 +296,7 @@ public:
   enum Mode
   {
     readOnly,
+    readOnlyMapped, // like readOnly, but pages are read from a memory mapping of the file when the platform supports it
     writeCreate,
     writeExisting
   };
@@ -292,11 +309,15 @@ public:
   static const size_t   physicalPageSize;
   static const uint64_t physicalPageSizeMask;
   static const size_t   logicalPageSize;
+  static const size_t   readBatchPages;  // max physical pages fetched by one read call in read()
+  static const size_t   writeCachePages; // max dirty pages held before write() flushes them
 
   CheckedFile(ustring fileName, Mode mode);
   ~CheckedFile();
 
   void read(char* buf, size_t nRead, size_t bufSize = 0);
+  void readAt(uint64_t logicalOffset, char* buf, size_t nRead, std::vector<char>& pageBuffer);
+  bool canReadConcurrently();
   //???void       write(char* buf, size_t nWrite, size_t bufSize = 0);
   void         write(const char* buf, size_t nWrite);
   CheckedFile& operator<<(const ustring& s);
@@ -316,6 +337,13 @@ public:
   void close();
   void unlink();
 
+  /// Write queue: writeQueued() hands a buffer to an I/O thread, which copies it into the pages, checksums and writes them later.
+  /// Every other call waits for the queued writes to finish first, and reports the error of a queued write that failed.
+  void              startWriteQueue(unsigned bufferCount);
+  unsigned          writeQueueSize() const { return (writeQueueSize_); }
+  std::vector<char> writeQueueBuffer();
+  void              writeQueued(uint64_t logicalOffset, std::vector<char>&& buffer, size_t nWrite);
+
   static size_t efficientBufferSize(size_t logicalSize); //??? needed?
 
   static inline uint64_t logicalToPhysical(uint64_t logicalOffset);
@@ -330,11 +358,58 @@ private:
   int      fd_;
   bool     readOnly_;
   uint64_t logicalLength_;
+  uint64_t position_;   // physical offset of cursor
+  uint64_t fileLength_; // physical length of file on disk, not counting cached pages
+
+  /// Memory mapped read mode, map_ is nullptr when reading through fd_
+  char*             map_;
+  uint64_t          mapLength_;
+  std::vector<bool> mapPageVerified_;
+
+  /// Staging area for the physical pages of multi-page reads, reused between calls
+  std::vector<char> readBuffer_;
+
+  /// Write-behind cache of dirty physical pages, keyed by page number.
+  /// Checksums are only calculated when the pages are flushed, in runs of consecutive pages.
+  std::map<uint64_t, std::vector<char>> writeCache_;
+  std::vector<std::vector<char>>        freePages_;
+  std::vector<char>                     writeBuffer_;
+
+  /// Write queue, zero writeQueueSize_ if not started.  While the I/O thread has queued writes to do, it owns everything above.
+  struct QueuedWrite
+  {
+    uint64_t          logicalOffset;
+    std::vector<char> buffer;
+    size_t            nWrite;
+  };
+  unsigned                       writeQueueSize_; /// most writes queued or in progress at once
+  std::mutex                     queueMutex_;
+  std::condition_variable        queueChanged_; /// signalled when a write is queued or finished, or the I/O thread must stop
+  std::deque<QueuedWrite>        writeQueue_;
+  std::vector<std::vector<char>> freeQueueBuffers_;
+  bool                           stopQueue_;
+  std::exception_ptr             queueError_; /// first failed queued write, later ones are dropped
+  std::thread                    queueThread_;
+
+  void waitForQueuedWrites();
+  void stopWriteQueue();
+  void writeQueueWorker();
+
+  void mapFile();
+  void unmapFile();
+  void readMapped(char* buf, size_t nRead);
+  void verifyMappedPage(uint64_t page);
 
 #ifdef SAFE_MODE
   void     getCurrentPageAndOffset(uint64_t& page, size_t& pageOffset, OffsetMode omode = logical);
+  void     readPages(uint64_t start, char* buf, size_t nRead, std::vector<char>& pageBuffer);
   void     readPhysicalPage(char* page_buffer, uint64_t page);
-  void     writePhysicalPage(char* page_buffer, uint64_t page);
+  size_t   readPhysicalBytes(char* buf, size_t nRead, uint64_t physicalOffset);
+  void     verifyPageChecksum(char* page_buffer, uint64_t page);
+  void     writeCached(const char* buf, uint64_t nWrite);
+  char*    cachedPage(uint64_t page, bool overwriteAll);
+  void     flushWriteCache(bool keepTail);
+  void     writePhysicalBytes(const char* buf, size_t nWrite, uint64_t physicalOffset);
   int      open64(ustring fileName, int flags, int mode);
   uint64_t lseek64(int64_t offset, int whence);
 #else
@@ -407,6 +482,7 @@ protected: //=================
   //??? owned by image file?
   friend class StructureNodeImpl;
   friend class CompressedVectorWriterImpl;
+  friend class CompressedVectorSection;
   friend class Decoder; //???
   friend class Encoder; //???
 
@@ -513,6 +589,8 @@ public:
   SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, double* b, const size_t capacity, bool doConversion = false,
                        bool doScaling = false, size_t stride = sizeof(double));
   SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, std::vector<ustring>* b);
+  SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, char* chars, const size_t charCapacity, uint64_t* offsets,
+                       const size_t capacity);
 
   ustring pathName()
   {
@@ -530,6 +608,14 @@ public:
   {
     return (ustrings_);
   }
+  uint64_t* stringOffsets()
+  {
+    return (stringOffsets_);
+  }
+  size_t charCapacity()
+  {
+    return (charCapacity_);
+  }
   bool doConversion()
   {
     return (doConversion_);
@@ -554,21 +640,68 @@ public:
   {
     nextIndex_ = 0;
   };
+  void truncate(unsigned count) /// drop the records after the first count
+  {
+    nextIndex_ = std::min(nextIndex_, count);
+  };
+
+  /// Point the buffer at other memory of the same representation, keeping everything else a reader or writer checked when it was bound
+  void rebase(MemoryRepresentation memoryRepresentation, char* base, const size_t capacity);
+  void rebase(std::vector<ustring>* b);
+  void rebase(char* chars, const size_t charCapacity, uint64_t* offsets, const size_t capacity);
 
   /// Get/set values:
-  int64_t getNextInt64();
-  int64_t getNextInt64(double scale, double offset);
-  float   getNextFloat();
-  double  getNextDouble();
-  ustring getNextString();
-  void    setNextInt64(int64_t value);
-  void    setNextInt64(int64_t value, double scale, double offset);
-  void    setNextFloat(float value);
-  void    setNextDouble(double value);
-  void    setNextString(const ustring& value);
+  int64_t          getNextInt64();
+  int64_t          getNextInt64(double scale, double offset);
+  float            getNextFloat();
+  double           getNextDouble();
+  ustring          getNextString();
+  std::string_view getNextStringView();
+  void             setNextInt64(int64_t value);
+  void             setNextInt64(int64_t value, double scale, double offset);
+  void             setNextFloat(float value);
+  void             setNextDouble(double value);
+  void             setNextString(const ustring& value);
+
+  /// Store the next string in place: beginNextString() gives room for length chars, which the caller fills before endNextString().
+  /// Strings in a vector reuse the memory the element already has, strings in a char array are packed after the previous one.
+  /// hasRoomForString() is false if the char array is too full for the next string, until the buffer is rewound.
+  bool  hasRoomForString(uint64_t length);
+  char* beginNextString(uint64_t length);
+  void  endNextString();
+
+  /// Bulk stores used by the decoders, one kernel per (source type, memory representation, scaling) selected once by storeIntegersKernel()/storeFloatsKernel().
+  /// Integer kernels store minimum+raw[i], scaled if requested, float kernels store values[i], both with the same conversion rules as setNextInt64()/setNextFloat()/setNextDouble().
+  template <typename RegisterT>
+  using StoreIntegersFunction = void (SourceDestBufferImpl::*)(const RegisterT* raw, size_t count, int64_t minimum, double scale, double offset);
+  template <typename FloatT>
+  using StoreFloatsFunction = void (SourceDestBufferImpl::*)(const FloatT* values, size_t count);
+
+  template <typename RegisterT>
+  StoreIntegersFunction<RegisterT> storeIntegersKernel(bool isScaledInteger);
+  template <typename FloatT>
+  StoreFloatsFunction<FloatT> storeFloatsKernel();
+
+  /// Bulk loads used by the integer encoders, selected once by loadIntegersKernel().  They fetch count values as getNextInt64() would, enforce minimum and maximum,
+  /// and give each value relative to minimum.  Out of bounds values throw E57_ERROR_VALUE_OUT_OF_BOUNDS, with the values before them fetched.
+  template <typename RawT>
+  using LoadIntegersFunction = void (SourceDestBufferImpl::*)(RawT* raw, size_t count, int64_t minimum, int64_t maximum, double scale, double offset);
+
+  template <typename RawT>
+  LoadIntegersFunction<RawT> loadIntegersKernel(bool isScaledInteger);
+
+  /// Bulk loads used by the float encoders, selected once by loadFloatsKernel().  They fetch count values as getNextFloat()/getNextDouble() would.
+  template <typename FloatT>
+  using LoadFloatsFunction = void (SourceDestBufferImpl::*)(FloatT* values, size_t count);
+
+  template <typename FloatT>
+  LoadFloatsFunction<FloatT> loadFloatsKernel();
 
   void checkCompatible(std::shared_ptr<SourceDestBufferImpl> newBuf);
 
+  /// New buffer over elements first .. first+count-1 of this one, except that a ustring buffer stores into strings, which must have count elements.
+  std::shared_ptr<SourceDestBufferImpl> slice(size_t first, size_t count, std::vector<ustring>* strings = nullptr);
+
 #ifdef E57_DEBUG
   void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
@@ -588,6 +721,15 @@ protected:                                      //=================
 
   void checkState_(); /// Common routine to check that constructor arguments were ok, throws if not
 
+  template <typename RegisterT, typename DestT, bool Scaled>
+  void storeIntegers(const RegisterT* raw, size_t count, int64_t minimum, double scale, double offset);
+  template <typename FloatT, typename DestT>
+  void storeFloats(const FloatT* values, size_t count);
+  template <typename SourceT, typename RawT, bool Scaled>
+  void loadIntegers(RawT* raw, size_t count, int64_t minimum, int64_t maximum, double scale, double offset);
+  template <typename SourceT, typename FloatT>
+  void loadFloats(FloatT* values, size_t count);
+
   //??? verify alignment
   std::weak_ptr<ImageFileImpl> destImageFile_;
   ustring                      pathName_;             /// Pathname from CompressedVectorNode to source/dest object, e.g. "Indices/0"
@@ -599,6 +741,8 @@ protected:                                      //=================
   size_t                       stride_;               /// Distance between each element (different than size_ if elements not contiguous)
   unsigned                     nextIndex_;            /// Number of elements that have been set (dest buffer) or read (source buffer) since rewind().
   std::vector<ustring>*        ustrings_;             /// Optional array of ustrings (used if memoryRepresentation_==E57_USTRING) ???ownership
+  uint64_t*                    stringOffsets_;        /// Optional capacity_+1 offsets of strings packed in base_ (used instead of ustrings_)
+  size_t                       charCapacity_;         /// Number of chars at base_, if stringOffsets_ is used
 };
 
 //================================================================
@@ -627,7 +771,10 @@ public:
 
   /// Iterator constructors
   std::shared_ptr<CompressedVectorWriterImpl> writer(std::vector<SourceDestBuffer> sbufs);
-  std::shared_ptr<CompressedVectorReaderImpl> reader(std::vector<SourceDestBuffer> dbufs);
+  std::shared_ptr<CompressedVectorReaderImpl> reader(std::vector<SourceDestBuffer> dbufs, unsigned cachePacketCount = 0);
+
+  /// Read records firstRecord .. firstRecord+recordCount-1 into the start of dbufs, split into rangeCount ranges that are decoded on separate threads
+  void readParallel(std::vector<SourceDestBuffer> dbufs, uint64_t firstRecord, uint64_t recordCount, unsigned rangeCount = 0);
 
   int64_t getRecordCount()
   {
@@ -654,6 +801,9 @@ public:
 #endif
 protected:                                 //=================
   friend class CompressedVectorReaderImpl; //???
+  friend class CompressedVectorWriterImpl;
+
+  std::shared_ptr<CompressedVectorNodeImpl> readableSelf(const std::vector<SourceDestBuffer>& dbufs);
 
   std::shared_ptr<NodeImpl>       prototype_;
   std::shared_ptr<VectorNodeImpl> codecs_;
@@ -661,6 +811,7 @@ protected:                                 //=================
   //???    bool                            writeCompleted_;
   int64_t  recordCount_;
   uint64_t binarySectionLogicalStart_;
+  bool     writerOpen_; /// a CompressedVectorWriter is writing the binary section
 };
 
 class IntegerNodeImpl : public NodeImpl
@@ -895,6 +1046,8 @@ public:
   void        decrWriterCount();
   void        incrReaderCount();
   void        decrReaderCount();
+  void        addReadAheadCache(PacketReadCache* cache);
+  void        removeReadAheadCache(PacketReadCache* cache);
 
   /// Diagnostic functions:
 #ifdef E57_DEBUG
@@ -907,10 +1060,14 @@ public:
 protected: //=================
   friend class E57XmlParser;
   friend class BlobNodeImpl;
+  friend class CompressedVectorNodeImpl;
   friend class CompressedVectorWriterImpl;
+  friend class CompressedVectorSection;
   friend class CompressedVectorReaderImpl; //??? add file() instead of accessing file_, others friends too
 
   void checkImageFileOpen(const char* srcFileName, int srcLineNumber, const char* srcFunctionName);
+  void stopReadAhead();
+  void parseConfiguration(const ustring& configuration);
 
   struct NameSpace
   {
@@ -921,13 +1078,25 @@ protected: //=================
 
   //??? copy, default ctor, assign
 
-  ustring fileName_;
-  bool    isWriter_;
-  int     writerCount_;
-  int     readerCount_;
+  ustring          fileName_;
+  bool             isWriter_;
+  std::atomic<int> writerCount_;
+  std::atomic<int> readerCount_; /// CompressedVectorReaders of a read only file can be opened and closed on several threads at once
+
+  /// Options parsed from the configuration string given to the ImageFile ctor
+  bool     useMemoryMap_;
+  unsigned prefetchPacketCount_; /// data packets each CompressedVectorReader reads ahead, zero for no read-ahead
+  unsigned encoderThreadCount_;  /// threads each CompressedVectorWriter encodes its bytestreams on, including the caller's
+  unsigned decoderThreadCount_;  /// threads each CompressedVectorReader decodes its bytestreams on, including the caller's
+  unsigned writeQueueCount_;     /// data packets queued for the file's I/O thread to write, zero for writing on the caller's thread
 
   std::unique_ptr<CheckedFile> file_;
 
+  /// Packet caches of the open CompressedVectorReaders that read ahead.  Their workers keep reading between read() calls,
+  /// so are stopped before file_ is closed.
+  std::mutex                    readAheadMutex_;
+  std::vector<PacketReadCache*> readAheadCaches_;
+
   /// Read file attributes
   uint64_t xmlLogicalOffset_;
   uint64_t xmlLogicalLength_;
@@ -935,6 +1104,11 @@ protected: //=================
   /// Write file attributes
   uint64_t unusedLogicalStart_;
 
+  /// The binary sections of CompressedVectorWriters open at the same time take turns at the end of the file, see CompressedVectorSection
+  std::mutex                                            tailMutex_;
+  CompressedVectorSection*                              tailSection_;     /// section being appended to the end of the file, nullptr if none
+  std::vector<std::shared_ptr<CompressedVectorSection>> pendingSections_; /// sections of closed writers, waiting for the end of the file
+
   /// Bidirectional map from namespace prefix to uri
   std::vector<NameSpace> nameSpaces_;
 
@@ -947,10 +1121,20 @@ protected: //=================
 class SeekIndex
 {
 public:
-  ///!!! implement seek
+  void     append(uint64_t chunkRecordNumber, uint64_t chunkPhysicalOffset);
+  uint64_t write(std::shared_ptr<ImageFileImpl> imf, uint64_t& indexPacketsCount);
 #ifdef E57_DEBUG
-  void dump(int /*indent*/ = 0, std::ostream& /*os*/ = std::cout) { /*???*/ };
+  void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
+
+protected: //=================
+  struct Entry
+  {
+    uint64_t chunkRecordNumber;
+    uint64_t chunkPhysicalOffset;
+  };
+
+  std::vector<Entry> entries_; /// one per data packet, in file order
 };
 
 //================================================================
@@ -977,7 +1161,14 @@ struct CompressedVectorSectionHeader
 
 //================================================================
 
-#define E57_DATA_PACKET_MAX (64 * 1024) /// maximum size of CompressedVector binary data packet   ??? where put this
+#define E57_DATA_PACKET_MAX (64 * 1024)  /// maximum size of CompressedVector binary data packet   ??? where put this
+#define E57_PACKET_CACHE_MIN 4           /// range of packet cache sizes chosen automatically by CompressedVectorReaderImpl
+#define E57_PACKET_CACHE_MAX 64
+#define E57_WORKER_THREADS_MAX 64        /// most threads a single CompressedVectorWriter or CompressedVectorReader may use
+#define E57_DECODE_WINDOW_PACKETS 8      /// most data packets a CompressedVectorReader with decoder threads hands to its decoders at once
+#define E57_READ_RANGE_MIN_RECORDS 65536 /// fewest records in a range when CompressedVectorNodeImpl::readParallel() chooses the number of ranges
+#define E57_WRITE_QUEUE_MAX 64           /// most data packets queued for writing
+#define E57_SPOOL_MEMORY_MAX (16 * E57_DATA_PACKET_MAX) /// most bytes of data packets a section waiting for the end of the file keeps in memory
 
 struct DataPacketHeader
 {                      ///??? where put this
@@ -1068,18 +1259,26 @@ struct DecodeChannel
 //================================================================
 
 class PacketReadCache;
+class WorkerPool;
 
 class CompressedVectorReaderImpl
 {
 public:
-  CompressedVectorReaderImpl(std::shared_ptr<CompressedVectorNodeImpl> ni, std::vector<SourceDestBuffer>& dbufs);
+  CompressedVectorReaderImpl(std::shared_ptr<CompressedVectorNodeImpl> ni, std::vector<SourceDestBuffer>& dbufs, unsigned cachePacketCount = 0);
   ~CompressedVectorReaderImpl();
   unsigned                                  read();
   unsigned                                  read(std::vector<SourceDestBuffer>& dbufs);
+  std::future<unsigned>                     readAsync(std::vector<SourceDestBuffer>& dbufs);
   void                                      seek(uint64_t recordNumber);
+  void                                      seek(uint64_t recordNumber, const std::vector<uint64_t>& stringByteOffsets);
   bool                                      isOpen();
   std::shared_ptr<CompressedVectorNodeImpl> compressedVectorNode();
   void                                      close();
+  unsigned                                  cachePacketCount();
+  uint64_t                                  cacheHitCount();
+  uint64_t                                  cacheMissCount();
+  std::vector<std::vector<uint64_t>>        findStringRecords(const std::vector<uint64_t>& recordNumbers);
+  void                                      shareSeekIndex(const CompressedVectorReaderImpl& other);
 
 #ifdef E57_DEBUG
   void dump(int indent = 0, std::ostream& os = std::cout);
@@ -1092,9 +1291,20 @@ protected: //=================
   void     checkImageFileOpen(const char* srcFileName, int srcLineNumber, const char* srcFunctionName);
   void     checkReaderOpen(const char* srcFileName, int srcLineNumber, const char* srcFunctionName);
   void     setBuffers(std::vector<SourceDestBuffer>& dbufs); //???needed?
+  unsigned readBlock();
+  void     waitAsync();
+  void     stopAsync();
+  void     asyncWorker();
   uint64_t earliestPacketNeededForInput();
   void     feedPacketToDecoders(uint64_t currentPacketLogicalOffset);
+  void     feedWindowToDecoders(uint64_t firstPacketLogicalOffset, unsigned windowPacketCount);
+  void     feedChannelFromWindow(DecodeChannel* chan, const std::vector<uint64_t>& offsets, const std::vector<DataPacket*>& packets);
   uint64_t findNextDataPacket(uint64_t nextPacketLogicalOffset);
+  void     adaptCache();
+  void     seekIndexInit();
+  void     seekIndexReadTree(uint64_t indexLogicalOffset, unsigned maxLevel);
+  bool     seekIndexExtend();
+  void     seekChannel(DecodeChannel* chan, unsigned channelIndex, uint64_t byteOffset);
 
   //??? no default ctor, copy, assignment?
 
@@ -1104,10 +1314,76 @@ protected: //=================
   std::shared_ptr<NodeImpl>                 proto_;
   std::vector<DecodeChannel>                channels_;
   PacketReadCache*                          cache_;
+  bool                                      cacheAutoSize_; /// grow cache_ to fit the packets the channels have drifted across
+  std::unique_ptr<WorkerPool>               decoderPool_;   /// runs the channel decoders in parallel, null if the ImageFile asked for a single decoder thread
 
   uint64_t recordCount_; /// number of records written so far
   uint64_t maxRecordCount_;
   uint64_t sectionEndLogicalOffset_;
+
+  /// Chunk index used by seek(), built incrementally from the data packet headers on first use.
+  /// Data packets are located using the index packet tree if the section has one, otherwise by scanning the packet headers.
+  bool                               seekIndexReady_;
+  uint64_t                           dataLogicalOffset_;     /// logical offset of first data packet in section
+  uint64_t                           indexLogicalOffset_;    /// logical offset of top index packet, 0 if section has no index
+  std::vector<uint64_t>              seekTreePackets_;       /// data packet logical offsets taken from index packets
+  uint64_t                           seekScanLogicalOffset_; /// next packet to examine when scanning packet headers
+  std::vector<uint64_t>              seekPacketOffsets_;     /// logical offsets of the data packets indexed so far
+  std::vector<std::vector<uint64_t>> seekStreamStarts_;      /// per channel, bytestream offset at start of each indexed data packet
+  std::vector<uint64_t>              seekStreamEnds_;        /// per channel, bytestream offset at end of last indexed data packet
+
+  /// Background read posted by readAsync().  Only one is outstanding at a time, and every other call waits for it to finish first.
+  /// The thread is started by the first readAsync() and stopped by close().
+  std::mutex              asyncMutex_;
+  std::condition_variable asyncChanged_; /// signalled when a read is posted or finishes, or the thread must stop
+  std::promise<unsigned>  asyncResult_;  /// result of the posted read
+  bool                    asyncPending_; /// a read is posted and not finished yet
+  bool                    stopAsync_;
+  std::thread             asyncThread_;
+};
+
+//================================================================
+
+/// The binary section of a CompressedVector being written.
+/// A binary section must be contiguous, so only one section at a time can append its packets to the end of the file: the one that owns the tail.
+/// The sections of other CompressedVectorWriters open at the same time spool their data packets until they get the tail.
+/// Only the last E57_SPOOL_MEMORY_MAX bytes of a spool are kept in memory, the packets before them are moved to a temporary file.
+/// A section that closes while another owns the tail is left in ImageFileImpl::pendingSections_, for the owner to write out when it closes.
+class CompressedVectorSection : public std::enable_shared_from_this<CompressedVectorSection>
+{
+public:
+  CompressedVectorSection(std::shared_ptr<CompressedVectorNodeImpl> cVector);
+  ~CompressedVectorSection();
+
+  bool claimTail();
+  void appendPacket(uint64_t packetLogicalOffset, uint64_t chunkRecordNumber);
+  void spoolPacket(const char* packet, size_t packetLength, uint64_t chunkRecordNumber);
+  void close(uint64_t recordCount);
+
+#ifdef E57_DEBUG
+  void dump(int indent = 0, std::ostream& os = std::cout);
+#endif
+
+protected: //=================
+  void start();
+  void finish();
+  void releaseTail();
+  void spillSpool();
+
+  std::shared_ptr<CompressedVectorNodeImpl>  cVector_;
+  bool                                       ownsTail_;        /// packets go straight to the end of the file
+  std::vector<char>                          spool_;           /// data packets made before the section got the tail, back to back, after those in spoolFile_
+  std::FILE*                                 spoolFile_;       /// temporary file holding the start of the spool once it outgrew memory, nullptr if none
+  uint64_t                                   spoolFileLength_; /// bytes of packets in spoolFile_
+  std::vector<std::pair<uint64_t, uint64_t>> spoolChunks_;     /// chunkRecordNumber and offset in the whole spool of each spooled data packet
+  SeekIndex                                  seekIndex_;
+
+  uint64_t sectionHeaderLogicalStart_; /// start of CompressedVector binary section
+  uint64_t sectionLogicalLength_;      /// total length of CompressedVector binary section
+  uint64_t dataPhysicalOffset_;        /// start of first data packet
+  uint64_t topIndexPhysicalOffset_;    /// top level index packet
+  uint64_t dataPacketsCount_;          /// number of data packets written so far
+  uint64_t indexPacketsCount_;         /// number of index packets written so far
 };
 
 //================================================================
@@ -1136,8 +1412,11 @@ protected: //=================
   void     setBuffers(std::vector<SourceDestBuffer>& sbufs); //???needed?
   size_t   totalOutputAvailable();
   size_t   currentPacketSize();
+  uint64_t packetRecordCount(uint64_t endRecordIndex);
   uint64_t packetWrite();
+  void     processPacketRecords(uint64_t packetRecords, uint64_t endRecordIndex);
   void     flush();
+  void     closeSection();
 
   //??? no default ctor, copy, assignment?
 
@@ -1146,17 +1425,12 @@ protected: //=================
   std::shared_ptr<CompressedVectorNodeImpl> cVector_;
   std::shared_ptr<NodeImpl>                 proto_;
 
-  std::vector<std::shared_ptr<Encoder>> bytestreams_;
-  SeekIndex                             seekIndex_;
-  DataPacket                            dataPacket_;
+  std::vector<std::shared_ptr<Encoder>>    bytestreams_;
+  std::unique_ptr<WorkerPool>              encoderPool_; /// runs the bytestream encoders in parallel, null if the ImageFile asked for a single encoder thread
+  std::shared_ptr<CompressedVectorSection> section_;
+  DataPacket                               dataPacket_;
 
-  uint64_t sectionHeaderLogicalStart_; /// start of CompressedVector binary section
-  uint64_t sectionLogicalLength_;      /// total length of CompressedVector binary section
-  uint64_t dataPhysicalOffset_;        /// start of first data packet
-  uint64_t topIndexPhysicalOffset_;    /// top level index packet
-  uint64_t recordCount_;               /// number of records written so far
-  uint64_t dataPacketsCount_;          /// number of data packets written so far
-  uint64_t indexPacketsCount_;         /// number of index packets written so far
+  uint64_t recordCount_; /// number of records written so far
 };
 
 //================================================================
@@ -1175,10 +1449,18 @@ public:
   virtual float    bitsPerRecord()                    = 0;
   virtual bool     registerFlushToOutput()            = 0;
 
+  /// First record with data in the next byte read by outputRead(), i.e. all data of later records is yet to be read.
+  /// Used for index packets.  E57_UINT64_MAX if the encoder never produces any output.
+  virtual uint64_t outputRecordNumber() = 0;
+
   virtual size_t outputAvailable()                              = 0; /// number of bytes that can be read
   virtual void   outputRead(char* dest, const size_t byteCount) = 0; /// get data from encoder
   virtual void   outputClear()                                  = 0;
 
+  /// Number of bytes outputAvailable() will return after processRecords(recordCount), for encoders whose output size only depends on the record count.
+  /// Returns false if the size can't be known in advance, or if processRecords() would stop short because the records don't fit in the output buffer.
+  virtual bool outputAvailableAfter(size_t recordCount, size_t& byteCount) = 0;
+
   virtual void   sourceBufferSetNew(std::vector<SourceDestBuffer>& sbufs) = 0;
   virtual size_t outputGetMaxSize()                                       = 0;
   virtual void   outputSetMaxSize(unsigned byteCount)                     = 0;
@@ -1222,7 +1504,8 @@ public:
 protected: //================
   BitpackEncoder(unsigned bytestreamNumber, SourceDestBuffer& sbuf, unsigned outputMaxSize, unsigned alignmentSize);
 
-  void outBufferShiftDown();
+  void   outBufferShiftDown();
+  size_t outBufferEndAfterShiftDown(); /// where outBufferShiftDown() will leave outBufferEnd_
 
   std::shared_ptr<SourceDestBufferImpl> sourceBuffer_;
 
@@ -1230,6 +1513,7 @@ protected: //================
   size_t            outBufferFirst_;
   size_t            outBufferEnd_;
   size_t            outBufferAlignmentSize_;
+  uint64_t          outputByteCount_; /// total number of bytes read with outputRead()
 
   uint64_t currentRecordIndex_;
 };
@@ -1244,12 +1528,19 @@ public:
   virtual uint64_t processRecords(size_t recordCount);
   virtual bool     registerFlushToOutput();
   virtual float    bitsPerRecord();
+  virtual uint64_t outputRecordNumber();
+  virtual bool     outputAvailableAfter(size_t recordCount, size_t& byteCount);
+  virtual void     sourceBufferSetNew(std::vector<SourceDestBuffer>& sbufs);
 
 #ifdef E57_DEBUG
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
 protected: //================
-  FloatPrecision precision_;
+  void selectLoadKernel();
+
+  FloatPrecision                                   precision_;
+  SourceDestBufferImpl::LoadFloatsFunction<float>  loadFloats_;  /// Kernel for E57_SINGLE, chosen from sourceBuffer_ representation
+  SourceDestBufferImpl::LoadFloatsFunction<double> loadDoubles_; /// Kernel for E57_DOUBLE, chosen from sourceBuffer_ representation
 };
 
 //================================================================
@@ -1262,16 +1553,20 @@ public:
   virtual uint64_t processRecords(size_t recordCount);
   virtual bool     registerFlushToOutput();
   virtual float    bitsPerRecord();
+  virtual uint64_t outputRecordNumber();
+  virtual bool     outputAvailableAfter(size_t recordCount, size_t& byteCount);
 
 #ifdef E57_DEBUG
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
 protected: //================
-  uint64_t totalBytesProcessed_;
-  bool     isStringActive_;
-  bool     prefixComplete_;
-  ustring  currentString_;
-  size_t   currentCharPosition_;
+  uint64_t             totalBytesProcessed_;
+  bool                 isStringActive_;
+  bool                 prefixComplete_;
+  std::string_view     currentString_; /// Refers to sourceBuffer_ memory, which doesn't change until every record of a write() is encoded
+  size_t               currentCharPosition_;
+  std::deque<uint64_t> recordEnds_;          /// output byte offset at end of each completed string not yet all read with outputRead()
+  uint64_t             recordsBeforeOutput_; /// number of strings whose bytes have all been read with outputRead()
 };
 
 //================================================================
@@ -1286,20 +1581,27 @@ public:
   virtual uint64_t processRecords(size_t recordCount);
   virtual bool     registerFlushToOutput();
   virtual float    bitsPerRecord();
+  virtual uint64_t outputRecordNumber();
+  virtual bool     outputAvailableAfter(size_t recordCount, size_t& byteCount);
+  virtual void     sourceBufferSetNew(std::vector<SourceDestBuffer>& sbufs);
 
 #ifdef E57_DEBUG
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
 protected: //================
-  bool      isScaledInteger_;
-  int64_t   minimum_;
-  int64_t   maximum_;
-  double    scale_;
-  double    offset_;
-  unsigned  bitsPerRecord_;
-  uint64_t  sourceBitMask_;
-  unsigned  registerBitsUsed_;
-  RegisterT register_;
+  /// Records are loaded into 32 bit values (64 bit for wide fields) before being packed, see utils::pack_bits()
+  using UnpackedT = typename std::conditional<sizeof(RegisterT) <= sizeof(uint32_t), uint32_t, uint64_t>::type;
+
+  bool                                                  isScaledInteger_;
+  int64_t                                               minimum_;
+  int64_t                                               maximum_;
+  double                                                scale_;
+  double                                                offset_;
+  unsigned                                              bitsPerRecord_;
+  uint64_t                                              sourceBitMask_;
+  unsigned                                              registerBitsUsed_;
+  RegisterT                                             register_;
+  SourceDestBufferImpl::LoadIntegersFunction<UnpackedT> loadIntegers_; /// Bulk load kernel for the current source buffer
 };
 
 //================================================================
@@ -1307,16 +1609,18 @@ protected: //================
 class ConstantIntegerEncoder : public Encoder
 {
 public:
-  ConstantIntegerEncoder(unsigned bytestreamNumber, SourceDestBuffer& sbuf, int64_t minimum);
+  ConstantIntegerEncoder(bool isScaledInteger, unsigned bytestreamNumber, SourceDestBuffer& sbuf, int64_t minimum, double scale, double offset);
   virtual uint64_t processRecords(size_t recordCount);
   virtual unsigned sourceBufferNextIndex();
   virtual uint64_t currentRecordIndex();
   virtual float    bitsPerRecord();
   virtual bool     registerFlushToOutput();
+  virtual uint64_t outputRecordNumber();
 
   virtual size_t outputAvailable();                              /// number of bytes that can be read
   virtual void   outputRead(char* dest, const size_t byteCount); /// get data from encoder
   virtual void   outputClear();
+  virtual bool   outputAvailableAfter(size_t recordCount, size_t& byteCount);
 
   virtual void   sourceBufferSetNew(std::vector<SourceDestBuffer>& sbufs);
   virtual size_t outputGetMaxSize();
@@ -1326,9 +1630,13 @@ public:
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
 protected: //================
-  std::shared_ptr<SourceDestBufferImpl> sourceBuffer_;
-  uint64_t                              currentRecordIndex_;
-  int64_t                               minimum_;
+  std::shared_ptr<SourceDestBufferImpl>               sourceBuffer_;
+  uint64_t                                            currentRecordIndex_;
+  bool                                                isScaledInteger_;
+  int64_t                                             minimum_;
+  double                                              scale_;
+  double                                              offset_;
+  SourceDestBufferImpl::LoadIntegersFunction<uint8_t> loadIntegers_; /// Kernel chosen from sourceBuffer_ representation, checks values are minimum_
 };
 
 //================================================================
@@ -1344,7 +1652,18 @@ public:
   virtual uint64_t totalRecordsCompleted()                                = 0;
   virtual size_t   inputProcess(const char* source, const size_t count)   = 0;
   virtual void     stateReset()                                           = 0;
-  unsigned         bytestreamNumber()
+
+  /// Restart decoding at recordNumber.  Returns the byte offset in the bytestream from which input must be fed next,
+  /// or E57_UINT64_MAX if the decoder will skip to recordNumber by itself from its current input position.
+  virtual uint64_t seekRecord(uint64_t recordNumber) = 0;
+
+  /// True if the dest buffer can't take the next record although it isn't full, e.g. a char array of strings with too few chars left
+  virtual bool isOutputBlocked()
+  {
+    return (false);
+  };
+
+  unsigned bytestreamNumber()
   {
     return (bytestreamNumber_);
   };
@@ -1376,7 +1695,8 @@ public:
   virtual size_t inputProcess(const char* source, const size_t byteCount);
   virtual size_t inputProcessAligned(const char* inbuf, const size_t firstBit, const size_t endBit) = 0;
 
-  virtual void stateReset();
+  virtual void     stateReset();
+  virtual uint64_t seekRecord(uint64_t recordNumber);
 
 #ifdef E57_DEBUG
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
@@ -1386,6 +1706,9 @@ protected: //================
 
   void inBufferShiftDown();
 
+  /// Number of bits each record takes in the bytestream, used by seekRecord()
+  virtual unsigned bitsPerRecord() = 0;
+
   uint64_t currentRecordIndex_;
   uint64_t maxRecordCount_;
 
@@ -1406,13 +1729,23 @@ class BitpackFloatDecoder : public BitpackDecoder
 public:
   BitpackFloatDecoder(unsigned bytestreamNumber, SourceDestBuffer& dbuf, FloatPrecision precision, uint64_t maxRecordCount);
 
+  virtual void   destBufferSetNew(std::vector<SourceDestBuffer>& dbufs);
   virtual size_t inputProcessAligned(const char* inbuf, const size_t firstBit, const size_t endBit);
 
 #ifdef E57_DEBUG
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
 protected: //================
-  FloatPrecision precision_;
+  virtual unsigned bitsPerRecord()
+  {
+    return (8 * bytesPerWord_);
+  };
+
+  void selectStoreKernel();
+
+  FloatPrecision                                    precision_;
+  SourceDestBufferImpl::StoreFloatsFunction<float>  storeFloats_;  /// Kernel for E57_SINGLE, chosen from destBuffer_ representation
+  SourceDestBufferImpl::StoreFloatsFunction<double> storeDoubles_; /// Kernel for E57_DOUBLE, chosen from destBuffer_ representation
 };
 
 //================================================================
@@ -1422,19 +1755,52 @@ class BitpackStringDecoder : public BitpackDecoder
 public:
   BitpackStringDecoder(unsigned bytestreamNumber, SourceDestBuffer& dbuf, uint64_t maxRecordCount);
 
-  virtual size_t inputProcessAligned(const char* inbuf, const size_t firstBit, const size_t endBit);
+  virtual size_t   inputProcessAligned(const char* inbuf, const size_t firstBit, const size_t endBit);
+  virtual void     stateReset();
+  virtual uint64_t seekRecord(uint64_t recordNumber);
+  virtual bool     isOutputBlocked()
+  {
+    return (waitingForRoom_);
+  };
+
+  /// Restart decoding at recordNumber, which starts at byteOffset in the bytestream.  Returns byteOffset, as seekRecord() would for fixed size records.
+  uint64_t seekRecordAt(uint64_t recordNumber, uint64_t byteOffset);
+
+  /// Lengths read from the bytestream beyond this are corrupt, a string can't be longer than the binary section holding it
+  void setMaxStringLength(uint64_t maxStringLength)
+  {
+    maxStringLength_ = maxStringLength;
+  };
+
+  /// Byte offset in the bytestream of the string stored at destIndex of destBuffer_, for seekRecordAt() back to a record decoded in this read
+  uint64_t storedStringByteOffset(unsigned destIndex)
+  {
+    return (storedByteOffsets_.at(destIndex));
+  };
 
 #ifdef E57_DEBUG
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
 protected: //================
-  bool     readingPrefix_;
-  int      prefixLength_;
-  uint8_t  prefixBytes_[8];
-  int      nBytesPrefixRead_;
-  uint64_t stringLength_;
-  ustring  currentString_;
-  uint64_t nBytesStringRead_;
+  /// Strings have variable length, so can't calculate where a record starts
+  virtual unsigned bitsPerRecord()
+  {
+    return (0);
+  };
+
+  uint64_t              discardCount_; /// number of records to decode and throw away before storing into destBuffer_
+  bool                  readingPrefix_;
+  int                   prefixLength_;
+  uint8_t               prefixBytes_[8];
+  int                   nBytesPrefixRead_;
+  uint64_t              stringLength_;
+  char*                 stringDest_;     /// Where destBuffer_ wants the chars of the current string, nullptr if discarding it
+  bool                  waitingForRoom_; /// prefix of the current string is read, but destBuffer_ has no room for its chars until the next read
+  uint64_t              nBytesStringRead_;
+  uint64_t              maxStringLength_;
+  uint64_t              byteOffset_;        /// offset in the bytestream of the next byte given to inputProcessAligned()
+  uint64_t              recordByteOffset_;  /// offset in the bytestream of the prefix of the current string
+  std::vector<uint64_t> storedByteOffsets_; /// offset in the bytestream of each string in destBuffer_, by index
 };
 
 //================================================================
@@ -1446,19 +1812,29 @@ public:
   BitpackIntegerDecoder(bool isScaledInteger, unsigned bytestreamNumber, SourceDestBuffer& dbuf, int64_t minimum, int64_t maximum, double scale, double offset,
                         uint64_t maxRecordCount);
 
+  virtual void   destBufferSetNew(std::vector<SourceDestBuffer>& dbufs);
   virtual size_t inputProcessAligned(const char* inbuf, const size_t firstBit, const size_t endBit);
 
 #ifdef E57_DEBUG
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
 protected: //================
-  bool      isScaledInteger_;
-  int64_t   minimum_;
-  int64_t   maximum_;
-  double    scale_;
-  double    offset_;
-  unsigned  bitsPerRecord_;
-  RegisterT destBitMask_;
+  virtual unsigned bitsPerRecord()
+  {
+    return (bitsPerRecord_);
+  };
+
+  /// Records are unpacked into 32 bit values (64 bit for wide fields) before being stored, see utils::unpack_bits()
+  using UnpackedT = typename std::conditional<sizeof(RegisterT) <= sizeof(uint32_t), uint32_t, uint64_t>::type;
+
+  bool                                                   isScaledInteger_;
+  int64_t                                                minimum_;
+  int64_t                                                maximum_;
+  double                                                 scale_;
+  double                                                 offset_;
+  unsigned                                               bitsPerRecord_;
+  RegisterT                                              destBitMask_;
+  SourceDestBufferImpl::StoreIntegersFunction<UnpackedT> storeIntegers_; /// Kernel chosen from destBuffer_ representation and scaling
 };
 
 //================================================================
@@ -1473,8 +1849,9 @@ public:
   {
     return (currentRecordIndex_);
   };
-  virtual size_t inputProcess(const char* source, const size_t byteCount);
-  virtual void   stateReset();
+  virtual size_t   inputProcess(const char* source, const size_t byteCount);
+  virtual void     stateReset();
+  virtual uint64_t seekRecord(uint64_t recordNumber);
 #ifdef E57_DEBUG
   virtual void dump(int indent = 0, std::ostream& os = std::cout);
 #endif
@@ -1484,10 +1861,11 @@ protected: //================
 
   std::shared_ptr<SourceDestBufferImpl> destBuffer_;
 
-  bool    isScaledInteger_;
-  int64_t minimum_;
-  double  scale_;
-  double  offset_;
+  bool                                                 isScaledInteger_;
+  int64_t                                              minimum_;
+  double                                               scale_;
+  double                                               offset_;
+  SourceDestBufferImpl::StoreIntegersFunction<uint8_t> storeIntegers_; /// Kernel chosen from destBuffer_ representation
 };
 
 //================================================================
@@ -1516,11 +1894,20 @@ protected: //================
 class PacketReadCache
 {
 public:
-  PacketReadCache(CheckedFile* cFile, unsigned packetCount);
+  PacketReadCache(CheckedFile* cFile, unsigned packetCount, unsigned prefetchCount = 0);
   ~PacketReadCache();
 
   std::unique_ptr<PacketLock> lock(uint64_t packetLogicalOffset, char*& pkt); //??? pkt could be const
   void                        markDiscarable(uint64_t packetLogicalOffset);
+  void                        grow(unsigned packetCount);
+  void                        prefetch(uint64_t leadLogicalOffset, uint64_t keepLogicalOffset, uint64_t endLogicalOffset);
+  void                        stopPrefetch();
+  void                        read(uint64_t logicalOffset, char* buf, size_t nRead); /// uncached read on the thread calling lock(), e.g. of headers
+
+  unsigned packetCount() const { return static_cast<unsigned>(entries_.size()); }
+  unsigned prefetchCount() const { return prefetchCount_; }
+  uint64_t hitCount() const { return hitCount_; }
+  uint64_t missCount() const { return missCount_; }
 
 #ifdef E57_DEBUG
   void dump(int indent = 0, std::ostream& os = std::cout);
@@ -1530,19 +1917,84 @@ protected: //================
   friend class PacketLock;
   void unlock(unsigned cacheIndex);
 
-  void readPacket(unsigned oldestEntry, uint64_t packetLogicalOffset);
+  unsigned victim(uint64_t keepLogicalOffset);
+  void     readPacket(char* buffer, uint64_t packetLogicalOffset, std::vector<char>& pageBuffer);
+  void     readBytes(uint64_t logicalOffset, char* buf, size_t nRead, std::vector<char>& pageBuffer);
+  void     prefetchWorker();
 
   struct CacheEntry
   {
-    uint64_t logicalOffset_;
-    char*    buffer_; //??? could be const?
-    unsigned lastUsed_;
+    uint64_t                      logicalOffset_; /// zero if entry holds no packet
+    char*                         buffer_;        //??? could be const?
+    std::list<unsigned>::iterator lruPosition_;   /// position of this entry in lru_
+    bool                          loading_;       /// packet is being read into buffer_, by the caller of lock() or the prefetch worker
+    unsigned                      lockCount_;     /// number of PacketLocks on buffer_ handed out by lock()
   };
 
-  unsigned                lockCount_;
-  unsigned                useCount_;
-  CheckedFile*            cFile_;
-  std::vector<CacheEntry> entries_;
+  unsigned                               lockCount_;
+  uint64_t                               hitCount_;
+  uint64_t                               missCount_;
+  CheckedFile*                           cFile_;
+  std::vector<CacheEntry>                entries_;
+  std::unordered_map<uint64_t, unsigned> entryIndex_; /// packet logical offset -> index in entries_
+  std::list<unsigned>                    lru_;        /// indexes in entries_, most recently used first
+  std::vector<char>                      pageBuffer_; /// page staging area for reads made by lock()
+
+  /// Read-ahead.  When prefetchCount_ > 0 a worker thread reads packets ahead of the lead channel into the cache.
+  /// Everything above is shared with the worker and guarded by mutex_, except the buffer_ of an entry that is loading_.
+  unsigned                prefetchCount_;
+  std::mutex              mutex_;
+  std::condition_variable entryLoaded_;     /// signalled when an entry stops loading_
+  std::condition_variable prefetchRequest_; /// signalled when a new request is posted, or worker must stop
+  bool                    prefetchPending_;
+  bool                    prefetchStopped_; /// abandon current request
+  bool                    workerBusy_;
+  bool                    stopWorker_;
+  unsigned                loadingCount_;
+  uint64_t                prefetchLead_; /// packet the furthest ahead channel is reading
+  uint64_t                prefetchKeep_; /// packets at or after this offset are still needed, so worker won't evict them
+  uint64_t                prefetchEnd_;  /// end of binary section
+  std::vector<char>       workerPageBuffer_;
+  std::thread             worker_;
+};
+
+//================================================================
+
+/// Fixed set of threads that run batches of independent tasks, such as encoding each bytestream of a packet.
+/// The thread calling run() works on the batch too, so a pool of threadCount threads starts threadCount - 1 workers.
+class WorkerPool
+{
+public:
+  explicit WorkerPool(unsigned threadCount);
+  ~WorkerPool();
+
+  /// Calls task(0) ... task(taskCount - 1) spread over the pool, and returns once all of them are done.
+  /// Tasks are started in index order.  If any throw, the exception of the lowest index is rethrown after the whole batch has finished.
+  void run(size_t taskCount, const std::function<void(size_t)>& task);
+
+  unsigned threadCount() const { return static_cast<unsigned>(workers_.size()) + 1; }
+
+protected: //================
+  void runTasks(std::unique_lock<std::mutex>& guard);
+  void worker();
+  void stopWorkers();
+
+  /// Can't be copied or assigned
+  WorkerPool(const WorkerPool&);
+  WorkerPool& operator=(const WorkerPool&);
+
+  /// Current batch, guarded by mutex_
+  std::mutex                         mutex_;
+  std::condition_variable            batchPosted_; /// signalled when a batch is posted, or workers must stop
+  std::condition_variable            batchDone_;   /// signalled when the last task of the batch finishes
+  const std::function<void(size_t)>* task_;        /// null when no batch is running
+  size_t                             taskCount_;
+  size_t                             nextTask_;    /// lowest index not started yet
+  size_t                             unfinished_;  /// tasks of the batch not finished yet
+  size_t                             errorIndex_;  /// lowest index of a task that threw
+  std::exception_ptr                 error_;
+  bool                               stopWorkers_;
+  std::vector<std::thread>           workers_;
 };
 
 //================================================================
@@ -245,6 +245,17 @@ public:
 
   );
 
+  //! This function returns the size of the block ReadData3DPoints() needs to hold all the points of a Data3D
+  virtual int64_t GetData3DPointsDataSize(int32_t dataIndex //!< data block index given by the NewData3D
+  );                                                        //!< \return Returns the size in bytes, or -1 if dataIndex is out of range
+
+  //! This function reads all the points of a Data3D in a single call
+  virtual bool ReadData3DPoints(int32_t           dataIndex,  //!< data block index given by the NewData3D
+                                Data3DPointsData& pointsData, //!< receives the arrays of point data
+                                void*             block,      //!< memory to lay the arrays out in, or nullptr to allocate it
+                                int64_t           blockSize   //!< size of block in bytes
+  );                                                          //!< \return Return true if successful, false otherwise
+
   //! This function returns the file raw E57Root Structure Node
   virtual StructureNode GetRawE57Root(void); //!< /return Returns the E57Root StructureNode
   //! This function returns the raw Data3D Vector Node
@@ -40,6 +40,7 @@
 #endif
 
 #include <cinttypes>
+#include <future>
 #include <iostream>
 #include <limits> // standard integers definition and numeric limits
 #include <memory>
@@ -335,6 +336,7 @@ public:
   SourceDestBuffer(ImageFile destImageFile, const ustring pathName, double* b, const size_t capacity, bool doConversion = false, bool doScaling = false,
                    size_t stride = sizeof(double));
   SourceDestBuffer(ImageFile destImageFile, const ustring pathName, std::vector<ustring>* b);
+  SourceDestBuffer(ImageFile destImageFile, const ustring pathName, char* chars, const size_t charCapacity, uint64_t* offsets, const size_t capacity);
 
   ustring                   pathName() const;
   enum MemoryRepresentation memoryRepresentation() const;
@@ -343,11 +345,28 @@ public:
   bool                      doScaling() const;
   size_t                    stride() const;
 
+  // Point at other memory between transfers, without binding the buffers to the reader or writer again:
+  void rebase(int8_t* b, const size_t capacity);
+  void rebase(uint8_t* b, const size_t capacity);
+  void rebase(int16_t* b, const size_t capacity);
+  void rebase(uint16_t* b, const size_t capacity);
+  void rebase(int32_t* b, const size_t capacity);
+  void rebase(uint32_t* b, const size_t capacity);
+  void rebase(int64_t* b, const size_t capacity);
+  void rebase(bool* b, const size_t capacity);
+  void rebase(float* b, const size_t capacity);
+  void rebase(double* b, const size_t capacity);
+  void rebase(std::vector<ustring>* b);
+  void rebase(char* chars, const size_t charCapacity, uint64_t* offsets, const size_t capacity);
+
   // Diagnostic functions:
   void dump(int indent = 0, std::ostream& os = std::cout) const;
   void checkInvariant(bool doRecurse = true);
 
-  //! \cond documentNonPublic   The following isn't part of the API, and isn't documented.
+//! \cond documentNonPublic   The following isn't part of the API, and isn't documented.
+#ifdef E57_INTERNAL_IMPLEMENTATION_ENABLE
+  explicit SourceDestBuffer(std::shared_ptr<SourceDestBufferImpl> ni); // internal use only
+#endif
 private:              //=================
   SourceDestBuffer(); // No default constructor is defined for SourceDestBuffer
 
@@ -356,15 +375,47 @@ protected:                                    //=================
   //! \endcond
 };
 
+class SourceDestBufferLayout
+{
+public:
+  explicit SourceDestBufferLayout(size_t structSize);
+
+  void   add(const ustring& pathName, size_t offset, MemoryRepresentation memoryRepresentation, bool doConversion = false, bool doScaling = false);
+  size_t structSize() const;
+  size_t fieldCount() const;
+
+  std::vector<SourceDestBuffer> bind(ImageFile destImageFile, void* structs, const size_t capacity) const;
+  void                          rebase(std::vector<SourceDestBuffer>& buffers, void* structs, const size_t capacity) const;
+
+  //! \cond documentNonPublic   The following isn't part of the API, and isn't documented.
+protected: //=================
+  struct Field
+  {
+    ustring              pathName;
+    size_t               offset;
+    MemoryRepresentation memoryRepresentation;
+    bool                 doConversion;
+    bool                 doScaling;
+  };
+
+  size_t             structSize_;
+  std::vector<Field> fields_;
+  //! \endcond
+};
+
 class CompressedVectorReader
 {
 public:
-  unsigned             read();
-  unsigned             read(std::vector<SourceDestBuffer>& dbufs);
-  void                 seek(int64_t recordNumber); // !!! not implemented yet
-  void                 close();
-  bool                 isOpen();
-  CompressedVectorNode compressedVectorNode() const;
+  unsigned              read();
+  unsigned              read(std::vector<SourceDestBuffer>& dbufs);
+  std::future<unsigned> readAsync(std::vector<SourceDestBuffer>& dbufs);
+  void                  seek(int64_t recordNumber);
+  void                  close();
+  bool                  isOpen();
+  CompressedVectorNode  compressedVectorNode() const;
+  unsigned              cachePacketCount() const;
+  uint64_t              cacheHitCount() const;
+  uint64_t              cacheMissCount() const;
 
   void dump(int indent = 0, std::ostream& os = std::cout) const;
   void checkInvariant(bool doRecurse = true);
@@ -416,7 +467,8 @@ public:
 
   // Iterators
   CompressedVectorWriter writer(std::vector<SourceDestBuffer>& sbufs);
-  CompressedVectorReader reader(const std::vector<SourceDestBuffer>& dbufs);
+  CompressedVectorReader reader(const std::vector<SourceDestBuffer>& dbufs, unsigned cachePacketCount = 0);
+  void                   readParallel(const std::vector<SourceDestBuffer>& dbufs, int64_t firstRecord, int64_t recordCount, unsigned rangeCount = 0);
 
   // Up/Down cast conversion
   operator Node() const;
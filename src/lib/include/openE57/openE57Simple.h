@@ -462,6 +462,65 @@ public:
   int64_t pointsSize; //!< Total size of the compressed vector of PointRecord structures referring to the binary data that actually stores the point data
 };
 
+////////////////////////////////////////////////////////////////////
+//
+//	e57::Data3DPointsData
+//
+
+//! @brief The e57::Data3DPointsData holds every point of a Data3D, with one array per field
+/*! @details Reader::ReadData3DPoints() fills it in a single call. Each array holds pointCount values and starts on an
+e57::Data3DPointsData::alignment byte boundary. The arrays of fields that are not in the prototype of the points are nullptr.
+The arrays live in one block of memory, which is either owned by this object and freed by Reset() and the destructor,
+or supplied by the caller of Reader::ReadData3DPoints().
+*/
+class Data3DPointsData
+{
+public:
+  static constexpr size_t alignment = 64; //!< Byte alignment of every array
+
+  //! @brief This function is the constructor for the Data3DPointsData class
+  Data3DPointsData(void);
+  //! @brief This function is the destructor for the Data3DPointsData class
+  ~Data3DPointsData(void);
+  //! @brief This function frees the block if it is owned, and sets all the arrays to nullptr
+  void Reset(void);
+
+  Data3DPointsData(const Data3DPointsData&)            = delete;
+  Data3DPointsData& operator=(const Data3DPointsData&) = delete;
+
+  int64_t pointCount; //!< Number of values in each array
+
+  double* cartesianX;            //!< The X coordinate (in meters) of the point in Cartesian coordinates
+  double* cartesianY;            //!< The Y coordinate (in meters) of the point in Cartesian coordinates
+  double* cartesianZ;            //!< The Z coordinate (in meters) of the point in Cartesian coordinates
+  int8_t* cartesianInvalidState; //!< Value = 0 if the point is considered valid, 1 otherwise
+
+  double* intensity;          //!< The Point response intensity. Unit is unspecified
+  int8_t* isIntensityInvalid; //!< Value = 0 if the intensity is considered valid, 1 otherwise
+
+  uint16_t* colorRed;       //!< The Red color coefficient. Unit is unspecified
+  uint16_t* colorGreen;     //!< The Green color coefficient. Unit is unspecified
+  uint16_t* colorBlue;      //!< The Blue color coefficient. Unit is unspecified
+  int8_t*   isColorInvalid; //!< Value = 0 if the color is considered valid, 1 otherwise
+
+  double* sphericalRange;        //!< The range (in meters) of points in spherical coordinates
+  double* sphericalAzimuth;      //!< The Azimuth angle (in radians) of point in spherical coordinates
+  double* sphericalElevation;    //!< The Elevation angle (in radians) of point in spherical coordinates
+  int8_t* sphericalInvalidState; //!< Value = 0 if the range is considered valid, 1 otherwise
+
+  int32_t* rowIndex;    //!< The row number of point (zero based)
+  int32_t* columnIndex; //!< The column number of point (zero based)
+  int8_t*  returnIndex; //!< The number of this return (zero based). Only for multi-return sensors.
+  int8_t*  returnCount; //!< The total number of returns for the pulse that this corresponds to. Only for multi-return sensors.
+
+  double* timeStamp;          //!< The time (in seconds) since the start time for the data, which is given by acquisitionStart in the parent Data3D Structure
+  int8_t* isTimeStampInvalid; //!< Value = 0 if the timeStamp is considered valid, 1 otherwise
+
+private:
+  friend class ReaderImpl;
+  void* block_; //!< Block holding the arrays when this object allocated it, nullptr otherwise
+};
+
 ////////////////////////////////////////////////////////////////////
 //
 //	e57::VisualReferenceRepresentation
@@ -759,6 +818,24 @@ public:
 
   ) const; //!< @return Return true if successful, false otherwise
 
+  //! @brief This function returns the size of the block ReadData3DPoints() needs to hold all the points of a Data3D
+  /*! @details The size allows for a block that is not aligned itself.
+   */
+  int64_t GetData3DPointsDataSize(int32_t dataIndex //!< data block index given by the NewData3D
+  ) const;                                          //!< @return Returns the size in bytes, or -1 if dataIndex is out of range
+
+  //! @brief This function reads all the points of a Data3D in a single call
+  /*! @details Arrays are laid out for the standard fields that are in the prototype of the points, and all pointsSize points
+  returned by GetData3DSizes() are read into them at once, decoding with several threads when there are enough points.
+  Without a block, the arrays are allocated by pointsData. A caller supplied block must be at least GetData3DPointsDataSize() bytes,
+  and must outlive the use of the arrays.
+  */
+  bool ReadData3DPoints(int32_t           dataIndex,       //!< data block index given by the NewData3D
+                        Data3DPointsData& pointsData,      //!< receives the arrays of point data
+                        void*             block = nullptr, //!< memory to lay the arrays out in, or nullptr to allocate it
+                        int64_t           blockSize = 0    //!< size of block in bytes
+  ) const;                                                 //!< @return Return true if successful, false otherwise
+
   ////////////////////////////////////////////////////////////////////
   //
   //	Raw File information
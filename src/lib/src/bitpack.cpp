@@ -0,0 +1,673 @@
+/*
+ * bitpack.cpp - Packing and extraction of fixed width integers in E57 bitpacked bytestreams.
+ *
+ * Copyright (c) 2024 openE57 Contributors
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>   // for floor
+#include <cstring> // for memcpy
+
+#include <openE57/impl/bitpack.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define E57_BITPACK_X86 1
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  endif
+#  include <immintrin.h>
+#  if defined(__GNUC__) || defined(__clang__)
+#    define E57_BITPACK_TARGET_SSE41 __attribute__((target("sse4.1")))
+#    define E57_BITPACK_TARGET_AVX2 __attribute__((target("avx2")))
+#  else
+#    define E57_BITPACK_TARGET_SSE41
+#    define E57_BITPACK_TARGET_AVX2
+#  endif
+#elif defined(__aarch64__) && defined(__ARM_NEON) && !defined(__AARCH64EB__)
+#  define E57_BITPACK_NEON 1
+#  include <arm_neon.h>
+#endif
+
+namespace e57
+{
+namespace utils
+{
+  namespace
+  {
+    template <typename OutT>
+    using UnpackFunction   = void (*)(const std::uint8_t* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, OutT* out);
+    using PackFunction     = std::size_t (*)(const std::uint32_t* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits,
+                                         std::uint8_t* out);
+    using QuantizeFunction = bool (*)(const double* values, std::size_t count, double scale, double offset, std::int64_t minimum, std::int64_t maximum,
+                                      std::uint32_t* out);
+
+    inline std::uint64_t valueMask(unsigned bits)
+    {
+      return (bits >= 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+    }
+
+    /// Little endian load
+    inline std::uint64_t load64(const std::uint8_t* p)
+    {
+#ifdef E57_BIGENDIAN
+      std::uint64_t v = 0;
+      for (unsigned i = 0; i < 8; i++)
+        v |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+#else
+      std::uint64_t v;
+      memcpy(&v, p, sizeof(v));
+#endif
+      return v;
+    }
+
+    /// Little endian load of the last n < 8 bytes of the buffer, missing high bytes are zero
+    inline std::uint64_t loadPartial(const std::uint8_t* p, std::size_t n)
+    {
+      std::uint64_t v = 0;
+      for (std::size_t i = 0; i < n; i++)
+        v |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+      return v;
+    }
+
+    template <typename OutT>
+    void unpackScalar(const std::uint8_t* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, OutT* out)
+    {
+      const std::uint64_t mask = valueMask(bits);
+      std::size_t         bit  = firstBit;
+
+      for (std::size_t k = 0; k < count; k++, bit += bits)
+      {
+        const std::size_t q = bit >> 3;
+        const unsigned    s = static_cast<unsigned>(bit & 7);
+
+        std::uint64_t w = (q + 8 <= size) ? load64(buf + q) : loadPartial(buf + q, size - q);
+        w >>= s;
+
+        /// Values wider than 57 bits can spill into a ninth byte
+        if (s + bits > 64)
+          w |= static_cast<std::uint64_t>(buf[q + 8]) << (64 - s);
+        out[k] = static_cast<OutT>(w & mask);
+      }
+    }
+
+    /// Since 8*bits is a whole number of bytes, the byte offsets and bit shifts of values repeat every 8 values.
+    /// For widths up to 25 bits each value fits in 4 bytes, and 4 consecutive values fit in 16 bytes,
+    /// so a run of 8 values is two 16 byte loads (at the byte holding value 0 and at highOffset) and a byte shuffle into 32 bit lanes.
+    struct ShufflePattern
+    {
+      std::uint8_t  shuffle[32]; /// Byte indexes into the 16 byte load of each half, 4 per value
+      std::uint32_t shift[8];    /// Bit offset of each value in its lane
+      std::size_t   highOffset;  /// Byte offset of the load for values 4-7 from the load for values 0-3
+
+      ShufflePattern(std::size_t firstBit, unsigned bits)
+      {
+        const std::size_t s0 = firstBit & 7;
+        highOffset           = (s0 + 4 * bits) >> 3;
+        for (unsigned j = 0; j < 8; j++)
+        {
+          const std::size_t bit   = s0 + j * bits;
+          const std::size_t first = (bit >> 3) - ((j < 4) ? 0 : highOffset);
+          for (unsigned b = 0; b < 4; b++)
+            shuffle[4 * j + b] = static_cast<std::uint8_t>(first + b);
+          shift[j] = static_cast<std::uint32_t>(bit & 7);
+        }
+      }
+    };
+
+    /// Little endian store
+    inline void store64(std::uint8_t* p, std::uint64_t v)
+    {
+#ifdef E57_BIGENDIAN
+      for (unsigned i = 0; i < 8; i++)
+        p[i] = static_cast<std::uint8_t>(v >> (8 * i));
+#else
+      memcpy(p, &v, sizeof(v));
+#endif
+    }
+
+    /// Output side of pack_bits(): the incomplete last word of the stream and where completed words go
+    struct PackState
+    {
+      std::uint64_t acc;   /// Incomplete last word
+      unsigned      used;  /// Bits used in acc, 0 to 63
+      std::uint8_t* out;   /// Destination for completed words
+      std::size_t   words; /// Number of words stored at out
+
+      /// Append the low width bits of chunk, which has no bits set above them (width 1 to 64)
+      inline void append(std::uint64_t chunk, unsigned width)
+      {
+        acc |= chunk << used;
+        used += width;
+        if (used >= 64)
+        {
+          store64(out + 8 * words++, acc);
+          used -= 64;
+          acc = used ? chunk >> (width - used) : 0;
+        }
+      }
+
+      /// Append 8 values of the given width, already merged in pairs (c01 = v0 | v1 << bits, ...).
+      /// Narrow values are merged further so that each append carries as many bits as fit in a word.
+      inline void appendPairs(std::uint64_t c01, std::uint64_t c23, std::uint64_t c45, std::uint64_t c67, unsigned bits)
+      {
+        if (bits <= 8)
+          append(c01 | (c23 << (2 * bits)) | (c45 << (4 * bits)) | (c67 << (6 * bits)), 8 * bits);
+        else if (bits <= 16)
+        {
+          append(c01 | (c23 << (2 * bits)), 4 * bits);
+          append(c45 | (c67 << (2 * bits)), 4 * bits);
+        }
+        else
+        {
+          append(c01, 2 * bits);
+          append(c23, 2 * bits);
+          append(c45, 2 * bits);
+          append(c67, 2 * bits);
+        }
+      }
+    };
+
+    template <typename InT>
+    std::size_t packScalar(const InT* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits, std::uint8_t* out)
+    {
+      PackState state{pending, pendingBits, out, 0};
+
+      for (std::size_t k = 0; k < count; k++)
+        state.append(values[k], bits);
+
+      pending     = state.acc;
+      pendingBits = state.used;
+      return (state.words);
+    }
+
+    bool quantizeScalar(const double* values, std::size_t count, double scale, double offset, std::int64_t minimum, std::int64_t maximum, std::uint32_t* out)
+    {
+      const double low  = static_cast<double>(minimum);
+      const double high = static_cast<double>(maximum);
+      bool         ok   = true;
+
+      for (std::size_t k = 0; k < count; k++)
+      {
+        /// NaN fails both compares
+        const double raw     = floor((values[k] - offset) / scale + 0.5);
+        const bool   inRange = (raw >= low) & (raw <= high);
+        ok &= inRange;
+        out[k] = static_cast<std::uint32_t>(static_cast<std::int64_t>(inRange ? raw : low) - minimum);
+      }
+      return (ok);
+    }
+
+#ifdef E57_BITPACK_X86
+    bool cpuHasSse41()
+    {
+#  if defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 1);
+      return (info[2] & (1 << 19)) != 0;
+#  else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.1");
+#  endif
+    }
+
+    bool cpuHasAvx2()
+    {
+#  if defined(_MSC_VER)
+      /// Needs the OS to save the ymm registers (OSXSAVE and AVX, then XCR0 bits 1 and 2) as well as the AVX2 feature bit
+      int info[4];
+      __cpuid(info, 1);
+      if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+        return false;
+      __cpuidex(info, 7, 0);
+      return (info[1] & (1 << 5)) != 0;
+#  else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#  endif
+    }
+
+    template <typename OutT>
+    E57_BITPACK_TARGET_SSE41 void unpackSse41(const std::uint8_t* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, OutT* out)
+    {
+      std::size_t k = 0;
+
+      /// Shifting right by a different amount per lane needs AVX2, so shift left by 8-s with a multiply instead, then right by 8.
+      /// That keeps the value inside the 32 bit lane for widths up to 24 bits.
+      if (sizeof(OutT) == sizeof(std::uint32_t) && bits <= 24 && count >= 8)
+      {
+        const ShufflePattern pattern(firstBit, bits);
+        const __m128i        shuffleLow  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pattern.shuffle[0]));
+        const __m128i        shuffleHigh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pattern.shuffle[16]));
+        const __m128i        multLow  = _mm_setr_epi32(1 << (8 - pattern.shift[0]), 1 << (8 - pattern.shift[1]), 1 << (8 - pattern.shift[2]), 1 << (8 - pattern.shift[3]));
+        const __m128i        multHigh = _mm_setr_epi32(1 << (8 - pattern.shift[4]), 1 << (8 - pattern.shift[5]), 1 << (8 - pattern.shift[6]), 1 << (8 - pattern.shift[7]));
+        const __m128i        mask     = _mm_set1_epi32(static_cast<int>(valueMask(bits)));
+
+        std::size_t byte = firstBit >> 3;
+        while (k + 8 <= count && byte + pattern.highOffset + 16 <= size)
+        {
+          __m128i low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + byte));
+          __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + byte + pattern.highOffset));
+          low          = _mm_and_si128(_mm_srli_epi32(_mm_mullo_epi32(_mm_shuffle_epi8(low, shuffleLow), multLow), 8), mask);
+          high         = _mm_and_si128(_mm_srli_epi32(_mm_mullo_epi32(_mm_shuffle_epi8(high, shuffleHigh), multHigh), 8), mask);
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), low);
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k + 4), high);
+          byte += bits;
+          k += 8;
+        }
+      }
+
+      unpackScalar(buf, size, firstBit + k * bits, bits, count - k, out + k);
+    }
+
+    /// Extract 4 values at the bit positions in pos, using 64 bit gathers.  Values wider than 56 bits need a second gather for the ninth byte.
+    E57_BITPACK_TARGET_AVX2 inline __m256i avx2Gather4(const std::uint8_t* buf, __m256i pos, __m256i mask, bool spill)
+    {
+      const long long* base  = reinterpret_cast<const long long*>(buf);
+      const __m256i    bytes = _mm256_srli_epi64(pos, 3);
+      const __m256i    shift = _mm256_and_si256(pos, _mm256_set1_epi64x(7));
+
+      __m256i w = _mm256_srlv_epi64(_mm256_i64gather_epi64(base, bytes, 1), shift);
+      if (spill)
+      {
+        /// A shift count of 64 (for byte aligned values) gives zero, so no special case is needed
+        const __m256i high = _mm256_i64gather_epi64(base + 1, bytes, 1);
+        w                  = _mm256_or_si256(w, _mm256_sllv_epi64(high, _mm256_sub_epi64(_mm256_set1_epi64x(64), shift)));
+      }
+      return _mm256_and_si256(w, mask);
+    }
+
+    template <typename OutT>
+    E57_BITPACK_TARGET_AVX2 void unpackAvx2(const std::uint8_t* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, OutT* out)
+    {
+      std::size_t k = 0;
+
+      if (count >= 8 && sizeof(OutT) == sizeof(std::uint32_t) && bits <= 25)
+      {
+        /// Two 16 byte loads into the two 128 bit lanes, an in-lane byte shuffle, and a per lane shift
+        const ShufflePattern pattern(firstBit, bits);
+        const __m256i        shuffle = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern.shuffle));
+        const __m256i        shift   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern.shift));
+        const __m256i        mask    = _mm256_set1_epi32(static_cast<int>(valueMask(bits)));
+
+        std::size_t byte = firstBit >> 3;
+        while (k + 8 <= count && byte + pattern.highOffset + 16 <= size)
+        {
+          __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + byte))),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + byte + pattern.highOffset)), 1);
+          v         = _mm256_and_si256(_mm256_srlv_epi32(_mm256_shuffle_epi8(v, shuffle), shift), mask);
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), v);
+          byte += bits;
+          k += 8;
+        }
+      }
+      else if (count >= 8)
+      {
+        const bool        spill     = bits > 56;
+        const std::size_t loadBytes = spill ? 16 : 8;
+        const __m256i     mask      = _mm256_set1_epi64x(static_cast<long long>(valueMask(bits)));
+        const __m256i     step      = _mm256_set1_epi64x(static_cast<long long>(8 * bits));
+        const long long   b         = static_cast<long long>(bits);
+        __m256i           posLow    = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(firstBit)), _mm256_setr_epi64x(0, b, 2 * b, 3 * b));
+        __m256i           posHigh   = _mm256_add_epi64(posLow, _mm256_set1_epi64x(4 * b));
+
+        /// Stop while the last value of the iteration can still be loaded in full
+        while (k + 8 <= count && ((firstBit + (k + 7) * bits) >> 3) + loadBytes <= size)
+        {
+          const __m256i low  = avx2Gather4(buf, posLow, mask, spill);
+          const __m256i high = avx2Gather4(buf, posHigh, mask, spill);
+          if (sizeof(OutT) == sizeof(std::uint64_t))
+          {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), low);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k + 4), high);
+          }
+          else
+          {
+            /// Keep the low half of each 64 bit lane
+            const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k),
+                                _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(low, pack), _mm256_permutevar8x32_epi32(high, pack), 0x20));
+          }
+          posLow  = _mm256_add_epi64(posLow, step);
+          posHigh = _mm256_add_epi64(posHigh, step);
+          k += 8;
+        }
+      }
+
+      unpackScalar(buf, size, firstBit + k * bits, bits, count - k, out + k);
+    }
+
+    E57_BITPACK_TARGET_SSE41 std::size_t packSse41(const std::uint32_t* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits,
+                                                   std::uint8_t* out)
+    {
+      PackState     state{pending, pendingBits, out, 0};
+      const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(bits));
+      std::size_t   k     = 0;
+
+      /// Widen to 64 bit lanes and merge neighbours: even | odd << bits
+      for (; k + 8 <= count; k += 8)
+      {
+        const __m128i v0    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + k));
+        const __m128i v1    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + k + 4));
+        const __m128i a0    = _mm_cvtepu32_epi64(v0);
+        const __m128i b0    = _mm_cvtepu32_epi64(_mm_srli_si128(v0, 8));
+        const __m128i a1    = _mm_cvtepu32_epi64(v1);
+        const __m128i b1    = _mm_cvtepu32_epi64(_mm_srli_si128(v1, 8));
+        const __m128i pair0 = _mm_or_si128(_mm_unpacklo_epi64(a0, b0), _mm_sll_epi64(_mm_unpackhi_epi64(a0, b0), shift));
+        const __m128i pair1 = _mm_or_si128(_mm_unpacklo_epi64(a1, b1), _mm_sll_epi64(_mm_unpackhi_epi64(a1, b1), shift));
+        state.appendPairs(static_cast<std::uint64_t>(_mm_cvtsi128_si64(pair0)), static_cast<std::uint64_t>(_mm_extract_epi64(pair0, 1)),
+                          static_cast<std::uint64_t>(_mm_cvtsi128_si64(pair1)), static_cast<std::uint64_t>(_mm_extract_epi64(pair1, 1)), bits);
+      }
+
+      pending     = state.acc;
+      pendingBits = state.used;
+      return (state.words + packScalar(values + k, count - k, bits, pending, pendingBits, out + 8 * state.words));
+    }
+
+    E57_BITPACK_TARGET_AVX2 std::size_t packAvx2(const std::uint32_t* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits,
+                                                 std::uint8_t* out)
+    {
+      PackState     state{pending, pendingBits, out, 0};
+      const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(bits));
+      std::size_t   k     = 0;
+
+      for (; k + 8 <= count; k += 8)
+      {
+        const __m256i v    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + k));
+        const __m256i low  = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v));
+        const __m256i high = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1));
+
+        /// The in-lane unpacks give the pairs in the order c01, c45, c23, c67
+        const __m256i pairs = _mm256_or_si256(_mm256_unpacklo_epi64(low, high), _mm256_sll_epi64(_mm256_unpackhi_epi64(low, high), shift));
+        alignas(32) std::uint64_t chunks[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(chunks), pairs);
+        state.appendPairs(chunks[0], chunks[2], chunks[1], chunks[3], bits);
+      }
+
+      pending     = state.acc;
+      pendingBits = state.used;
+      return (state.words + packScalar(values + k, count - k, bits, pending, pendingBits, out + 8 * state.words));
+    }
+
+    /// Compute the raw values in double precision as the scalar version does, then convert the offset from minimum, which fits in 32 bits once the range
+    /// check passed, by biasing it into the signed 32 bit range.  Out of range values give garbage, but then the result is false anyway.
+    E57_BITPACK_TARGET_SSE41 bool quantizeSse41(const double* values, std::size_t count, double scale, double offset, std::int64_t minimum, std::int64_t maximum,
+                                                std::uint32_t* out)
+    {
+      const __m128d vScale  = _mm_set1_pd(scale);
+      const __m128d vOffset = _mm_set1_pd(offset);
+      const __m128d half    = _mm_set1_pd(0.5);
+      const __m128d low     = _mm_set1_pd(static_cast<double>(minimum));
+      const __m128d high    = _mm_set1_pd(static_cast<double>(maximum));
+      const __m128d bias    = _mm_set1_pd(2147483648.0);
+      const __m128i unbias  = _mm_set1_epi32(static_cast<int>(0x80000000u));
+      __m128d       ok      = _mm_castsi128_pd(_mm_set1_epi32(-1));
+      std::size_t   k       = 0;
+
+      for (; k + 2 <= count; k += 2)
+      {
+        const __m128d raw = _mm_floor_pd(_mm_add_pd(_mm_div_pd(_mm_sub_pd(_mm_loadu_pd(values + k), vOffset), vScale), half));
+        ok                = _mm_and_pd(ok, _mm_and_pd(_mm_cmpge_pd(raw, low), _mm_cmple_pd(raw, high)));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + k), _mm_xor_si128(_mm_cvttpd_epi32(_mm_sub_pd(_mm_sub_pd(raw, low), bias)), unbias));
+      }
+
+      const bool tailOk = quantizeScalar(values + k, count - k, scale, offset, minimum, maximum, out + k);
+      return (_mm_movemask_pd(ok) == 0x3 && tailOk);
+    }
+
+    E57_BITPACK_TARGET_AVX2 bool quantizeAvx2(const double* values, std::size_t count, double scale, double offset, std::int64_t minimum, std::int64_t maximum,
+                                              std::uint32_t* out)
+    {
+      const __m256d vScale  = _mm256_set1_pd(scale);
+      const __m256d vOffset = _mm256_set1_pd(offset);
+      const __m256d half    = _mm256_set1_pd(0.5);
+      const __m256d low     = _mm256_set1_pd(static_cast<double>(minimum));
+      const __m256d high    = _mm256_set1_pd(static_cast<double>(maximum));
+      const __m256d bias    = _mm256_set1_pd(2147483648.0);
+      const __m128i unbias  = _mm_set1_epi32(static_cast<int>(0x80000000u));
+      __m256d       ok      = _mm256_castsi256_pd(_mm256_set1_epi32(-1));
+      std::size_t   k       = 0;
+
+      for (; k + 4 <= count; k += 4)
+      {
+        const __m256d raw = _mm256_floor_pd(_mm256_add_pd(_mm256_div_pd(_mm256_sub_pd(_mm256_loadu_pd(values + k), vOffset), vScale), half));
+        ok = _mm256_and_pd(ok, _mm256_and_pd(_mm256_cmp_pd(raw, low, _CMP_GE_OQ), _mm256_cmp_pd(raw, high, _CMP_LE_OQ)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_xor_si128(_mm256_cvttpd_epi32(_mm256_sub_pd(_mm256_sub_pd(raw, low), bias)), unbias));
+      }
+
+      const bool tailOk = quantizeScalar(values + k, count - k, scale, offset, minimum, maximum, out + k);
+      return (_mm256_movemask_pd(ok) == 0xF && tailOk);
+    }
+#endif // E57_BITPACK_X86
+
+#ifdef E57_BITPACK_NEON
+    template <typename OutT>
+    void unpackNeon(const std::uint8_t* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, OutT* out)
+    {
+      std::size_t k = 0;
+
+      if (sizeof(OutT) == sizeof(std::uint32_t) && bits <= 25 && count >= 8)
+      {
+        /// Table lookup gathers the bytes of each value into its lane, a negative shift count shifts right
+        const ShufflePattern pattern(firstBit, bits);
+        const uint8x16_t     tableLow  = vld1q_u8(&pattern.shuffle[0]);
+        const uint8x16_t     tableHigh = vld1q_u8(&pattern.shuffle[16]);
+        const int32x4_t      shiftLow  = vnegq_s32(vreinterpretq_s32_u32(vld1q_u32(&pattern.shift[0])));
+        const int32x4_t      shiftHigh = vnegq_s32(vreinterpretq_s32_u32(vld1q_u32(&pattern.shift[4])));
+        const uint32x4_t     mask      = vdupq_n_u32(static_cast<std::uint32_t>(valueMask(bits)));
+
+        std::size_t byte = firstBit >> 3;
+        while (k + 8 <= count && byte + pattern.highOffset + 16 <= size)
+        {
+          const uint8x16_t low  = vqtbl1q_u8(vld1q_u8(buf + byte), tableLow);
+          const uint8x16_t high = vqtbl1q_u8(vld1q_u8(buf + byte + pattern.highOffset), tableHigh);
+          vst1q_u32(reinterpret_cast<std::uint32_t*>(out + k), vandq_u32(vshlq_u32(vreinterpretq_u32_u8(low), shiftLow), mask));
+          vst1q_u32(reinterpret_cast<std::uint32_t*>(out + k + 4), vandq_u32(vshlq_u32(vreinterpretq_u32_u8(high), shiftHigh), mask));
+          byte += bits;
+          k += 8;
+        }
+      }
+
+      unpackScalar(buf, size, firstBit + k * bits, bits, count - k, out + k);
+    }
+
+    std::size_t packNeon(const std::uint32_t* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits, std::uint8_t* out)
+    {
+      PackState       state{pending, pendingBits, out, 0};
+      const int64x2_t shift = vdupq_n_s64(static_cast<std::int64_t>(bits));
+      std::size_t     k     = 0;
+
+      for (; k + 8 <= count; k += 8)
+      {
+        /// De-interleaving load: val[0] holds the even values, val[1] the odd ones
+        const uint32x4x2_t v    = vld2q_u32(values + k);
+        const uint64x2_t   low  = vorrq_u64(vmovl_u32(vget_low_u32(v.val[0])), vshlq_u64(vmovl_u32(vget_low_u32(v.val[1])), shift));
+        const uint64x2_t   high = vorrq_u64(vmovl_u32(vget_high_u32(v.val[0])), vshlq_u64(vmovl_u32(vget_high_u32(v.val[1])), shift));
+        state.appendPairs(vgetq_lane_u64(low, 0), vgetq_lane_u64(low, 1), vgetq_lane_u64(high, 0), vgetq_lane_u64(high, 1), bits);
+      }
+
+      pending     = state.acc;
+      pendingBits = state.used;
+      return (state.words + packScalar(values + k, count - k, bits, pending, pendingBits, out + 8 * state.words));
+    }
+#endif // E57_BITPACK_NEON
+
+    template <typename OutT>
+    UnpackFunction<OutT> unpackFunction(BitpackEngine engine)
+    {
+      switch (engine)
+      {
+#ifdef E57_BITPACK_X86
+      case BitpackEngine::Sse41:
+        return unpackSse41<OutT>;
+      case BitpackEngine::Avx2:
+        return unpackAvx2<OutT>;
+#endif
+#ifdef E57_BITPACK_NEON
+      case BitpackEngine::Neon:
+        return unpackNeon<OutT>;
+#endif
+      default:
+        return unpackScalar<OutT>;
+      }
+    }
+
+    PackFunction packFunction(BitpackEngine engine)
+    {
+      switch (engine)
+      {
+#ifdef E57_BITPACK_X86
+      case BitpackEngine::Sse41:
+        return packSse41;
+      case BitpackEngine::Avx2:
+        return packAvx2;
+#endif
+#ifdef E57_BITPACK_NEON
+      case BitpackEngine::Neon:
+        return packNeon;
+#endif
+      default:
+        return packScalar<std::uint32_t>;
+      }
+    }
+
+    QuantizeFunction quantizeFunction(BitpackEngine engine)
+    {
+      switch (engine)
+      {
+#ifdef E57_BITPACK_X86
+      case BitpackEngine::Sse41:
+        return quantizeSse41;
+      case BitpackEngine::Avx2:
+        return quantizeAvx2;
+#endif
+      default:
+        return quantizeScalar;
+      }
+    }
+
+    BitpackEngine bitpackBestEngine()
+    {
+#ifdef E57_BITPACK_X86
+      if (cpuHasAvx2())
+        return BitpackEngine::Avx2;
+      if (cpuHasSse41())
+        return BitpackEngine::Sse41;
+#endif
+#ifdef E57_BITPACK_NEON
+      return BitpackEngine::Neon;
+#else
+      return BitpackEngine::Scalar;
+#endif
+    }
+  } // namespace
+
+  bool bitpack_engine_supported(BitpackEngine engine) noexcept
+  {
+    switch (engine)
+    {
+    case BitpackEngine::Scalar:
+      return true;
+#ifdef E57_BITPACK_X86
+    case BitpackEngine::Sse41:
+      return cpuHasSse41();
+    case BitpackEngine::Avx2:
+      return cpuHasAvx2();
+#endif
+#ifdef E57_BITPACK_NEON
+    case BitpackEngine::Neon:
+      /// NEON is mandatory on 64 bit ARM
+      return true;
+#endif
+    default:
+      return false;
+    }
+  }
+
+  BitpackEngine bitpack_engine() noexcept
+  {
+    static const BitpackEngine engine = bitpackBestEngine();
+    return engine;
+  }
+
+  void unpack_bits(const void* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, std::uint32_t* out) noexcept
+  {
+    /// Pick implementation once, on first use
+    static const UnpackFunction<std::uint32_t> function = unpackFunction<std::uint32_t>(bitpack_engine());
+    function(static_cast<const std::uint8_t*>(buf), size, firstBit, bits, count, out);
+  }
+
+  void unpack_bits(const void* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, std::uint64_t* out) noexcept
+  {
+    static const UnpackFunction<std::uint64_t> function = unpackFunction<std::uint64_t>(bitpack_engine());
+    function(static_cast<const std::uint8_t*>(buf), size, firstBit, bits, count, out);
+  }
+
+  void unpack_bits(const void* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, std::uint32_t* out, BitpackEngine engine) noexcept
+  {
+    if (!bitpack_engine_supported(engine))
+      engine = BitpackEngine::Scalar;
+    unpackFunction<std::uint32_t>(engine)(static_cast<const std::uint8_t*>(buf), size, firstBit, bits, count, out);
+  }
+
+  void unpack_bits(const void* buf, std::size_t size, std::size_t firstBit, unsigned bits, std::size_t count, std::uint64_t* out, BitpackEngine engine) noexcept
+  {
+    if (!bitpack_engine_supported(engine))
+      engine = BitpackEngine::Scalar;
+    unpackFunction<std::uint64_t>(engine)(static_cast<const std::uint8_t*>(buf), size, firstBit, bits, count, out);
+  }
+
+  std::size_t pack_bits(const std::uint32_t* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits, void* out) noexcept
+  {
+    static const PackFunction function = packFunction(bitpack_engine());
+    return (function(values, count, bits, pending, pendingBits, static_cast<std::uint8_t*>(out)));
+  }
+
+  std::size_t pack_bits(const std::uint64_t* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits, void* out) noexcept
+  {
+    return (packScalar(values, count, bits, pending, pendingBits, static_cast<std::uint8_t*>(out)));
+  }
+
+  std::size_t pack_bits(const std::uint32_t* values, std::size_t count, unsigned bits, std::uint64_t& pending, unsigned& pendingBits, void* out,
+                        BitpackEngine engine) noexcept
+  {
+    if (!bitpack_engine_supported(engine))
+      engine = BitpackEngine::Scalar;
+    return (packFunction(engine)(values, count, bits, pending, pendingBits, static_cast<std::uint8_t*>(out)));
+  }
+
+  bool quantize(const double* values, std::size_t count, double scale, double offset, std::int64_t minimum, std::int64_t maximum, std::uint32_t* out) noexcept
+  {
+    static const QuantizeFunction function = quantizeFunction(bitpack_engine());
+    return (function(values, count, scale, offset, minimum, maximum, out));
+  }
+
+  bool quantize(const double* values, std::size_t count, double scale, double offset, std::int64_t minimum, std::int64_t maximum, std::uint32_t* out,
+                BitpackEngine engine) noexcept
+  {
+    if (!bitpack_engine_supported(engine))
+      engine = BitpackEngine::Scalar;
+    return (quantizeFunction(engine)(values, count, scale, offset, minimum, maximum, out));
+  }
+} // namespace utils
+} // namespace e57
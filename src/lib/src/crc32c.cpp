@@ -0,0 +1,327 @@
+/*
+ * crc32c.cpp - CRC32C (Castagnoli) checksums used for E57 page checksums.
+ *
+ * Copyright (c) 2024 openE57 Contributors
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring> // for memcpy
+
+#include <openE57/impl/crc.h>
+#include <openE57/impl/crc32c.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define E57_CRC32C_X86 1
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#  endif
+#  include <nmmintrin.h> // SSE4.2 crc32
+#  include <wmmintrin.h> // PCLMULQDQ
+#  if defined(__GNUC__) || defined(__clang__)
+#    define E57_CRC32C_TARGET_SSE42 __attribute__((target("sse4.2")))
+#    define E57_CRC32C_TARGET_CLMUL __attribute__((target("sse4.2,pclmul")))
+#  else
+#    define E57_CRC32C_TARGET_SSE42
+#    define E57_CRC32C_TARGET_CLMUL
+#  endif
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__)) && (defined(__linux__) || defined(__APPLE__))
+#  define E57_CRC32C_ARM 1
+#  if defined(__linux__)
+#    include <sys/auxv.h>
+#    ifndef HWCAP_CRC32
+#      define HWCAP_CRC32 (1 << 7)
+#    endif
+#  endif
+#  if defined(__clang__)
+#    define E57_CRC32C_TARGET_ARM __attribute__((target("crc")))
+#    define E57_CRC32C_ARM_U8(crc, v) __builtin_arm_crc32cb(crc, v)
+#    define E57_CRC32C_ARM_U64(crc, v) __builtin_arm_crc32cd(crc, v)
+#  else
+#    define E57_CRC32C_TARGET_ARM __attribute__((target("+crc")))
+#    define E57_CRC32C_ARM_U8(crc, v) __builtin_aarch64_crc32cb(crc, v)
+#    define E57_CRC32C_ARM_U64(crc, v) __builtin_aarch64_crc32cx(crc, v)
+#  endif
+#endif
+
+namespace e57
+{
+namespace utils
+{
+  namespace
+  {
+    using Crc32cFunction = std::uint32_t (*)(const void* buf, std::size_t size);
+
+    const auto CRC32C_LOOKUP_TABLE = CRC::CRC_32_C().MakeTable();
+
+    std::uint32_t crc32cTable(const void* buf, std::size_t size)
+    {
+      return CRC::Calculate(buf, size, CRC32C_LOOKUP_TABLE);
+    }
+
+    inline std::uint64_t load64(const std::uint8_t* p)
+    {
+      std::uint64_t v;
+      memcpy(&v, p, sizeof(v));
+      return v;
+    }
+
+#ifdef E57_CRC32C_X86
+    bool cpuHasSse42()
+    {
+#  if defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 1);
+      return (info[2] & (1 << 20)) != 0;
+#  else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.2");
+#  endif
+    }
+
+    bool cpuHasClmul()
+    {
+#  if defined(_MSC_VER)
+      int info[4];
+      __cpuid(info, 1);
+      return (info[2] & (1 << 1)) != 0;
+#  else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("pclmul");
+#  endif
+    }
+
+    /// Update raw (not inverted) crc with bytes, one 64 bit word at a time
+    E57_CRC32C_TARGET_SSE42 std::uint32_t crc32cSse42Update(std::uint32_t crc, const std::uint8_t* p, std::size_t size)
+    {
+      while (size > 0 && (reinterpret_cast<std::uintptr_t>(p) & 7) != 0)
+      {
+        crc = _mm_crc32_u8(crc, *p++);
+        size--;
+      }
+
+      std::uint64_t crc64 = crc;
+      while (size >= 8)
+      {
+        crc64 = _mm_crc32_u64(crc64, load64(p));
+        p += 8;
+        size -= 8;
+      }
+      crc = static_cast<std::uint32_t>(crc64);
+
+      while (size-- > 0)
+        crc = _mm_crc32_u8(crc, *p++);
+      return crc;
+    }
+
+    std::uint32_t crc32cSse42(const void* buf, std::size_t size)
+    {
+      return ~crc32cSse42Update(0xFFFFFFFF, static_cast<const std::uint8_t*>(buf), size);
+    }
+
+    /// The crc32 instruction has a latency of 3 cycles but a throughput of 1 per cycle, so runs of 3*blockLength bytes are
+    /// processed as three independent streams.  The partial crcs are then combined by multiplying the first two by x^(8*2*blockLength)
+    /// and x^(8*blockLength) modulo the polynomial, which is done with one carry-less multiply and one crc32 each.
+    /// A page checksum (1020 bytes) is one short block of 3*336 bytes plus a 12 byte tail.
+    const std::size_t CRC32C_LONG_BLOCK  = 4096;
+    const std::size_t CRC32C_SHORT_BLOCK = 336;
+
+    /// Calc x^n mod P, bit reflected (bit 31 is the coefficient of x^0)
+    std::uint32_t crc32cXPowMod(std::uint64_t n)
+    {
+      std::uint32_t r = 0x80000000;
+      while (n-- > 0)
+        r = (r >> 1) ^ ((r & 1) ? 0x82F63B78 : 0);
+      return r;
+    }
+
+    /// A reflected carry-less product of a and k is a*k*x, and crc32 of a 64 bit word w multiplies it by x^32.
+    /// So to multiply a crc by x^(8*byteCount), use k = x^(8*byteCount - 33).
+    struct Crc32cShiftConstants
+    {
+      std::uint64_t long1;
+      std::uint64_t long2;
+      std::uint64_t short1;
+      std::uint64_t short2;
+
+      Crc32cShiftConstants()
+      : long1(crc32cXPowMod(8 * CRC32C_LONG_BLOCK - 33)), long2(crc32cXPowMod(8 * 2 * CRC32C_LONG_BLOCK - 33)),
+        short1(crc32cXPowMod(8 * CRC32C_SHORT_BLOCK - 33)), short2(crc32cXPowMod(8 * 2 * CRC32C_SHORT_BLOCK - 33))
+      {
+      }
+    };
+
+    const Crc32cShiftConstants& crc32cShiftConstants()
+    {
+      static const Crc32cShiftConstants constants;
+      return constants;
+    }
+
+    E57_CRC32C_TARGET_CLMUL std::uint32_t crc32cShift(std::uint64_t crc, std::uint64_t k)
+    {
+      __m128i product = _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<long long>(crc)), _mm_cvtsi64_si128(static_cast<long long>(k)), 0x00);
+      return static_cast<std::uint32_t>(_mm_crc32_u64(0, static_cast<std::uint64_t>(_mm_cvtsi128_si64(product))));
+    }
+
+    E57_CRC32C_TARGET_CLMUL std::uint32_t crc32cThreeWay(std::uint32_t crc, const std::uint8_t*& p, std::size_t& size, std::size_t blockLength,
+                                                         std::uint64_t k1, std::uint64_t k2)
+    {
+      while (size >= 3 * blockLength)
+      {
+        std::uint64_t      crc0 = crc;
+        std::uint64_t      crc1 = 0;
+        std::uint64_t      crc2 = 0;
+        const std::uint8_t* end = p + blockLength;
+        for (; p < end; p += 8)
+        {
+          crc0 = _mm_crc32_u64(crc0, load64(p));
+          crc1 = _mm_crc32_u64(crc1, load64(p + blockLength));
+          crc2 = _mm_crc32_u64(crc2, load64(p + 2 * blockLength));
+        }
+        crc = crc32cShift(crc0, k2) ^ crc32cShift(crc1, k1) ^ static_cast<std::uint32_t>(crc2);
+        p += 2 * blockLength;
+        size -= 3 * blockLength;
+      }
+      return crc;
+    }
+
+    std::uint32_t crc32cSse42Clmul(const void* buf, std::size_t size)
+    {
+      const Crc32cShiftConstants& k   = crc32cShiftConstants();
+      const std::uint8_t*         p   = static_cast<const std::uint8_t*>(buf);
+      std::uint32_t               crc = 0xFFFFFFFF;
+
+      crc = crc32cThreeWay(crc, p, size, CRC32C_LONG_BLOCK, k.long1, k.long2);
+      crc = crc32cThreeWay(crc, p, size, CRC32C_SHORT_BLOCK, k.short1, k.short2);
+      return ~crc32cSse42Update(crc, p, size);
+    }
+#endif // E57_CRC32C_X86
+
+#ifdef E57_CRC32C_ARM
+    bool cpuHasArmCrc()
+    {
+#  if defined(__APPLE__)
+      /// All 64 bit Apple cores implement the CRC32 extension
+      return true;
+#  else
+      return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#  endif
+    }
+
+    E57_CRC32C_TARGET_ARM std::uint32_t crc32cArmv8(const void* buf, std::size_t size)
+    {
+      const std::uint8_t* p   = static_cast<const std::uint8_t*>(buf);
+      std::uint32_t       crc = 0xFFFFFFFF;
+
+      while (size > 0 && (reinterpret_cast<std::uintptr_t>(p) & 7) != 0)
+      {
+        crc = E57_CRC32C_ARM_U8(crc, *p++);
+        size--;
+      }
+      while (size >= 8)
+      {
+        crc = E57_CRC32C_ARM_U64(crc, load64(p));
+        p += 8;
+        size -= 8;
+      }
+      while (size-- > 0)
+        crc = E57_CRC32C_ARM_U8(crc, *p++);
+      return ~crc;
+    }
+#endif // E57_CRC32C_ARM
+
+    Crc32cFunction crc32cFunction(Crc32cEngine engine)
+    {
+      switch (engine)
+      {
+#ifdef E57_CRC32C_X86
+      case Crc32cEngine::Sse42:
+        return crc32cSse42;
+      case Crc32cEngine::Sse42Clmul:
+        return crc32cSse42Clmul;
+#endif
+#ifdef E57_CRC32C_ARM
+      case Crc32cEngine::Armv8:
+        return crc32cArmv8;
+#endif
+      default:
+        return crc32cTable;
+      }
+    }
+
+    Crc32cEngine crc32cBestEngine()
+    {
+#ifdef E57_CRC32C_X86
+      if (cpuHasSse42())
+        return cpuHasClmul() ? Crc32cEngine::Sse42Clmul : Crc32cEngine::Sse42;
+#endif
+#ifdef E57_CRC32C_ARM
+      if (cpuHasArmCrc())
+        return Crc32cEngine::Armv8;
+#endif
+      return Crc32cEngine::Table;
+    }
+  } // namespace
+
+  bool crc32c_engine_supported(Crc32cEngine engine) noexcept
+  {
+    switch (engine)
+    {
+    case Crc32cEngine::Table:
+      return true;
+#ifdef E57_CRC32C_X86
+    case Crc32cEngine::Sse42:
+      return cpuHasSse42();
+    case Crc32cEngine::Sse42Clmul:
+      return cpuHasSse42() && cpuHasClmul();
+#endif
+#ifdef E57_CRC32C_ARM
+    case Crc32cEngine::Armv8:
+      return cpuHasArmCrc();
+#endif
+    default:
+      return false;
+    }
+  }
+
+  Crc32cEngine crc32c_engine() noexcept
+  {
+    static const Crc32cEngine engine = crc32cBestEngine();
+    return engine;
+  }
+
+  std::uint32_t crc32c(const void* buf, std::size_t size) noexcept
+  {
+    /// Pick implementation once, on first use
+    static const Crc32cFunction function = crc32cFunction(crc32c_engine());
+    return function(buf, size);
+  }
+
+  std::uint32_t crc32c(const void* buf, std::size_t size, Crc32cEngine engine) noexcept
+  {
+    if (!crc32c_engine_supported(engine))
+      engine = Crc32cEngine::Table;
+    return crc32cFunction(engine)(buf, size);
+  }
+} // namespace utils
+} // namespace e57
@@ -2573,6 +2573,45 @@ compatible with string SourceDestBuffers.
   SourceDestBuffer::SourceDestBuffer(ImageFile destImageFile, const ustring pathName, std::vector<ustring>* b)
 : impl_(new SourceDestBufferImpl(destImageFile.impl(), pathName, b)){CHECK_THIS_INVARIANCE()}
 
+  /*================*/
+  /*!
+@brief   Designate a char array to transfer strings to/from a CompressedVector as a block, without allocating memory for each string.
+@param   [in] destImageFile The ImageFile where the new node will eventually be stored.
+@param   [in] pathName      The pathname of the field in CompressedVectorNode that will transfer data to/from.
+@param   [in] chars         The caller created array of chars holding the strings, one after another.
+@param   [in] charCapacity  The number of chars in @a chars.
+@param   [in] offsets       The caller created array of @a capacity + 1 offsets into @a chars.
+@param   [in] capacity      The number of strings that can be transferred.
+@details
+This overloaded form of the SourceDestBuffer constructor declares a caller owned char array to be the source/destination of a transfer of StringNode values
+stored in a CompressedVectorNode. String i is the chars from @a chars[@a offsets[i]] up to, but not including, @a chars[@a offsets[i+1]]. The strings are not
+null terminated.
+
+In a write, the strings are encoded straight from @a chars, so @a offsets can describe them in any order, as long as each lies inside the array.
+In a read, the strings are packed one after another from @a chars[0], and @a offsets[0] .. @a offsets[n] are set for the n records read.
+Neither copies the strings through std::string, so string fields transfer with no heap allocation for each record.
+If the next string read doesn't fit in the chars left, the read stops short before it, returning the records read so far, and the next read starts with it.
+Only a string longer than @a charCapacity chars makes the read throw ::E57_ERROR_BAD_BUFFER, which a read after rebasing to a larger array recovers from.
+
+The @a capacity must match capacity of all other SourceDestBuffers that will participate in a transfer with a CompressedVectorNode.
+The API user is responsible for ensuring that the lifetime of the @a chars and @a offsets arrays exceeds the time that they are used in transfers.
+
+@pre     The @a destImageFile must be open (i.e. destImageFile.isOpen() must be true).
+@return  A smart SourceDestBuffer handle referencing the underlying object.
+@throw   ::E57_ERROR_BAD_PATH_NAME
+@throw   ::E57_ERROR_BAD_BUFFER
+@throw   ::E57_ERROR_IMAGEFILE_NOT_OPEN
+@throw   ::E57_ERROR_INTERNAL           All objects in undocumented state
+@see     SourceDestBuffer::SourceDestBuffer(ImageFile,const ustring,std::vector<ustring>*)
+*/ /*================*/
+  SourceDestBuffer::SourceDestBuffer(ImageFile destImageFile, const ustring pathName, char* chars, const size_t charCapacity, uint64_t* offsets,
+                                     const size_t capacity)
+: impl_(new SourceDestBufferImpl(destImageFile.impl(), pathName, chars, charCapacity, offsets, capacity)){CHECK_THIS_INVARIANCE()}
+
+//! @cond documentNonPublic   The following isn't part of the API, and isn't documented.
+SourceDestBuffer::SourceDestBuffer(std::shared_ptr<SourceDestBufferImpl> ni) : impl_(ni) {}
+//! @endcond
+
   /*================*/
   /*!
 @brief   Get path name in prototype that this SourceDestBuffer will transfer data to/from.
@@ -2700,6 +2739,134 @@ size_t SourceDestBuffer::stride() const
   CHECK_INVARIANCE_RETURN(size_t, impl_->stride());
 }
 
+/*================*/ /*!
+@brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+@param   [in] b             The caller created array of elements to transfer from/to, with the same memory representation as the one the buffer was created with.
+@param   [in] capacity      The number of elements in @a b.
+@details
+A CompressedVectorReader or CompressedVectorWriter checks its buffers against the prototype when they are bound, in CompressedVectorNode::reader,
+CompressedVectorNode::writer, CompressedVectorReader::read(std::vector<SourceDestBuffer>&) and CompressedVectorWriter::write(std::vector<SourceDestBuffer>&, size_t).
+The reader or writer then transfers through these same SourceDestBuffer objects, so rebasing a bound buffer and calling CompressedVectorReader::read() or
+CompressedVectorWriter::write(size_t) uses the new array, without checking the buffers against the prototype again. This makes it cheap to cycle through a ring
+of arrays when streaming through a file in small batches.
+
+The path name, memory representation, doConversion, doScaling and stride are unchanged, so @a b must have the same element layout as the original array.
+Every buffer in a read must have the same capacity, which is checked at each read, and every buffer in a write must hold at least the number of records written.
+A buffer must not be rebased while a CompressedVectorReader::readAsync using it is pending.
+
+@post    The buffer transfers from/to @a b.
+@throw   ::E57_ERROR_BUFFERS_NOT_COMPATIBLE  @a b is not the memory representation of this buffer.
+@throw   ::E57_ERROR_BAD_BUFFER              @a b is nullptr.
+@throw   ::E57_ERROR_INTERNAL                All objects in undocumented state
+@see     CompressedVectorReader::read(), CompressedVectorWriter::write(size_t)
+*/ /*================*/
+void SourceDestBuffer::rebase(int8_t* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_INT8, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(uint8_t* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_UINT8, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(int16_t* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_INT16, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(uint16_t* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_UINT16, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(int32_t* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_INT32, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(uint32_t* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_UINT32, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(int64_t* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_INT64, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(bool* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_BOOL, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(float* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_REAL32, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another array of the same type, between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(double* b, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(MemoryRepresentation::E57_REAL64, reinterpret_cast<char*>(b), capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at another vector of strings, between transfers.  The capacity is @a b->size().
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(std::vector<ustring>* b)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(b);
+  CHECK_THIS_INVARIANCE()
+}
+
+//! @brief   Point this SourceDestBuffer at other char and offset arrays, laid out as in
+//! SourceDestBuffer::SourceDestBuffer(ImageFile,const ustring,char*,size_t,uint64_t*,size_t), between transfers.
+//! @copydetails SourceDestBuffer::rebase(int8_t*,size_t)
+void SourceDestBuffer::rebase(char* chars, const size_t charCapacity, uint64_t* offsets, const size_t capacity)
+{
+  CHECK_THIS_INVARIANCE()
+  impl_->rebase(chars, charCapacity, offsets, capacity);
+  CHECK_THIS_INVARIANCE()
+}
+
 //! @brief   Diagnostic function to print internal state of object to output stream in an indented format.
 //! @copydetails Node::dump()
 #ifdef E57_DEBUG
@@ -2711,6 +2878,221 @@ void SourceDestBuffer::dump(int indent, std::ostream& os) const
 void SourceDestBuffer::dump(int indent, std::ostream& os) const {}
 #endif
 
+//=====================================================================================
+/*================*/ /*!
+@class SourceDestBufferLayout
+@brief   The layout of the fields of a caller's struct, to transfer arrays of those structs to/from a CompressedVectorNode.
+@details
+Points are often kept in memory as an array of structs, for example:
+@code
+struct Point
+{
+  double  x, y, z;
+  float   intensity;
+  uint8_t red, green, blue;
+};
+
+SourceDestBufferLayout layout(sizeof(Point));
+layout.add("cartesianX", offsetof(Point, x), E57_REAL64, true, true);
+layout.add("cartesianY", offsetof(Point, y), E57_REAL64, true, true);
+layout.add("cartesianZ", offsetof(Point, z), E57_REAL64, true, true);
+layout.add("intensity", offsetof(Point, intensity), E57_REAL32, true, true);
+layout.add("colorRed", offsetof(Point, red), E57_UINT8);
+layout.add("colorGreen", offsetof(Point, green), E57_UINT8);
+layout.add("colorBlue", offsetof(Point, blue), E57_UINT8);
+
+std::vector<Point>            points(batchSize);
+std::vector<SourceDestBuffer> buffers = layout.bind(imf, points.data(), points.size());
+CompressedVectorReader        reader  = cv.reader(buffers);
+@endcode
+The layout is described once. bind() then gives one SourceDestBuffer per field, each with a stride of the struct size, so the decoders store straight into the
+structs and the encoders load straight from them, with no per field temporary arrays to interleave by hand. Each field is transferred a block of records at a
+time by a kernel specialized for its memory representation and stride.
+Moving to another array of structs between transfers only needs rebase().
+@see     SourceDestBuffer, SourceDestBuffer::rebase
+*/ /*================*/
+
+/*================*/ /*!
+@brief   Start an empty layout of a struct.
+@param   [in] structSize    The size of the struct in bytes, i.e. the distance between consecutive structs in an array.
+@throw   ::E57_ERROR_BAD_API_ARGUMENT  @a structSize is 0.
+*/ /*================*/
+SourceDestBufferLayout::SourceDestBufferLayout(size_t structSize) : structSize_(structSize)
+{
+  if (structSize_ == 0)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "structSize=" + toString(structSize_));
+}
+
+/*================*/ /*!
+@brief   Add a field of the struct.
+@param   [in] pathName      The pathname of the field in CompressedVectorNode that will transfer data to/from this member of the struct.
+@param   [in] offset        The offset of the member from the start of the struct, usually given by offsetof().
+@param   [in] memoryRepresentation The type of the member.  Strings can't be members, see SourceDestBuffer for string fields.
+@param   [in] doConversion  Will a conversion be performed to match the memory type of the buffer.
+@param   [in] doScaling     In a ScaledIntegerNode transfer, will scaled values be used.
+@details
+The arguments mean the same as those of the SourceDestBuffer constructors, with the stride being the struct size.
+@throw   ::E57_ERROR_BAD_API_ARGUMENT  The member doesn't lie inside the struct, or @a memoryRepresentation is E57_USTRING.
+@see     SourceDestBuffer::SourceDestBuffer(ImageFile,const ustring,int8_t*,size_t,bool,bool,size_t)
+*/ /*================*/
+void SourceDestBufferLayout::add(const ustring& pathName, size_t offset, MemoryRepresentation memoryRepresentation, bool doConversion, bool doScaling)
+{
+  size_t size = 0;
+  switch (memoryRepresentation)
+  {
+  case MemoryRepresentation::E57_INT8:
+    size = sizeof(int8_t);
+    break;
+  case MemoryRepresentation::E57_UINT8:
+    size = sizeof(uint8_t);
+    break;
+  case MemoryRepresentation::E57_INT16:
+    size = sizeof(int16_t);
+    break;
+  case MemoryRepresentation::E57_UINT16:
+    size = sizeof(uint16_t);
+    break;
+  case MemoryRepresentation::E57_INT32:
+    size = sizeof(int32_t);
+    break;
+  case MemoryRepresentation::E57_UINT32:
+    size = sizeof(uint32_t);
+    break;
+  case MemoryRepresentation::E57_INT64:
+    size = sizeof(int64_t);
+    break;
+  case MemoryRepresentation::E57_BOOL:
+    size = sizeof(bool);
+    break;
+  case MemoryRepresentation::E57_REAL32:
+    size = sizeof(float);
+    break;
+  case MemoryRepresentation::E57_REAL64:
+    size = sizeof(double);
+    break;
+  default:
+    throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "pathName=" + pathName + " memoryRepresentation=" + toString(memoryRepresentation));
+  }
+  if (offset > structSize_ || size > structSize_ - offset)
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT,
+                         "pathName=" + pathName + " offset=" + toString(offset) + " size=" + toString(size) + " structSize=" + toString(structSize_));
+  }
+
+  fields_.push_back(Field{pathName, offset, memoryRepresentation, doConversion, doScaling});
+}
+
+//! @brief   Get the size of the struct in bytes, which is the stride of every buffer bound with this layout.
+size_t SourceDestBufferLayout::structSize() const
+{
+  return (structSize_);
+}
+
+//! @brief   Get the number of fields added to the layout.
+size_t SourceDestBufferLayout::fieldCount() const
+{
+  return (fields_.size());
+}
+
+/*================*/ /*!
+@brief   Make the buffers to transfer an array of structs with this layout.
+@param   [in] destImageFile The ImageFile where the new node will eventually be stored.
+@param   [in] structs       The caller created array of structs to transfer from/to.
+@param   [in] capacity      The number of structs in the array.
+@details
+Returns one SourceDestBuffer for each field, in the order they were added, to give to CompressedVectorNode::reader, CompressedVectorNode::writer,
+CompressedVectorReader::read(std::vector<SourceDestBuffer>&) or CompressedVectorWriter::write(std::vector<SourceDestBuffer>&, size_t).
+@pre     The @a destImageFile must be open (i.e. destImageFile.isOpen() must be true).
+@return  The buffers, one per field.
+@throw   ::E57_ERROR_BAD_API_ARGUMENT  No fields have been added.
+@throw   ::E57_ERROR_BAD_PATH_NAME
+@throw   ::E57_ERROR_BAD_BUFFER
+@throw   ::E57_ERROR_IMAGEFILE_NOT_OPEN
+@throw   ::E57_ERROR_INTERNAL           All objects in undocumented state
+*/ /*================*/
+std::vector<SourceDestBuffer> SourceDestBufferLayout::bind(ImageFile destImageFile, void* structs, const size_t capacity) const
+{
+  if (fields_.empty())
+    throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "structSize=" + toString(structSize_));
+  if (structs == nullptr)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "structSize=" + toString(structSize_));
+
+  std::vector<SourceDestBuffer> buffers;
+  buffers.reserve(fields_.size());
+  for (const Field& field : fields_)
+  {
+    char* p    = static_cast<char*>(structs) + field.offset;
+    auto  make = [&](auto* b) { return (SourceDestBuffer(destImageFile, field.pathName, b, capacity, field.doConversion, field.doScaling, structSize_)); };
+    switch (field.memoryRepresentation)
+    {
+    case MemoryRepresentation::E57_INT8:
+      buffers.push_back(make(reinterpret_cast<int8_t*>(p)));
+      break;
+    case MemoryRepresentation::E57_UINT8:
+      buffers.push_back(make(reinterpret_cast<uint8_t*>(p)));
+      break;
+    case MemoryRepresentation::E57_INT16:
+      buffers.push_back(make(reinterpret_cast<int16_t*>(p)));
+      break;
+    case MemoryRepresentation::E57_UINT16:
+      buffers.push_back(make(reinterpret_cast<uint16_t*>(p)));
+      break;
+    case MemoryRepresentation::E57_INT32:
+      buffers.push_back(make(reinterpret_cast<int32_t*>(p)));
+      break;
+    case MemoryRepresentation::E57_UINT32:
+      buffers.push_back(make(reinterpret_cast<uint32_t*>(p)));
+      break;
+    case MemoryRepresentation::E57_INT64:
+      buffers.push_back(make(reinterpret_cast<int64_t*>(p)));
+      break;
+    case MemoryRepresentation::E57_BOOL:
+      buffers.push_back(make(reinterpret_cast<bool*>(p)));
+      break;
+    case MemoryRepresentation::E57_REAL32:
+      buffers.push_back(make(reinterpret_cast<float*>(p)));
+      break;
+    case MemoryRepresentation::E57_REAL64:
+      buffers.push_back(make(reinterpret_cast<double*>(p)));
+      break;
+    default:
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + field.pathName + " memoryRepresentation=" + toString(field.memoryRepresentation));
+    }
+  }
+  return (buffers);
+}
+
+/*================*/ /*!
+@brief   Point buffers made by bind() at another array of structs with this layout, between transfers.
+@param   [in,out] buffers   The buffers returned by bind(), possibly already bound to a reader or writer.
+@param   [in] structs       The caller created array of structs to transfer from/to.
+@param   [in] capacity      The number of structs in the array.
+@details
+Rebases every buffer as SourceDestBuffer::rebase does, so a reader or writer they are bound to transfers from/to @a structs without checking the buffers again.
+@throw   ::E57_ERROR_BUFFERS_NOT_COMPATIBLE  @a buffers weren't made by bind() of this layout.
+@throw   ::E57_ERROR_BAD_BUFFER              @a structs is nullptr.
+@throw   ::E57_ERROR_INTERNAL                All objects in undocumented state
+@see     SourceDestBuffer::rebase(int8_t*,size_t)
+*/ /*================*/
+void SourceDestBufferLayout::rebase(std::vector<SourceDestBuffer>& buffers, void* structs, const size_t capacity) const
+{
+  if (buffers.size() != fields_.size())
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "bufferCount=" + toString(buffers.size()) + " fieldCount=" + toString(fields_.size()));
+  for (size_t i = 0; i < fields_.size(); i++)
+  {
+    if (buffers[i].pathName() != fields_[i].pathName || buffers[i].stride() != structSize_)
+    {
+      throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "pathName=" + buffers[i].pathName() + " fieldPathName=" + fields_[i].pathName
+                                                               + " stride=" + toString(buffers[i].stride()) + " structSize=" + toString(structSize_));
+    }
+  }
+  if (structs == nullptr)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "structSize=" + toString(structSize_));
+
+  for (size_t i = 0; i < fields_.size(); i++)
+    buffers[i].impl()->rebase(fields_[i].memoryRepresentation, static_cast<char*>(structs) + fields_[i].offset, capacity);
+}
+
 //=====================================================================================
 /*================*//*!
 @class CompressedVectorReader
@@ -2832,6 +3214,49 @@ unsigned CompressedVectorReader::read(std::vector<SourceDestBuffer>& dbufs)
   CHECK_INVARIANCE_RETURN(unsigned, impl_->read(dbufs));
 }
 
+/*================*/ /*!
+@brief   Start transfer of a block of data from CompressedVectorNode into given destination buffers, on a background thread.
+@param   [in] dbufs     Vector of memory buffers that will receive data read from a CompressedVectorNode.
+@details
+This is CompressedVectorReader::read(std::vector<SourceDestBuffer>&), except that the records are decoded on a thread owned by this
+CompressedVectorReader while the caller carries on.
+The @a dbufs are checked before this function returns, the same way as by CompressedVectorReader::read(std::vector<SourceDestBuffer>&).
+The returned future gives the number of records read, or rethrows the exception that stopped the transfer.
+
+Only one transfer is in progress at a time.
+Any other call on this CompressedVectorReader, including another readAsync, first waits for it to finish.
+So to keep decoding while the caller processes records, alternate between two (or more) sets of buffers:
+start the read of the next block into one set, then process the block just returned in the other.
+@code
+std::future<unsigned> pending = reader.readAsync(buffersA);
+unsigned              count;
+while ((count = pending.get()) > 0)
+{
+  pending = reader.readAsync(buffersB); // decode the next block into buffersB ...
+  process(buffersA, count);             // ... while processing this one
+  std::swap(buffersA, buffersB);
+}
+@endcode
+
+The API user must not touch the memory buffers of @a dbufs until the future is ready, and must keep them alive until then.
+
+@pre     The associated ImageFile must be open.
+@pre     This CompressedVectorReader must be open (i.e isOpen())
+@return  A future holding the number of records read.
+@throw   ::E57_ERROR_IMAGEFILE_NOT_OPEN
+@throw   ::E57_ERROR_READER_NOT_OPEN
+@throw   ::E57_ERROR_PATH_UNDEFINED
+@throw   ::E57_ERROR_BUFFER_SIZE_MISMATCH
+@throw   ::E57_ERROR_BUFFER_DUPLICATE_PATHNAME
+@throw   ::E57_ERROR_BUFFERS_NOT_COMPATIBLE
+@throw   ::E57_ERROR_INTERNAL           All objects in undocumented state
+@see     CompressedVectorReader::read(std::vector<SourceDestBuffer>&), CompressedVectorNode::reader, SourceDestBuffer
+*/ /*================*/
+std::future<unsigned> CompressedVectorReader::readAsync(std::vector<SourceDestBuffer>& dbufs)
+{
+  CHECK_INVARIANCE_RETURN(std::future<unsigned>, impl_->readAsync(dbufs));
+}
+
 /*================*/ /*!
 @brief   Set record number of CompressedVectorNode where next read will start.
 @param   [in] recordNumber   The index of record in ComressedVectorNode where next read using this CompressedVectorReader will start.
@@ -2840,6 +3265,12 @@ This function may be called at any time (as long as ImageFile and CompressedVect
 The next read will start at the given recordNumber.
 It is not an error to seek to recordNumber = childCount() (i.e. to one record past end of CompressedVectorNode).
 
+The first seek builds an index of the data packets of the binary section, using the index packets if the writer stored them, otherwise by scanning
+the packet headers.
+Fields with a fixed number of bits per record are then positioned directly on the packet holding the record.
+String fields have variable length records, so they are decoded and discarded up to @a recordNumber (from the start of the CompressedVectorNode if
+seeking backwards).
+
 @pre     @a recordNumber <= childCount() of CompressedVectorNode.
 @pre     The associated ImageFile must be open.
 @pre     This CompressedVectorReader must be open (i.e isOpen())
@@ -2904,6 +3335,44 @@ CompressedVectorNode CompressedVectorReader::compressedVectorNode() const
   CHECK_INVARIANCE_RETURN(CompressedVectorNode, impl_->compressedVectorNode());
 }
 
+/*================*/ /*!
+@brief   Return the number of 64 KByte packet buffers in the packet cache of this CompressedVectorReader.
+@details
+If no cache size was given to CompressedVectorNode::reader, the cache grows as the fields being read drift apart in the binary section.
+@pre     This CompressedVectorReader must be open (i.e isOpen())
+@throw   ::E57_ERROR_READER_NOT_OPEN
+@throw   ::E57_ERROR_INTERNAL           All objects in undocumented state
+@see     CompressedVectorReader::cacheHitCount, CompressedVectorReader::cacheMissCount, CompressedVectorNode::reader
+*/ /*================*/
+unsigned CompressedVectorReader::cachePacketCount() const
+{
+  CHECK_INVARIANCE_RETURN(unsigned, impl_->cachePacketCount());
+}
+
+/*================*/ /*!
+@brief   Return the number of packet requests of this CompressedVectorReader that were found in its packet cache.
+@pre     This CompressedVectorReader must be open (i.e isOpen())
+@throw   ::E57_ERROR_READER_NOT_OPEN
+@throw   ::E57_ERROR_INTERNAL           All objects in undocumented state
+@see     CompressedVectorReader::cacheMissCount, CompressedVectorReader::cachePacketCount
+*/ /*================*/
+uint64_t CompressedVectorReader::cacheHitCount() const
+{
+  CHECK_INVARIANCE_RETURN(uint64_t, impl_->cacheHitCount());
+}
+
+/*================*/ /*!
+@brief   Return the number of packet requests of this CompressedVectorReader that had to be read from the file.
+@pre     This CompressedVectorReader must be open (i.e isOpen())
+@throw   ::E57_ERROR_READER_NOT_OPEN
+@throw   ::E57_ERROR_INTERNAL           All objects in undocumented state
+@see     CompressedVectorReader::cacheHitCount, CompressedVectorReader::cachePacketCount
+*/ /*================*/
+uint64_t CompressedVectorReader::cacheMissCount() const
+{
+  CHECK_INVARIANCE_RETURN(uint64_t, impl_->cacheMissCount());
+}
+
 //! @brief   Diagnostic function to print internal state of object to output stream in an indented format.
 //! @copydetails Node::dump()
 #ifdef E57_DEBUG
@@ -3342,10 +3811,17 @@ It is an error for two SourceDestBuffers in @a dbufs to identify the same termin
 
 It is an error to call this function if the CompressedVectorNode already has any records (i.e. a CompressedVectorNode cannot be set twice).
 
+Writers of different CompressedVectorNodes in the same ImageFile can be open at the same time, and each can be used on a thread of its own,
+for example to write the points of several scans at once.
+The binary section of a CompressedVectorNode must be contiguous in the file, so the first of them writes its data packets to the file as they are made,
+while the others keep theirs in memory until the file is free for them, after that writer is closed.
+The tree of nodes must not be changed (e.g. nodes added, or BlobNodes written) while writers are in use on other threads.
+
 @pre     @a sbufs can't be empty (i.e. sbufs.length() > 0).
 @pre     The destination ImageFile must be open (i.e. destImageFile().isOpen()).
 @pre     The @a destImageFile must have been opened in write mode (i.e. destImageFile.isWritable()).
-@pre     The destination ImageFile can't have any readers or writers open (destImageFile().readerCount()==0 && destImageFile().writerCount()==0)
+@pre     The destination ImageFile can't have any readers open (destImageFile().readerCount()==0)
+@pre     This CompressedVectorNode can't have a writer open already.
 @pre     This CompressedVectorNode must be attached (i.e. isAttached()).
 @pre     This CompressedVectorNode must have no records (i.e. childCount() == 0).
 @return  A smart CompressedVectorWriter handle referencing the underlying iterator object.
@@ -3371,19 +3847,30 @@ CompressedVectorWriter CompressedVectorNode::writer(std::vector<SourceDestBuffer
 /*================*/ /*!
 @brief   Create an iterator object for reading a series of blocks of data from a CompressedVectorNode.
 @param   [in] dbufs     Vector of memory buffers that will receive data read from a CompressedVectorNode.
+@param   [in] cachePacketCount Number of 64 KByte packets the reader keeps in memory, or 0 to size the cache automatically.
 @details
 The pathNames in the @a dbufs must identify terminal nodes (i.e. node that can have no children: IntegerNode, ScaledIntegerNode, FloatNode, StringNode) in this CompressedVectorNode's prototype.
 It is an error for two SourceDestBuffers in @a dbufs to identify the same terminal node in the prototype.
 It is not an error to create a CompressedVectorReader for an empty CompressedVectorNode.
 
+Each field of the prototype is stored in its own bytestream, and the bytestreams advance through the binary section at different rates.
+An automatically sized cache grows to hold every packet the fields are currently being read from, so no packet is read from the file twice.
+
+An ImageFile opened in read mode can have any number of CompressedVectorReaders open at once, of the same or different CompressedVectorNodes.
+Each reader reads the file at its own positions without a shared file cursor, so different readers can be used on different threads at the same time,
+as can BlobNode::read. A single reader must still be used by one thread at a time.
+Otherwise only one CompressedVectorReader can be open on the ImageFile.
+
 @pre     @a dbufs can't be empty
 @pre     The destination ImageFile must be open (i.e. destImageFile().isOpen()).
 @pre     The destination ImageFile can't have any writers open (destImageFile().writerCount()==0)
+@pre     Unless the destination ImageFile was opened in read mode, it can't have any readers open (destImageFile().readerCount()==0)
 @pre     This CompressedVectorNode must be attached (i.e. isAttached()).
 @return  A smart CompressedVectorReader handle referencing the underlying iterator object.
 @throw   ::E57_ERROR_BAD_API_ARGUMENT
 @throw   ::E57_ERROR_IMAGEFILE_NOT_OPEN
 @throw   ::E57_ERROR_TOO_MANY_WRITERS
+@throw   ::E57_ERROR_TOO_MANY_READERS
 @throw   ::E57_ERROR_NODE_UNATTACHED
 @throw   ::E57_ERROR_PATH_UNDEFINED
 @throw   ::E57_ERROR_BUFFER_SIZE_MISMATCH
@@ -3392,9 +3879,54 @@ It is not an error to create a CompressedVectorReader for an empty CompressedVec
 @throw   ::E57_ERROR_INTERNAL           All objects in undocumented state
 @see     SourceDestBufferFunctions.cpp example, CompressedVectorReader, SourceDestBuffer, CompressedVectorNode::CompressedVectorNode, CompressedVectorNode::prototype
 */ /*================*/
-CompressedVectorReader CompressedVectorNode::reader(const std::vector<SourceDestBuffer>& dbufs)
+CompressedVectorReader CompressedVectorNode::reader(const std::vector<SourceDestBuffer>& dbufs, unsigned cachePacketCount)
+{
+  CHECK_INVARIANCE_RETURN(CompressedVectorReader, CompressedVectorReader(impl_->reader(dbufs, cachePacketCount)));
+}
+
+/*================*/ /*!
+@brief   Read a block of records from a CompressedVectorNode, decoding several parts of it at once on separate threads.
+@param   [in] dbufs        Vector of memory buffers that will receive the records, each with room for at least @a recordCount of them.
+@param   [in] firstRecord  The index of the first record to read.
+@param   [in] recordCount  The number of records to read.
+@param   [in] rangeCount   The number of parts to split the records into, up to 64, or 0 to pick one per hardware thread.
+@details
+The records are split into @a rangeCount ranges of consecutive records.
+Each range is read by a reader of its own, positioned like CompressedVectorReader::seek, into its part of the @a dbufs arrays,
+so record firstRecord+i ends up in element i of every buffer.
+The ranges are decoded on separate threads if the ImageFile was opened in read mode, otherwise one after another.
+When picking the number of ranges, short reads are split into fewer ranges, because positioning each reader has a fixed cost.
+
+The requirements on @a dbufs are the same as for CompressedVectorNode::reader.
+Other CompressedVectorReaders can only be open on the ImageFile during the call if it was opened in read mode, as for CompressedVectorNode::reader.
+
+@pre     @a dbufs can't be empty
+@pre     firstRecord + recordCount <= childCount()
+@pre     The capacity of each buffer in @a dbufs must be at least @a recordCount.
+@pre     The destination ImageFile must be open (i.e. destImageFile().isOpen()).
+@pre     The destination ImageFile can't have any writers open (destImageFile().writerCount()==0)
+@pre     Unless the destination ImageFile was opened in read mode, it can't have any readers open (destImageFile().readerCount()==0)
+@pre     This CompressedVectorNode must be attached (i.e. isAttached()).
+@throw   ::E57_ERROR_BAD_API_ARGUMENT
+@throw   ::E57_ERROR_IMAGEFILE_NOT_OPEN
+@throw   ::E57_ERROR_TOO_MANY_WRITERS
+@throw   ::E57_ERROR_TOO_MANY_READERS
+@throw   ::E57_ERROR_NODE_UNATTACHED
+@throw   ::E57_ERROR_PATH_UNDEFINED
+@throw   ::E57_ERROR_BUFFER_SIZE_MISMATCH
+@throw   ::E57_ERROR_BUFFER_DUPLICATE_PATHNAME
+@throw   ::E57_ERROR_BAD_CV_HEADER
+@throw   ::E57_ERROR_BAD_CV_PACKET
+@throw   ::E57_ERROR_READ_FAILED
+@throw   ::E57_ERROR_BAD_CHECKSUM
+@throw   ::E57_ERROR_INTERNAL           All objects in undocumented state
+@see     CompressedVectorNode::reader, CompressedVectorReader::seek, SourceDestBuffer
+*/ /*================*/
+void CompressedVectorNode::readParallel(const std::vector<SourceDestBuffer>& dbufs, int64_t firstRecord, int64_t recordCount, unsigned rangeCount)
 {
-  CHECK_INVARIANCE_RETURN(CompressedVectorReader, CompressedVectorReader(impl_->reader(dbufs)));
+  CHECK_THIS_INVARIANCE()
+  impl_->readParallel(dbufs, firstRecord, recordCount, rangeCount);
+  CHECK_THIS_INVARIANCE()
 }
 
 //=====================================================================================
@@ -4606,7 +5138,19 @@ It is recommended that files that meet all of the requirements for a legal ASTM
 It is recommended that files that utilize the low-level E57 element data types, but do not have all the required element names required by ASTM E57 file format standard use the file extension @c "._e57".
 @param   [in] mode Either "w" for writing or "r" for reading.
 @param   [in] configuration A string that modifies the configuration of the E57 API implementation at run-time.
-Currently, in the reference implementation, this parameter is ignored.
+The string is a list of options separated by white space, commas or semicolons.
+The recognized options are:
+- @c "mmap", which in read mode reads the file through a memory mapping instead of individual read calls
+(the option is ignored on platforms without memory mapping support, and in write mode).
+- @c "prefetch=N", with N from 1 to 64, which in read mode has each CompressedVectorReader read the next N data packets on a worker thread
+while the current packet is decoded (the option is ignored in write mode).
+- @c "encoders=N", with N from 1 to 64, which in write mode has each CompressedVectorWriter encode its fields on N threads, the calling one included
+(the file written is the same as with a single thread; the option is ignored in read mode).
+- @c "decoders=N", with N from 1 to 64, which in read mode has each CompressedVectorReader decode its fields on N threads, the calling one included,
+several data packets at a time (the option is ignored in write mode).
+- @c "writequeue=N", with N from 1 to 64, which in write mode has CompressedVectorWriters queue up to N data packets for an I/O thread
+that checksums and writes them while the next packets are encoded (the file written is the same; the option is ignored in read mode).
+An empty string selects the default configuration.
 @details
 
 @par Write Mode
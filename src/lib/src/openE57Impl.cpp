@@ -50,16 +50,20 @@
 #  define __LARGE64_FILES
 #  include <fcntl.h>
 #  include <sys/stat.h>
+#  include <sys/mman.h>
 #  include <sys/types.h>
 #  include <unistd.h>
 #  define O_BINARY (0)
 #  define _unlink unlink
+#  define E57_HAVE_MMAP 1
+#  define E57_HAVE_PREAD 1
 #else
 #  error "no supported OS platform defined"
 #endif
 
 #include <cmath> // floor()
 #include <cstdint>
+#include <cstdio> // for tmpfile
 #include <sstream>
 
 #ifdef E57_MAX_VERBOSE
@@ -69,13 +73,15 @@ using std::cout;
 using std::endl;
 #endif
 
+#include <cstdlib> // for strtoul
 #include <cstring> // for memset
+#include <limits>
+#include <type_traits>
 
-#include <openE57/impl/crc.h>
+#include <openE57/impl/bitpack.h>
+#include <openE57/impl/crc32c.h>
 #include <openE57/impl/openE57Impl.h>
 
-const auto CRC32C_LOOKUP_TABLE = CRC::CRC_32_C().MakeTable();
-
 using namespace e57;
 // using namespace std;
 using std::cerr;
@@ -991,7 +997,8 @@ void VectorNodeImpl::dump(int indent, ostream& os)
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, int8_t* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_INT8), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1000,7 +1007,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, uint8_t* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_UINT8), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1009,7 +1017,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, int16_t* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_INT16), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1018,7 +1027,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, uint16_t* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_UINT16), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1027,7 +1037,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, int32_t* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_INT32), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1036,7 +1047,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, uint32_t* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_UINT32), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1045,7 +1057,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, int64_t* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_INT64), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1054,7 +1067,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, bool* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_BOOL), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1063,7 +1077,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, float* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_REAL32), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1072,7 +1087,8 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, double* base, const size_t capacity,
                                            bool doConversion, bool doScaling, size_t stride)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_REAL64), base_(reinterpret_cast<char*>(base)),
-  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0)
+  capacity_(capacity), doConversion_(doConversion), doScaling_(doScaling), stride_(stride), nextIndex_(0), ustrings_(0), stringOffsets_(nullptr),
+  charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
   checkState_();
@@ -1080,7 +1096,7 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
 
 SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, vector<ustring>* b)
 : destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_USTRING), base_(0), capacity_(0 /*updated below*/),
-  doConversion_(false), doScaling_(false), stride_(0), nextIndex_(0), ustrings_(b)
+  doConversion_(false), doScaling_(false), stride_(0), nextIndex_(0), ustrings_(b), stringOffsets_(nullptr), charCapacity_(0)
 {
   /// don't checkImageFileOpen, checkState_ will do it
 
@@ -1095,6 +1111,18 @@ SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImag
   /// The size() of *ustrings_ will not be changed as strings are stored in it.
 }
 
+SourceDestBufferImpl::SourceDestBufferImpl(std::weak_ptr<ImageFileImpl> destImageFile, const ustring pathName, char* chars, const size_t charCapacity,
+                                           uint64_t* offsets, const size_t capacity)
+: destImageFile_(destImageFile), pathName_(pathName), memoryRepresentation_(MemoryRepresentation::E57_USTRING), base_(chars), capacity_(capacity),
+  doConversion_(false), doScaling_(false), stride_(0), nextIndex_(0), ustrings_(0), stringOffsets_(offsets), charCapacity_(charCapacity)
+{
+  /// don't checkImageFileOpen, checkState_ will do it
+  checkState_();
+
+  /// String i is chars[offsets[i]] .. chars[offsets[i+1]-1], so offsets has capacity+1 elements.
+  /// Strings are read into chars one after another from chars[0], so no memory is allocated for them.
+}
+
 void SourceDestBufferImpl::checkState_()
 {
   /// Implement checkImageFileOpen functionality for SourceDestBufferImpl ctors
@@ -1116,6 +1144,11 @@ void SourceDestBufferImpl::checkState_()
     //??? check base alignment, depending on CPU type
     //??? check if stride too small, positive or negative
   }
+  else if (stringOffsets_ != nullptr)
+  {
+    if (base_ == nullptr && charCapacity_ > 0)
+      throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "pathName=" + pathName_);
+  }
   else
   {
     if (ustrings_ == nullptr)
@@ -1123,6 +1156,51 @@ void SourceDestBufferImpl::checkState_()
   }
 }
 
+void SourceDestBufferImpl::rebase(MemoryRepresentation memoryRepresentation, char* base, const size_t capacity)
+{
+  /// don't checkImageFileOpen
+
+  if (memoryRepresentation != memoryRepresentation_)
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE,
+                         "pathName=" + pathName_ + " memoryRepresentation=" + toString(memoryRepresentation_) + " newMemoryType=" + toString(memoryRepresentation));
+  if (base == nullptr)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "pathName=" + pathName_);
+
+  base_      = base;
+  capacity_  = capacity;
+  nextIndex_ = 0;
+}
+
+void SourceDestBufferImpl::rebase(std::vector<ustring>* b)
+{
+  /// don't checkImageFileOpen
+
+  if (memoryRepresentation_ != E57_USTRING || ustrings_ == nullptr)
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "pathName=" + pathName_ + " memoryRepresentation=" + toString(memoryRepresentation_));
+  if (b == nullptr)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "pathName=" + pathName_);
+
+  ustrings_  = b;
+  capacity_  = b->size();
+  nextIndex_ = 0;
+}
+
+void SourceDestBufferImpl::rebase(char* chars, const size_t charCapacity, uint64_t* offsets, const size_t capacity)
+{
+  /// don't checkImageFileOpen
+
+  if (memoryRepresentation_ != E57_USTRING || stringOffsets_ == nullptr)
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "pathName=" + pathName_ + " memoryRepresentation=" + toString(memoryRepresentation_));
+  if (offsets == nullptr || (chars == nullptr && charCapacity > 0))
+    throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "pathName=" + pathName_);
+
+  base_          = chars;
+  charCapacity_  = charCapacity;
+  stringOffsets_ = offsets;
+  capacity_      = capacity;
+  nextIndex_     = 0;
+}
+
 int64_t SourceDestBufferImpl::getNextInt64()
 {
   /// don't checkImageFileOpen
@@ -1432,6 +1510,21 @@ ustring SourceDestBufferImpl::getNextString()
 {
   /// don't checkImageFileOpen
 
+  /// Check have correct type buffer
+  if (memoryRepresentation_ != MemoryRepresentation::E57_USTRING)
+    throw E57_EXCEPTION2(E57_ERROR_EXPECTING_USTRING, "pathName=" + pathName_);
+
+  /// Verify index is within bounds
+  if (nextIndex_ >= capacity_)
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_);
+
+  return (ustring(getNextStringView()));
+}
+
+std::string_view SourceDestBufferImpl::getNextStringView()
+{
+  /// don't checkImageFileOpen
+
   /// Check have correct type buffer
   if (memoryRepresentation_ != MemoryRepresentation::E57_USTRING)
     throw E57_EXCEPTION2(E57_ERROR_EXPECTING_USTRING, "pathName=" + pathName_);
@@ -1441,7 +1534,17 @@ ustring SourceDestBufferImpl::getNextString()
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_);
 
   /// Get ustring from vector
-  return ((*ustrings_)[nextIndex_++]);
+  if (stringOffsets_ == nullptr)
+    return ((*ustrings_)[nextIndex_++]);
+
+  /// Or find it in the char array, after checking the caller's offsets stay inside it
+  uint64_t first = stringOffsets_[nextIndex_];
+  uint64_t end   = stringOffsets_[nextIndex_ + 1];
+  if (end < first || end > charCapacity_)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "pathName=" + pathName_ + " index=" + toString(nextIndex_) + " offset=" + toString(first) + " endOffset="
+                                                   + toString(end) + " charCapacity=" + toString(charCapacity_));
+  nextIndex_++;
+  return (std::string_view(base_ + first, static_cast<size_t>(end - first)));
 }
 
 void SourceDestBufferImpl::setNextInt64(int64_t value)
@@ -1784,147 +1887,758 @@ void SourceDestBufferImpl::setNextString(const ustring& value)
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_);
 
   /// Assign to already initialized element in vector
-  (*ustrings_)[nextIndex_] = value;
+  if (stringOffsets_ == nullptr)
+  {
+    (*ustrings_)[nextIndex_] = value;
+    nextIndex_++;
+    return;
+  }
+
+  /// Or pack it after the previous one in the char array
+  char* p = beginNextString(value.length());
+  memcpy(p, value.data(), value.length());
+  endNextString();
+}
+
+bool SourceDestBufferImpl::hasRoomForString(uint64_t length)
+{
+  /// don't checkImageFileOpen
+
+  /// Elements of a vector grow to fit
+  if (stringOffsets_ == nullptr)
+    return (true);
+
+  uint64_t first = (nextIndex_ == 0) ? 0 : stringOffsets_[nextIndex_];
+  if (length <= charCapacity_ - first)
+    return (true);
+
+  /// A string that doesn't fit in the whole char array never will, give up rather than wait for room
+  if (nextIndex_ == 0)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "pathName=" + pathName_ + " length=" + toString(length) + " charCapacity=" + toString(charCapacity_));
+  return (false);
+}
+
+char* SourceDestBufferImpl::beginNextString(uint64_t length)
+{
+  /// don't checkImageFileOpen
+
+  if (memoryRepresentation_ != MemoryRepresentation::E57_USTRING)
+    throw E57_EXCEPTION2(E57_ERROR_EXPECTING_USTRING, "pathName=" + pathName_);
+
+  /// Verify have room.
+  if (nextIndex_ >= capacity_)
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_);
+
+  /// Resizing the element keeps the memory it has, so a vector read into again doesn't allocate for strings that fit
+  if (stringOffsets_ == nullptr)
+  {
+    ustring& s = (*ustrings_)[nextIndex_];
+    s.resize(static_cast<size_t>(length));
+    return (s.data());
+  }
+
+  /// The first string read starts the char array
+  if (nextIndex_ == 0)
+    stringOffsets_[0] = 0;
+  uint64_t first = stringOffsets_[nextIndex_];
+  if (length > charCapacity_ - first)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_BUFFER, "pathName=" + pathName_ + " index=" + toString(nextIndex_) + " length=" + toString(length)
+                                                   + " charCapacity=" + toString(charCapacity_));
+  stringOffsets_[nextIndex_ + 1] = first + length;
+  return (base_ + first);
+}
+
+void SourceDestBufferImpl::endNextString()
+{
+  /// don't checkImageFileOpen
+
+  /// beginNextString() checked there was room
   nextIndex_++;
 }
 
-void SourceDestBufferImpl::checkCompatible(std::shared_ptr<SourceDestBufferImpl> newBuf)
+template <typename RegisterT, typename DestT, bool Scaled>
+void SourceDestBufferImpl::storeIntegers(const RegisterT* raw, size_t count, int64_t minimum, double scale, double offset)
 {
-  if (pathName_ != newBuf->pathName())
+  /// don't checkImageFileOpen
+
+  if constexpr (std::is_same<DestT, ustring>::value)
   {
-    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "pathName=" + pathName_ + " newPathName=" + newBuf->pathName());
+    if (count > 0)
+      throw E57_EXCEPTION2(E57_ERROR_EXPECTING_NUMERIC, "pathName=" + pathName_);
+    return;
   }
-  if (memoryRepresentation_ != newBuf->memoryRepresentation())
+  else
   {
-    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE,
-                         "memoryRepresentation=" + toString(memoryRepresentation_) + " newMemoryType=" + toString(newBuf->memoryRepresentation()));
+    /// Verify have room
+    if (count > capacity_ - nextIndex_)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " count=" + toString(count));
+
+    if (std::is_floating_point<DestT>::value && !doConversion_ && count > 0)
+      throw E57_EXCEPTION2(E57_ERROR_CONVERSION_REQUIRED, "pathName=" + pathName_);
+
+    /// Same arithmetic as setNextInt64(): add minimum back (modulo 2^64), then x*scale+offset, rounded to nearest if DestT is an integer.
+    auto convert = [=](size_t i) {
+      int64_t value = minimum + static_cast<uint64_t>(raw[i]);
+      if constexpr (!Scaled)
+        return (value);
+      else if constexpr (std::is_floating_point<DestT>::value)
+        return (value * scale + offset);
+      else
+        return (floor(value * scale + offset + 0.5));
+    };
+
+    /// Narrow integer destinations are range checked.  Check the whole span first so the store loop below has no early exit.
+    /// On failure, redo the span one record at a time so the exception and the records stored before it are exactly those of setNextInt64().
+    if constexpr (std::is_integral<DestT>::value && !std::is_same<DestT, bool>::value && sizeof(DestT) < sizeof(int64_t))
+    {
+      bool outOfRange = false;
+      for (size_t i = 0; i < count; i++)
+      {
+        auto value = convert(i);
+        outOfRange |= (value < std::numeric_limits<DestT>::lowest()) | (std::numeric_limits<DestT>::max() < value);
+      }
+      if (outOfRange)
+      {
+        for (size_t i = 0; i < count; i++)
+        {
+          if (Scaled)
+            setNextInt64(minimum + static_cast<uint64_t>(raw[i]), scale, offset);
+          else
+            setNextInt64(minimum + static_cast<uint64_t>(raw[i]));
+        }
+        return;
+      }
+    }
+
+    /// Calc start of memory location, index into buffer using stride_ (the distance between elements).
+    char* p = &base_[nextIndex_ * stride_];
+
+    if constexpr (std::is_same<DestT, bool>::value)
+    {
+      for (size_t i = 0; i < count; i++)
+        *reinterpret_cast<bool*>(p + i * stride_) = (convert(i) ? false : true);
+    }
+    else if (stride_ == sizeof(DestT))
+    {
+      DestT* dest = reinterpret_cast<DestT*>(p);
+      for (size_t i = 0; i < count; i++)
+        dest[i] = static_cast<DestT>(convert(i));
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+        *reinterpret_cast<DestT*>(p + i * stride_) = static_cast<DestT>(convert(i));
+    }
+
+    nextIndex_ += static_cast<unsigned>(count);
   }
-  if (capacity_ != newBuf->capacity())
+}
+
+template <typename FloatT, typename DestT>
+void SourceDestBufferImpl::storeFloats(const FloatT* values, size_t count)
+{
+  /// don't checkImageFileOpen
+
+  if constexpr (std::is_same<DestT, ustring>::value)
   {
-    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "capacity=" + toString(capacity_) + " newCapacity=" + toString(newBuf->capacity()));
+    if (count > 0)
+      throw E57_EXCEPTION2(E57_ERROR_EXPECTING_NUMERIC, "pathName=" + pathName_);
+    return;
   }
-  if (doConversion_ != newBuf->doConversion())
+  else
   {
-    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "doConversion=" + toString(doConversion_) + "newDoConversion=" + toString(newBuf->doConversion()));
+    /// Verify have room
+    if (count > capacity_ - nextIndex_)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " count=" + toString(count));
+
+    if (std::is_integral<DestT>::value && !doConversion_ && count > 0)
+      throw E57_EXCEPTION2(E57_ERROR_CONVERSION_REQUIRED, "pathName=" + pathName_);
+
+    /// Integer destinations are range checked, see storeIntegers() for why this is a separate pass.
+    if constexpr (std::is_integral<DestT>::value && !std::is_same<DestT, bool>::value)
+    {
+      bool outOfRange = false;
+      for (size_t i = 0; i < count; i++)
+        outOfRange |= (values[i] < static_cast<FloatT>(std::numeric_limits<DestT>::lowest())) | (static_cast<FloatT>(std::numeric_limits<DestT>::max()) < values[i]);
+      if (outOfRange)
+      {
+        for (size_t i = 0; i < count; i++)
+        {
+          if (std::is_same<FloatT, float>::value)
+            setNextFloat(static_cast<float>(values[i]));
+          else
+            setNextDouble(values[i]);
+        }
+        return;
+      }
+    }
+
+    /// Calc start of memory location, index into buffer using stride_ (the distance between elements).
+    char* p = &base_[nextIndex_ * stride_];
+
+    if constexpr (std::is_same<DestT, bool>::value)
+    {
+      for (size_t i = 0; i < count; i++)
+        *reinterpret_cast<bool*>(p + i * stride_) = (values[i] ? false : true);
+    }
+    else if (std::is_same<DestT, FloatT>::value && stride_ == sizeof(DestT))
+    {
+      memcpy(p, values, count * sizeof(DestT));
+    }
+    else if (stride_ == sizeof(DestT))
+    {
+      DestT* dest = reinterpret_cast<DestT*>(p);
+      for (size_t i = 0; i < count; i++)
+        dest[i] = static_cast<DestT>(values[i]);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+        *reinterpret_cast<DestT*>(p + i * stride_) = static_cast<DestT>(values[i]);
+    }
+
+    nextIndex_ += static_cast<unsigned>(count);
   }
-  if (doConversion_ != newBuf->doConversion())
+}
+
+template <typename RegisterT>
+SourceDestBufferImpl::StoreIntegersFunction<RegisterT> SourceDestBufferImpl::storeIntegersKernel(bool isScaledInteger)
+{
+  /// Scaling is only applied if both the field is a ScaledInteger and the user asked for it when constructing the buffer, see setNextInt64(value, scale, offset).
+  if (isScaledInteger && doScaling_)
   {
-    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "doConversion=" + toString(doConversion_) + " newDoConversion=" + toString(newBuf->doConversion()));
+    switch (memoryRepresentation_)
+    {
+    case MemoryRepresentation::E57_INT8:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, int8_t, true>);
+    case MemoryRepresentation::E57_UINT8:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, uint8_t, true>);
+    case MemoryRepresentation::E57_INT16:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, int16_t, true>);
+    case MemoryRepresentation::E57_UINT16:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, uint16_t, true>);
+    case MemoryRepresentation::E57_INT32:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, int32_t, true>);
+    case MemoryRepresentation::E57_UINT32:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, uint32_t, true>);
+    case MemoryRepresentation::E57_INT64:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, int64_t, true>);
+    case MemoryRepresentation::E57_BOOL:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, bool, true>);
+    case MemoryRepresentation::E57_REAL32:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, float, true>);
+    case MemoryRepresentation::E57_REAL64:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, double, true>);
+    case MemoryRepresentation::E57_USTRING:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, ustring, true>);
+    }
   }
-  if (stride_ != newBuf->stride())
+  else
   {
-    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "stride=" + toString(stride_) + " newStride=" + toString(newBuf->stride()));
+    switch (memoryRepresentation_)
+    {
+    case MemoryRepresentation::E57_INT8:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, int8_t, false>);
+    case MemoryRepresentation::E57_UINT8:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, uint8_t, false>);
+    case MemoryRepresentation::E57_INT16:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, int16_t, false>);
+    case MemoryRepresentation::E57_UINT16:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, uint16_t, false>);
+    case MemoryRepresentation::E57_INT32:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, int32_t, false>);
+    case MemoryRepresentation::E57_UINT32:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, uint32_t, false>);
+    case MemoryRepresentation::E57_INT64:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, int64_t, false>);
+    case MemoryRepresentation::E57_BOOL:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, bool, false>);
+    case MemoryRepresentation::E57_REAL32:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, float, false>);
+    case MemoryRepresentation::E57_REAL64:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, double, false>);
+    case MemoryRepresentation::E57_USTRING:
+      return (&SourceDestBufferImpl::storeIntegers<RegisterT, ustring, false>);
+    }
   }
+  throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " memoryRepresentation=" + toString(memoryRepresentation_));
 }
 
-#ifdef E57_DEBUG
-void SourceDestBufferImpl::dump(int indent, ostream& os)
+template <typename FloatT>
+SourceDestBufferImpl::StoreFloatsFunction<FloatT> SourceDestBufferImpl::storeFloatsKernel()
 {
-  /// don't checkImageFileOpen
-
-  os << space(indent) << "pathName:             " << pathName_ << endl;
-  os << space(indent) << "memoryRepresentation: ";
   switch (memoryRepresentation_)
   {
   case MemoryRepresentation::E57_INT8:
-    os << "int8_t" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, int8_t>);
   case MemoryRepresentation::E57_UINT8:
-    os << "uint8_t" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, uint8_t>);
   case MemoryRepresentation::E57_INT16:
-    os << "int16_t" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, int16_t>);
   case MemoryRepresentation::E57_UINT16:
-    os << "uint16_t" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, uint16_t>);
   case MemoryRepresentation::E57_INT32:
-    os << "int32_t" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, int32_t>);
   case MemoryRepresentation::E57_UINT32:
-    os << "uint32_t" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, uint32_t>);
   case MemoryRepresentation::E57_INT64:
-    os << "int64_t" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, int64_t>);
   case MemoryRepresentation::E57_BOOL:
-    os << "bool" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, bool>);
   case MemoryRepresentation::E57_REAL32:
-    os << "float" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, float>);
   case MemoryRepresentation::E57_REAL64:
-    os << "double" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, double>);
   case MemoryRepresentation::E57_USTRING:
-    os << "ustring" << endl;
-    break;
-  default:
-    os << "<unknown>" << endl;
-    break;
+    return (&SourceDestBufferImpl::storeFloats<FloatT, ustring>);
   }
-  os << space(indent) << "base:                 " << static_cast<const void*>(base_) << endl;
-  os << space(indent) << "ustrings:             " << static_cast<const void*>(ustrings_) << endl;
-  os << space(indent) << "capacity:             " << capacity_ << endl;
-  os << space(indent) << "doConversion:         " << doConversion_ << endl;
-  os << space(indent) << "doScaling:            " << doScaling_ << endl;
-  os << space(indent) << "stride:               " << stride_ << endl;
-  os << space(indent) << "nextIndex:            " << nextIndex_ << endl;
-}
-#endif
-
-//=============================================================================
-CompressedVectorNodeImpl::CompressedVectorNodeImpl(std::weak_ptr<ImageFileImpl> destImageFile) : NodeImpl(destImageFile)
-{
-  // don't checkImageFileOpen, NodeImpl() will do it
-
-  recordCount_               = 0;
-  binarySectionLogicalStart_ = 0;
-}
-
-NodeType CompressedVectorNodeImpl::type()
-{
-  // don't checkImageFileOpen
-  return (E57_COMPRESSED_VECTOR);
+  throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " memoryRepresentation=" + toString(memoryRepresentation_));
 }
 
-void CompressedVectorNodeImpl::setPrototype(std::shared_ptr<NodeImpl> prototype)
+template <typename SourceT, typename RawT, bool Scaled>
+void SourceDestBufferImpl::loadIntegers(RawT* raw, size_t count, int64_t minimum, int64_t maximum, double scale, double offset)
 {
-  // don't checkImageFileOpen, ctor did it
-
-  //??? check ok for proto, no Blob CompressedVector, empty?
-  //??? throw E57_EXCEPTION2(E57_ERROR_BAD_PROTOTYPE)
+  /// don't checkImageFileOpen
 
-  /// Can't set prototype twice.
-  if (prototype_)
-    throw E57_EXCEPTION2(E57_ERROR_SET_TWICE, "this->pathName=" + this->pathName());
+  if (count == 0)
+    return;
 
-  /// prototype can't have a parent (must be a root node)
-  if (!prototype->isRoot())
+  if constexpr (std::is_same<SourceT, ustring>::value)
   {
-    throw E57_EXCEPTION2(E57_ERROR_ALREADY_HAS_PARENT, "this->pathName=" + this->pathName() + " prototype->pathName=" + prototype->pathName());
+    throw E57_EXCEPTION2(E57_ERROR_EXPECTING_NUMERIC, "pathName=" + pathName_);
   }
-
-  /// Verify that prototype is destined for same ImageFile as this is
-  std::shared_ptr<ImageFileImpl> thisDest(destImageFile());
-  std::shared_ptr<ImageFileImpl> prototypeDest(prototype->destImageFile());
-  if (thisDest != prototypeDest)
+  else
   {
-    throw E57_EXCEPTION2(E57_ERROR_DIFFERENT_DEST_IMAGEFILE,
-                         "this->destImageFile" + thisDest->fileName() + " prototype->destImageFile" + prototypeDest->fileName());
-  }
+    /// Same checks as getNextInt64(), done once for the span
+    if (Scaled && scale == 0)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_);
+    if (count > capacity_ - nextIndex_)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " count=" + toString(count));
+    if ((std::is_floating_point<SourceT>::value || (!Scaled && std::is_same<SourceT, bool>::value)) && !doConversion_)
+      throw E57_EXCEPTION2(E57_ERROR_CONVERSION_REQUIRED, "pathName=" + pathName_);
 
-  //!!! check for incomplete CompressedVectors when closing file
-  prototype_ = prototype;
+    /// Calc start of memory location, index into buffer using stride_ (the distance between elements).
+    const char* p = &base_[nextIndex_ * stride_];
 
-  /// Note that prototype is not attached to CompressedVector in a parent/child relationship.
-  /// This means that prototype is a root node (has no parent).
-}
+    /// Real values of a ScaledInteger with a range of at most 32 bits are converted in SIMD registers.
+    /// Interleaved values, such as a member of an array of structs, are gathered into a contiguous block for it first.
+    if constexpr (Scaled && std::is_same<SourceT, double>::value && std::is_same<RawT, uint32_t>::value)
+    {
+      constexpr int64_t exactLimit = int64_t(1) << 53;
+      if (-exactLimit <= minimum && maximum <= exactLimit)
+      {
+        bool quantized = true;
+        if (stride_ == sizeof(double))
+          quantized = utils::quantize(reinterpret_cast<const double*>(p), count, scale, offset, minimum, maximum, raw);
+        else
+        {
+          constexpr size_t blockSize = 256;
+          double           gathered[blockSize];
+          for (size_t i = 0; i < count && quantized; i += blockSize)
+          {
+            const size_t blockCount = min(blockSize, count - i);
+            for (size_t j = 0; j < blockCount; j++)
+              gathered[j] = *reinterpret_cast<const double*>(p + (i + j) * stride_);
+            quantized = utils::quantize(gathered, blockCount, scale, offset, minimum, maximum, raw + i);
+          }
+        }
+        if (quantized)
+        {
+          nextIndex_ += static_cast<unsigned>(count);
+          return;
+        }
+      }
+    }
 
-std::shared_ptr<NodeImpl> CompressedVectorNodeImpl::getPrototype()
-{
-  checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
-  return (prototype_); //??? check defined
+    /// Same arithmetic as getNextInt64(): (x-offset)/scale rounded to nearest if scaled, truncated to an integer otherwise.
+    /// Values that can't be represented as an int64_t are flagged instead of converted, and get the exact exception from the redo below.
+    auto convert = [=](const SourceT& value, bool& ok) -> int64_t {
+      if constexpr (!Scaled)
+      {
+        if constexpr (std::is_same<SourceT, bool>::value)
+          return (value ? 1 : 0);
+        else
+          return (static_cast<int64_t>(value));
+      }
+      else
+      {
+        double doubleRawValue;
+        if constexpr (std::is_same<SourceT, bool>::value)
+          doubleRawValue = floor(((value ? 1 : 0) - offset) / scale + 0.5);
+        else
+          doubleRawValue = floor((value - offset) / scale + 0.5);
+        const bool representable = (E57_INT64_MIN <= doubleRawValue) & (doubleRawValue < E57_INT64_MAX);
+        ok &= representable;
+        return (static_cast<int64_t>(representable ? doubleRawValue : 0.0));
+      }
+    };
+
+    bool ok = true;
+    if (stride_ == sizeof(SourceT))
+    {
+      const SourceT* source = reinterpret_cast<const SourceT*>(p);
+      for (size_t i = 0; i < count; i++)
+      {
+        const int64_t rawValue = convert(source[i], ok);
+        ok &= (minimum <= rawValue) & (rawValue <= maximum);
+        raw[i] = static_cast<RawT>(static_cast<uint64_t>(rawValue) - static_cast<uint64_t>(minimum));
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+      {
+        const int64_t rawValue = convert(*reinterpret_cast<const SourceT*>(p + i * stride_), ok);
+        ok &= (minimum <= rawValue) & (rawValue <= maximum);
+        raw[i] = static_cast<RawT>(static_cast<uint64_t>(rawValue) - static_cast<uint64_t>(minimum));
+      }
+    }
+
+    if (ok)
+    {
+      nextIndex_ += static_cast<unsigned>(count);
+      return;
+    }
+
+    /// Some value is out of bounds, redo the span one record at a time so the exception is exactly the one of the record by record encoder.
+    for (size_t i = 0; i < count; i++)
+    {
+      const int64_t rawValue = Scaled ? getNextInt64(scale, offset) : getNextInt64();
+      if (rawValue < minimum || maximum < rawValue)
+      {
+        throw E57_EXCEPTION2(E57_ERROR_VALUE_OUT_OF_BOUNDS,
+                             "rawValue=" + toString(rawValue) + " minimum=" + toString(minimum) + " maximum=" + toString(maximum));
+      }
+      raw[i] = static_cast<RawT>(static_cast<uint64_t>(rawValue) - static_cast<uint64_t>(minimum));
+    }
+  }
+}
+
+template <typename RawT>
+SourceDestBufferImpl::LoadIntegersFunction<RawT> SourceDestBufferImpl::loadIntegersKernel(bool isScaledInteger)
+{
+  /// Scaling is only undone if both the field is a ScaledInteger and the user asked for it when constructing the buffer, see getNextInt64(scale, offset).
+  if (isScaledInteger && doScaling_)
+  {
+    switch (memoryRepresentation_)
+    {
+    case MemoryRepresentation::E57_INT8:
+      return (&SourceDestBufferImpl::loadIntegers<int8_t, RawT, true>);
+    case MemoryRepresentation::E57_UINT8:
+      return (&SourceDestBufferImpl::loadIntegers<uint8_t, RawT, true>);
+    case MemoryRepresentation::E57_INT16:
+      return (&SourceDestBufferImpl::loadIntegers<int16_t, RawT, true>);
+    case MemoryRepresentation::E57_UINT16:
+      return (&SourceDestBufferImpl::loadIntegers<uint16_t, RawT, true>);
+    case MemoryRepresentation::E57_INT32:
+      return (&SourceDestBufferImpl::loadIntegers<int32_t, RawT, true>);
+    case MemoryRepresentation::E57_UINT32:
+      return (&SourceDestBufferImpl::loadIntegers<uint32_t, RawT, true>);
+    case MemoryRepresentation::E57_INT64:
+      return (&SourceDestBufferImpl::loadIntegers<int64_t, RawT, true>);
+    case MemoryRepresentation::E57_BOOL:
+      return (&SourceDestBufferImpl::loadIntegers<bool, RawT, true>);
+    case MemoryRepresentation::E57_REAL32:
+      return (&SourceDestBufferImpl::loadIntegers<float, RawT, true>);
+    case MemoryRepresentation::E57_REAL64:
+      return (&SourceDestBufferImpl::loadIntegers<double, RawT, true>);
+    case MemoryRepresentation::E57_USTRING:
+      return (&SourceDestBufferImpl::loadIntegers<ustring, RawT, true>);
+    }
+  }
+  else
+  {
+    switch (memoryRepresentation_)
+    {
+    case MemoryRepresentation::E57_INT8:
+      return (&SourceDestBufferImpl::loadIntegers<int8_t, RawT, false>);
+    case MemoryRepresentation::E57_UINT8:
+      return (&SourceDestBufferImpl::loadIntegers<uint8_t, RawT, false>);
+    case MemoryRepresentation::E57_INT16:
+      return (&SourceDestBufferImpl::loadIntegers<int16_t, RawT, false>);
+    case MemoryRepresentation::E57_UINT16:
+      return (&SourceDestBufferImpl::loadIntegers<uint16_t, RawT, false>);
+    case MemoryRepresentation::E57_INT32:
+      return (&SourceDestBufferImpl::loadIntegers<int32_t, RawT, false>);
+    case MemoryRepresentation::E57_UINT32:
+      return (&SourceDestBufferImpl::loadIntegers<uint32_t, RawT, false>);
+    case MemoryRepresentation::E57_INT64:
+      return (&SourceDestBufferImpl::loadIntegers<int64_t, RawT, false>);
+    case MemoryRepresentation::E57_BOOL:
+      return (&SourceDestBufferImpl::loadIntegers<bool, RawT, false>);
+    case MemoryRepresentation::E57_REAL32:
+      return (&SourceDestBufferImpl::loadIntegers<float, RawT, false>);
+    case MemoryRepresentation::E57_REAL64:
+      return (&SourceDestBufferImpl::loadIntegers<double, RawT, false>);
+    case MemoryRepresentation::E57_USTRING:
+      return (&SourceDestBufferImpl::loadIntegers<ustring, RawT, false>);
+    }
+  }
+  throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " memoryRepresentation=" + toString(memoryRepresentation_));
+}
+
+template <typename SourceT, typename FloatT>
+void SourceDestBufferImpl::loadFloats(FloatT* values, size_t count)
+{
+  /// don't checkImageFileOpen
+
+  if (count == 0)
+    return;
+
+  if constexpr (std::is_same<SourceT, ustring>::value)
+  {
+    throw E57_EXCEPTION2(E57_ERROR_EXPECTING_NUMERIC, "pathName=" + pathName_);
+  }
+  else
+  {
+    /// Same checks as getNextFloat()/getNextDouble(), done once for the span
+    if (count > capacity_ - nextIndex_)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " count=" + toString(count));
+    if (!std::is_floating_point<SourceT>::value && !doConversion_)
+      throw E57_EXCEPTION2(E57_ERROR_CONVERSION_REQUIRED, "pathName=" + pathName_);
+
+    /// Calc start of memory location, index into buffer using stride_ (the distance between elements).
+    const char* p = &base_[nextIndex_ * stride_];
+
+    /// Doubles outside the double range (i.e. infinite) can't be stored as floats.  The record by record path finds the one to throw for.
+    if constexpr (std::is_same<SourceT, double>::value && std::is_same<FloatT, float>::value)
+    {
+      bool outOfRange = false;
+      for (size_t i = 0; i < count; i++)
+      {
+        const double d = *reinterpret_cast<const double*>(p + i * stride_);
+        outOfRange |= (d < E57_DOUBLE_MIN) | (E57_DOUBLE_MAX < d);
+      }
+      if (outOfRange)
+      {
+        for (size_t i = 0; i < count; i++)
+          values[i] = getNextFloat();
+        return;
+      }
+    }
+
+    /// Same conversions as getNextFloat()/getNextDouble()
+    auto convert = [](const SourceT& value) -> FloatT {
+      if constexpr (std::is_same<SourceT, bool>::value)
+        return (value ? FloatT(1) : FloatT(0));
+      else
+        return (static_cast<FloatT>(value));
+    };
+
+    if (std::is_same<SourceT, FloatT>::value && stride_ == sizeof(FloatT))
+    {
+      memcpy(values, p, count * sizeof(FloatT));
+    }
+    else if (stride_ == sizeof(SourceT))
+    {
+      /// Contiguous, so the compiler can widen or narrow whole vectors at a time
+      const SourceT* source = reinterpret_cast<const SourceT*>(p);
+      for (size_t i = 0; i < count; i++)
+        values[i] = convert(source[i]);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+        values[i] = convert(*reinterpret_cast<const SourceT*>(p + i * stride_));
+    }
+
+    nextIndex_ += static_cast<unsigned>(count);
+  }
+}
+
+template <typename FloatT>
+SourceDestBufferImpl::LoadFloatsFunction<FloatT> SourceDestBufferImpl::loadFloatsKernel()
+{
+  switch (memoryRepresentation_)
+  {
+  case MemoryRepresentation::E57_INT8:
+    return (&SourceDestBufferImpl::loadFloats<int8_t, FloatT>);
+  case MemoryRepresentation::E57_UINT8:
+    return (&SourceDestBufferImpl::loadFloats<uint8_t, FloatT>);
+  case MemoryRepresentation::E57_INT16:
+    return (&SourceDestBufferImpl::loadFloats<int16_t, FloatT>);
+  case MemoryRepresentation::E57_UINT16:
+    return (&SourceDestBufferImpl::loadFloats<uint16_t, FloatT>);
+  case MemoryRepresentation::E57_INT32:
+    return (&SourceDestBufferImpl::loadFloats<int32_t, FloatT>);
+  case MemoryRepresentation::E57_UINT32:
+    return (&SourceDestBufferImpl::loadFloats<uint32_t, FloatT>);
+  case MemoryRepresentation::E57_INT64:
+    return (&SourceDestBufferImpl::loadFloats<int64_t, FloatT>);
+  case MemoryRepresentation::E57_BOOL:
+    return (&SourceDestBufferImpl::loadFloats<bool, FloatT>);
+  case MemoryRepresentation::E57_REAL32:
+    return (&SourceDestBufferImpl::loadFloats<float, FloatT>);
+  case MemoryRepresentation::E57_REAL64:
+    return (&SourceDestBufferImpl::loadFloats<double, FloatT>);
+  case MemoryRepresentation::E57_USTRING:
+    return (&SourceDestBufferImpl::loadFloats<ustring, FloatT>);
+  }
+  throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " memoryRepresentation=" + toString(memoryRepresentation_));
+}
+
+void SourceDestBufferImpl::checkCompatible(std::shared_ptr<SourceDestBufferImpl> newBuf)
+{
+  if (pathName_ != newBuf->pathName())
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "pathName=" + pathName_ + " newPathName=" + newBuf->pathName());
+  }
+  if (memoryRepresentation_ != newBuf->memoryRepresentation())
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE,
+                         "memoryRepresentation=" + toString(memoryRepresentation_) + " newMemoryType=" + toString(newBuf->memoryRepresentation()));
+  }
+  if (capacity_ != newBuf->capacity())
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "capacity=" + toString(capacity_) + " newCapacity=" + toString(newBuf->capacity()));
+  }
+  if (doConversion_ != newBuf->doConversion())
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "doConversion=" + toString(doConversion_) + "newDoConversion=" + toString(newBuf->doConversion()));
+  }
+  if (doConversion_ != newBuf->doConversion())
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "doConversion=" + toString(doConversion_) + " newDoConversion=" + toString(newBuf->doConversion()));
+  }
+  if (stride_ != newBuf->stride())
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BUFFERS_NOT_COMPATIBLE, "stride=" + toString(stride_) + " newStride=" + toString(newBuf->stride()));
+  }
+}
+
+std::shared_ptr<SourceDestBufferImpl> SourceDestBufferImpl::slice(size_t first, size_t count, std::vector<ustring>* strings)
+{
+  if (first > capacity_ || count > capacity_ - first)
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " first=" + toString(first) + " count=" + toString(count) + " capacity=" + toString(capacity_));
+
+  std::shared_ptr<SourceDestBufferImpl> s(new SourceDestBufferImpl(*this));
+  s->capacity_  = count;
+  s->nextIndex_ = 0;
+  if (memoryRepresentation_ == E57_USTRING)
+  {
+    if (strings == nullptr || strings->size() != count)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "pathName=" + pathName_ + " count=" + toString(count));
+    s->ustrings_      = strings;
+    s->base_          = nullptr;
+    s->stringOffsets_ = nullptr;
+    s->charCapacity_  = 0;
+  }
+  else
+    s->base_ = base_ + first * stride_;
+  return (s);
+}
+
+#ifdef E57_DEBUG
+void SourceDestBufferImpl::dump(int indent, ostream& os)
+{
+  /// don't checkImageFileOpen
+
+  os << space(indent) << "pathName:             " << pathName_ << endl;
+  os << space(indent) << "memoryRepresentation: ";
+  switch (memoryRepresentation_)
+  {
+  case MemoryRepresentation::E57_INT8:
+    os << "int8_t" << endl;
+    break;
+  case MemoryRepresentation::E57_UINT8:
+    os << "uint8_t" << endl;
+    break;
+  case MemoryRepresentation::E57_INT16:
+    os << "int16_t" << endl;
+    break;
+  case MemoryRepresentation::E57_UINT16:
+    os << "uint16_t" << endl;
+    break;
+  case MemoryRepresentation::E57_INT32:
+    os << "int32_t" << endl;
+    break;
+  case MemoryRepresentation::E57_UINT32:
+    os << "uint32_t" << endl;
+    break;
+  case MemoryRepresentation::E57_INT64:
+    os << "int64_t" << endl;
+    break;
+  case MemoryRepresentation::E57_BOOL:
+    os << "bool" << endl;
+    break;
+  case MemoryRepresentation::E57_REAL32:
+    os << "float" << endl;
+    break;
+  case MemoryRepresentation::E57_REAL64:
+    os << "double" << endl;
+    break;
+  case MemoryRepresentation::E57_USTRING:
+    os << "ustring" << endl;
+    break;
+  default:
+    os << "<unknown>" << endl;
+    break;
+  }
+  os << space(indent) << "base:                 " << static_cast<const void*>(base_) << endl;
+  os << space(indent) << "ustrings:             " << static_cast<const void*>(ustrings_) << endl;
+  os << space(indent) << "stringOffsets:        " << static_cast<const void*>(stringOffsets_) << endl;
+  os << space(indent) << "charCapacity:         " << charCapacity_ << endl;
+  os << space(indent) << "capacity:             " << capacity_ << endl;
+  os << space(indent) << "doConversion:         " << doConversion_ << endl;
+  os << space(indent) << "doScaling:            " << doScaling_ << endl;
+  os << space(indent) << "stride:               " << stride_ << endl;
+  os << space(indent) << "nextIndex:            " << nextIndex_ << endl;
+}
+#endif
+
+//=============================================================================
+CompressedVectorNodeImpl::CompressedVectorNodeImpl(std::weak_ptr<ImageFileImpl> destImageFile) : NodeImpl(destImageFile)
+{
+  // don't checkImageFileOpen, NodeImpl() will do it
+
+  recordCount_               = 0;
+  binarySectionLogicalStart_ = 0;
+  writerOpen_                = false;
+}
+
+NodeType CompressedVectorNodeImpl::type()
+{
+  // don't checkImageFileOpen
+  return (E57_COMPRESSED_VECTOR);
+}
+
+void CompressedVectorNodeImpl::setPrototype(std::shared_ptr<NodeImpl> prototype)
+{
+  // don't checkImageFileOpen, ctor did it
+
+  //??? check ok for proto, no Blob CompressedVector, empty?
+  //??? throw E57_EXCEPTION2(E57_ERROR_BAD_PROTOTYPE)
+
+  /// Can't set prototype twice.
+  if (prototype_)
+    throw E57_EXCEPTION2(E57_ERROR_SET_TWICE, "this->pathName=" + this->pathName());
+
+  /// prototype can't have a parent (must be a root node)
+  if (!prototype->isRoot())
+  {
+    throw E57_EXCEPTION2(E57_ERROR_ALREADY_HAS_PARENT, "this->pathName=" + this->pathName() + " prototype->pathName=" + prototype->pathName());
+  }
+
+  /// Verify that prototype is destined for same ImageFile as this is
+  std::shared_ptr<ImageFileImpl> thisDest(destImageFile());
+  std::shared_ptr<ImageFileImpl> prototypeDest(prototype->destImageFile());
+  if (thisDest != prototypeDest)
+  {
+    throw E57_EXCEPTION2(E57_ERROR_DIFFERENT_DEST_IMAGEFILE,
+                         "this->destImageFile" + thisDest->fileName() + " prototype->destImageFile" + prototypeDest->fileName());
+  }
+
+  //!!! check for incomplete CompressedVectors when closing file
+  prototype_ = prototype;
+
+  /// Note that prototype is not attached to CompressedVector in a parent/child relationship.
+  /// This means that prototype is a root node (has no parent).
+}
+
+std::shared_ptr<NodeImpl> CompressedVectorNodeImpl::getPrototype()
+{
+  checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
+  return (prototype_); //??? check defined
 }
 
 void CompressedVectorNodeImpl::setCodecs(std::shared_ptr<VectorNodeImpl> codecs)
@@ -2078,8 +2792,9 @@ std::shared_ptr<CompressedVectorWriterImpl> CompressedVectorNodeImpl::writer(vec
 
   std::shared_ptr<ImageFileImpl> destImageFile(destImageFile_);
 
-  /// Check don't have any writers/readers open for this ImageFile
-  if (destImageFile->writerCount() > 0)
+  /// Check don't have a writer open for this CompressedVector, or any readers open for this ImageFile.
+  /// Writers of different CompressedVectors can be open at once, see CompressedVectorSection.
+  if (writerOpen_)
   {
     throw E57_EXCEPTION2(E57_ERROR_TOO_MANY_WRITERS, "fileName=" + destImageFile->fileName() + " writerCount=" + toString(destImageFile->writerCount())
                                                        + " readerCount=" + toString(destImageFile->readerCount()));
@@ -2113,19 +2828,147 @@ std::shared_ptr<CompressedVectorWriterImpl> CompressedVectorNodeImpl::writer(vec
   return (cvwi);
 }
 
-std::shared_ptr<CompressedVectorReaderImpl> CompressedVectorNodeImpl::reader(vector<SourceDestBuffer> dbufs)
+std::shared_ptr<CompressedVectorReaderImpl> CompressedVectorNodeImpl::reader(vector<SourceDestBuffer> dbufs, unsigned cachePacketCount)
+{
+  std::shared_ptr<CompressedVectorNodeImpl> cai = readableSelf(dbufs);
+
+  /// Return a std::shared_ptr to new object
+  std::shared_ptr<CompressedVectorReaderImpl> cvri(new CompressedVectorReaderImpl(cai, dbufs, cachePacketCount));
+  return (cvri);
+}
+
+void CompressedVectorNodeImpl::readParallel(vector<SourceDestBuffer> dbufs, uint64_t firstRecord, uint64_t recordCount, unsigned rangeCount)
+{
+  std::shared_ptr<CompressedVectorNodeImpl> cai = readableSelf(dbufs);
+  std::shared_ptr<ImageFileImpl>            destImageFile(destImageFile_);
+
+  /// Records must exist, and fit in every dbuf
+  uint64_t totalRecordCount = static_cast<uint64_t>(childCount());
+  if (firstRecord > totalRecordCount || recordCount > totalRecordCount - firstRecord)
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "fileName=" + destImageFile->fileName() + " firstRecord=" + toString(firstRecord)
+                                                       + " recordCount=" + toString(recordCount) + " childCount=" + toString(totalRecordCount));
+  }
+  for (unsigned i = 0; i < dbufs.size(); i++)
+  {
+    if (dbufs[i].capacity() < recordCount)
+    {
+      throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "fileName=" + destImageFile->fileName() + " pathName=" + dbufs[i].pathName()
+                                                         + " capacity=" + toString(dbufs[i].capacity()) + " recordCount=" + toString(recordCount));
+    }
+  }
+  if (recordCount == 0)
+    return;
+
+  /// By default use a range per hardware thread, but don't make ranges so short that starting the readers dominates
+  if (rangeCount == 0)
+  {
+    rangeCount = std::max(std::thread::hardware_concurrency(), 1U);
+    rangeCount = static_cast<unsigned>(min(static_cast<uint64_t>(rangeCount), max(recordCount / E57_READ_RANGE_MIN_RECORDS, static_cast<uint64_t>(1))));
+  }
+  rangeCount = static_cast<unsigned>(min(min(static_cast<uint64_t>(rangeCount), recordCount), static_cast<uint64_t>(E57_WORKER_THREADS_MAX)));
+
+  std::vector<uint64_t> rangeStarts(rangeCount + 1);
+  for (unsigned k = 0; k <= rangeCount; k++)
+    rangeStarts[k] = recordCount * k / rangeCount;
+
+  /// Give each range a reader of its own, over its slice of the caller's arrays.  Strings are stored per range, and moved into place at the end.
+  /// Readers are created and positioned on this thread, because that moves the file cursor.
+  std::vector<std::vector<std::vector<ustring>>>           rangeStrings(rangeCount, std::vector<std::vector<ustring>>(dbufs.size()));
+  std::vector<std::unique_ptr<CompressedVectorReaderImpl>> readers;
+  for (unsigned k = 0; k < rangeCount; k++)
+  {
+    size_t                   start = static_cast<size_t>(rangeStarts[k]);
+    size_t                   count = static_cast<size_t>(rangeStarts[k + 1] - rangeStarts[k]);
+    vector<SourceDestBuffer> slices;
+    for (unsigned i = 0; i < dbufs.size(); i++)
+    {
+      std::vector<ustring>* strings = nullptr;
+      if (dbufs[i].memoryRepresentation() == E57_USTRING)
+      {
+        rangeStrings[k][i].resize(count);
+        strings = &rangeStrings[k][i];
+      }
+      slices.push_back(SourceDestBuffer(dbufs[i].impl()->slice(start, count, strings)));
+    }
+
+    readers.emplace_back(new CompressedVectorReaderImpl(cai, slices));
+  }
+
+  /// Strings can only be found by reading the ones before them, so find where each range starts in the string bytestreams in a single pass.
+  /// The other readers take over the chunk index built by the first, so the data packet headers are only scanned once.
+  std::vector<uint64_t> firstRecords(rangeCount);
+  for (unsigned k = 0; k < rangeCount; k++)
+    firstRecords[k] = firstRecord + rangeStarts[k];
+  std::vector<std::vector<uint64_t>> stringOffsets = readers[0]->findStringRecords(firstRecords);
+  for (unsigned k = 0; k < rangeCount; k++)
+  {
+    if (k > 0)
+      readers[k]->shareSeekIndex(*readers[0]);
+
+    std::vector<uint64_t> byteOffsets(stringOffsets.size());
+    for (unsigned i = 0; i < stringOffsets.size(); i++)
+      byteOffsets[i] = stringOffsets[i][k];
+    readers[k]->seek(firstRecords[k], byteOffsets);
+  }
+
+  /// Reading packets doesn't need the file cursor if the file can be read from several threads at once, otherwise read the ranges one after another.
+  auto readRange = [&](size_t k) {
+    unsigned count = readers[k]->read();
+    if (count != rangeStarts[k + 1] - rangeStarts[k])
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "range=" + toString(k) + " count=" + toString(count) + " expected=" + toString(rangeStarts[k + 1] - rangeStarts[k]));
+  };
+  if (destImageFile->file_->canReadConcurrently())
+  {
+    WorkerPool pool(rangeCount);
+    pool.run(rangeCount, readRange);
+  }
+  else
+  {
+    for (unsigned k = 0; k < rangeCount; k++)
+      readRange(k);
+  }
+
+  for (unsigned k = 0; k < rangeCount; k++)
+    readers[k]->close();
+
+  for (unsigned i = 0; i < dbufs.size(); i++)
+  {
+    if (dbufs[i].memoryRepresentation() != E57_USTRING)
+      continue;
+    std::shared_ptr<SourceDestBufferImpl> dbuf    = dbufs[i].impl();
+    std::vector<ustring>*                 strings = dbuf->ustrings();
+    if (strings != nullptr)
+    {
+      for (unsigned k = 0; k < rangeCount; k++)
+        std::move(rangeStrings[k][i].begin(), rangeStrings[k][i].end(), strings->begin() + static_cast<ptrdiff_t>(rangeStarts[k]));
+      continue;
+    }
+
+    /// Where a string goes in a char array depends on all the ones before it, so they are packed in order
+    dbuf->rewind();
+    for (unsigned k = 0; k < rangeCount; k++)
+    {
+      for (const ustring& s : rangeStrings[k][i])
+        dbuf->setNextString(s);
+    }
+  }
+}
+
+std::shared_ptr<CompressedVectorNodeImpl> CompressedVectorNodeImpl::readableSelf(const vector<SourceDestBuffer>& dbufs)
 {
   checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
 
   std::shared_ptr<ImageFileImpl> destImageFile(destImageFile_);
 
-  /// Check don't have any writers/readers open for this ImageFile
+  /// Check don't have any writers open for this ImageFile.
+  /// Readers of a file that can be read from several threads at once don't use the file cursor, so any number of them can be open, otherwise only one.
   if (destImageFile->writerCount() > 0)
   {
     throw E57_EXCEPTION2(E57_ERROR_TOO_MANY_WRITERS, "fileName=" + destImageFile->fileName() + " writerCount=" + toString(destImageFile->writerCount())
                                                        + " readerCount=" + toString(destImageFile->readerCount()));
   }
-  if (destImageFile->readerCount() > 0)
+  if (destImageFile->readerCount() > 0 && !destImageFile->file_->canReadConcurrently())
   {
     throw E57_EXCEPTION2(E57_ERROR_TOO_MANY_READERS, "fileName=" + destImageFile->fileName() + " writerCount=" + toString(destImageFile->writerCount())
                                                        + " readerCount=" + toString(destImageFile->readerCount()));
@@ -2154,9 +2997,7 @@ std::shared_ptr<CompressedVectorReaderImpl> CompressedVectorNodeImpl::reader(vec
   // cout<<"constructing CAReader, cai:"<<endl;
   // cai->dump(4);
 #endif
-  /// Return a std::shared_ptr to new object
-  std::shared_ptr<CompressedVectorReaderImpl> cvri(new CompressedVectorReaderImpl(cai, dbufs));
-  return (cvri);
+  return (cai);
 }
 
 //=====================================================================
@@ -2846,8 +3687,18 @@ void BlobNodeImpl::read(uint8_t* buf, int64_t start, size_t count)
                                                        + " length=" + toString(blobLogicalLength_));
   }
   std::shared_ptr<ImageFileImpl> imf(destImageFile_);
-  imf->file_->seek(binarySectionLogicalStart_ + sizeof(BlobSectionHeader) + start);
-  imf->file_->read(reinterpret_cast<char*>(buf), static_cast<size_t>(count)); //??? arg1 void* ?
+  uint64_t                       logicalOffset = binarySectionLogicalStart_ + sizeof(BlobSectionHeader) + start;
+  if (imf->file_->canReadConcurrently())
+  {
+    /// Leave the file cursor alone, CompressedVectorReaders may be reading on other threads
+    std::vector<char> pageBuffer;
+    imf->file_->readAt(logicalOffset, reinterpret_cast<char*>(buf), count, pageBuffer);
+  }
+  else
+  {
+    imf->file_->seek(logicalOffset);
+    imf->file_->read(reinterpret_cast<char*>(buf), static_cast<size_t>(count)); //??? arg1 void* ?
+  }
 }
 
 void BlobNodeImpl::write(uint8_t* buf, int64_t start, size_t count)
@@ -3350,13 +4201,15 @@ bool E57XmlParser::isAttributeDefined(const std::vector<std::pair<std::string, s
 //=============================================================================
 //=============================================================================
 
-ImageFileImpl::ImageFileImpl() : writerCount_(0), readerCount_(0), file_(nullptr)
+ImageFileImpl::ImageFileImpl()
+: writerCount_(0), readerCount_(0), useMemoryMap_(false), prefetchPacketCount_(0), encoderThreadCount_(1), decoderThreadCount_(1), writeQueueCount_(0), file_(nullptr),
+  tailSection_(nullptr)
 {
   /// First phase of construction, can't do much until have the ImageFile object.
   /// See ImageFileImpl::construct2() for second phase.
 }
 
-void ImageFileImpl::construct2(const ustring& fileName, const ustring& mode, const ustring& /*configuration*/)
+void ImageFileImpl::construct2(const ustring& fileName, const ustring& mode, const ustring& configuration)
 {
   /// Second phase of construction, now we have a well-formed ImageFile object.
 
@@ -3385,6 +4238,8 @@ void ImageFileImpl::construct2(const ustring& fileName, const ustring& mode, con
   else
     throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "mode=" + ustring(mode));
 
+  parseConfiguration(configuration);
+
   /// If mode is read, do it
   file_ = nullptr;
   if (!isWriter_)
@@ -3392,7 +4247,7 @@ void ImageFileImpl::construct2(const ustring& fileName, const ustring& mode, con
     try
     { //??? should one try block cover whole function?
       /// Open file for reading.
-      file_ = std::make_unique<CheckedFile>(fileName_, CheckedFile::readOnly);
+      file_ = std::make_unique<CheckedFile>(fileName_, useMemoryMap_ ? CheckedFile::readOnlyMapped : CheckedFile::readOnly);
 
       std::shared_ptr<StructureNodeImpl> root(new StructureNodeImpl(imf)); // Added by SC
       root_ = root;
@@ -3438,6 +4293,7 @@ void ImageFileImpl::construct2(const ustring& fileName, const ustring& mode, con
     {
       /// Open file for writing, truncate if already exists.
       file_ = std::make_unique<CheckedFile>(fileName_, CheckedFile::writeCreate);
+      file_->startWriteQueue(writeQueueCount_);
 
       std::shared_ptr<StructureNodeImpl> root(new StructureNodeImpl(imf)); // Added by SC
       root_ = root;
@@ -3456,6 +4312,57 @@ void ImageFileImpl::construct2(const ustring& fileName, const ustring& mode, con
   }
 }
 
+void ImageFileImpl::parseConfiguration(const ustring& configuration)
+{
+  /// The configuration string is a list of options separated by white space, commas or semicolons.
+  /// Each option is either a bare name or name=value.
+  /// Recognized options:
+  ///     mmap          read mode only: read the file through a memory mapping instead of read() calls, if the platform supports it
+  ///     prefetch=N    read mode only: CompressedVectorReaders read N data packets ahead of the decoders on a worker thread
+  ///     encoders=N    write mode only: CompressedVectorWriters encode their bytestreams on N threads
+  ///     decoders=N    read mode only: CompressedVectorReaders decode their bytestreams on N threads
+  ///     writequeue=N  write mode only: CompressedVectorWriters queue up to N data packets for an I/O thread to write
+  static const char* separators = " \t\r\n,;";
+
+  size_t pos = 0;
+  while ((pos = configuration.find_first_not_of(separators, pos)) != ustring::npos)
+  {
+    size_t end = configuration.find_first_of(separators, pos);
+    if (end == ustring::npos)
+      end = configuration.length();
+    ustring option = configuration.substr(pos, end - pos);
+    pos            = end;
+
+    ustring name = option;
+    size_t  eq   = option.find('=');
+    if (eq != ustring::npos)
+      name = option.substr(0, eq);
+
+    /// Value of a name=N option, which must be a decimal number from 1 to maximum
+    auto countValue = [&](unsigned long maximum) {
+      ustring       value = option.substr(eq + 1);
+      char*         end   = nullptr;
+      unsigned long count = strtoul(value.c_str(), &end, 10);
+      if (value.empty() || *end != '\0' || count == 0 || count > maximum)
+        throw E57_EXCEPTION2(E57_ERROR_BAD_CONFIGURATION, "fileName=" + fileName_ + " option=" + option + " configuration=" + configuration);
+      return (static_cast<unsigned>(count));
+    };
+
+    if (name == "mmap" && eq == ustring::npos)
+      useMemoryMap_ = true;
+    else if (name == "prefetch" && eq != ustring::npos)
+      prefetchPacketCount_ = countValue(E57_PACKET_CACHE_MAX);
+    else if (name == "encoders" && eq != ustring::npos)
+      encoderThreadCount_ = countValue(E57_WORKER_THREADS_MAX);
+    else if (name == "decoders" && eq != ustring::npos)
+      decoderThreadCount_ = countValue(E57_WORKER_THREADS_MAX);
+    else if (name == "writequeue" && eq != ustring::npos)
+      writeQueueCount_ = countValue(E57_WRITE_QUEUE_MAX);
+    else
+      throw E57_EXCEPTION2(E57_ERROR_BAD_CONFIGURATION, "fileName=" + fileName_ + " option=" + option + " configuration=" + configuration);
+  }
+}
+
 void ImageFileImpl::readFileHeader(CheckedFile* file, E57FileHeader& header)
 {
 #ifdef E57_DEBUG
@@ -3510,11 +4417,11 @@ void ImageFileImpl::incrWriterCount()
 
 void ImageFileImpl::decrWriterCount()
 {
-  writerCount_--;
+  int writerCount = --writerCount_;
 #ifdef E57_MAX_DEBUG
-  if (writerCount_ < 0)
+  if (writerCount < 0)
   {
-    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "fileName=" + fileName_ + " writerCount=" + toString(writerCount_) + " readerCount=" + toString(readerCount_));
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "fileName=" + fileName_ + " writerCount=" + toString(writerCount) + " readerCount=" + toString(readerCount()));
   }
 #endif
 }
@@ -3526,15 +4433,35 @@ void ImageFileImpl::incrReaderCount()
 
 void ImageFileImpl::decrReaderCount()
 {
-  readerCount_--;
+  int readerCount = --readerCount_;
 #ifdef E57_MAX_DEBUG
-  if (readerCount_ < 0)
+  if (readerCount < 0)
   {
-    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "fileName=" + fileName_ + " writerCount=" + toString(writerCount_) + " readerCount=" + toString(readerCount_));
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "fileName=" + fileName_ + " writerCount=" + toString(writerCount()) + " readerCount=" + toString(readerCount));
   }
 #endif
 }
 
+void ImageFileImpl::addReadAheadCache(PacketReadCache* cache)
+{
+  std::lock_guard<std::mutex> guard(readAheadMutex_);
+  readAheadCaches_.push_back(cache);
+}
+
+void ImageFileImpl::removeReadAheadCache(PacketReadCache* cache)
+{
+  std::lock_guard<std::mutex> guard(readAheadMutex_);
+  readAheadCaches_.erase(std::remove(readAheadCaches_.begin(), readAheadCaches_.end(), cache), readAheadCaches_.end());
+}
+
+void ImageFileImpl::stopReadAhead()
+{
+  /// Readers left open may still be reading ahead of their last read(), make them finish before the file goes away
+  std::lock_guard<std::mutex> guard(readAheadMutex_);
+  for (PacketReadCache* cache : readAheadCaches_)
+    cache->stopPrefetch();
+}
+
 std::shared_ptr<StructureNodeImpl> ImageFileImpl::root()
 {
   checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
@@ -3593,6 +4520,7 @@ void ImageFileImpl::close()
     file_->close();
   }
 
+  stopReadAhead();
   file_.reset();
 }
 
@@ -3602,6 +4530,8 @@ void ImageFileImpl::cancel()
   if (!file_)
     return;
 
+  stopReadAhead();
+
   /// Close the file and ulink (delete) it.
   /// It is legal to cancel a read file, but file isn't deleted.
   if (isWriter_)
@@ -3993,8 +4923,8 @@ void ImageFileImpl::dump(int indent, ostream& os)
 {
   /// no checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__)
   os << space(indent) << "fileName:    " << fileName_ << endl;
-  os << space(indent) << "writerCount: " << writerCount_ << endl;
-  os << space(indent) << "readerCount: " << readerCount_ << endl;
+  os << space(indent) << "writerCount: " << writerCount_.load() << endl;
+  os << space(indent) << "readerCount: " << readerCount_.load() << endl;
   os << space(indent) << "isWriter:    " << isWriter_ << endl;
   for (size_t i = 0; i < extensionsCount(); i++)
     os << space(indent) << "nameSpace[" << i << "]: prefix=" << extensionsPrefix(i) << " uri=" << extensionsUri(i) << endl;
@@ -4104,15 +5034,28 @@ const size_t   CheckedFile::physicalPageSizeLog2 = 10; // physical page size is
 const size_t   CheckedFile::physicalPageSize     = 1 << physicalPageSizeLog2;
 const uint64_t CheckedFile::physicalPageSizeMask = physicalPageSize - 1;
 const size_t   CheckedFile::logicalPageSize      = physicalPageSize - 4;
+const size_t   CheckedFile::readBatchPages       = 1024; // 1 MB of physical pages per read call
+const size_t   CheckedFile::writeCachePages      = 1024; // flush write cache when it holds 1 MB of dirty pages
 
-CheckedFile::CheckedFile(ustring fileName, Mode mode) : fileName_(fileName), fd_(-1)
+CheckedFile::CheckedFile(ustring fileName, Mode mode)
+: fileName_(fileName), fd_(-1), position_(0), fileLength_(0), map_(nullptr), mapLength_(0), writeQueueSize_(0), stopQueue_(false)
 {
+  /// All reads and writes are at explicit offsets, so the cursor is kept in position_ and the fd's own offset is not used
   switch (mode)
   {
   case readOnly:
     fd_            = open64(fileName_, O_RDONLY | O_BINARY, 0);
     readOnly_      = true;
-    logicalLength_ = physicalToLogical(length(physical));
+    fileLength_    = lseek64(0LL, SEEK_END);
+    logicalLength_ = physicalToLogical(fileLength_);
+    break;
+  case readOnlyMapped:
+    fd_            = open64(fileName_, O_RDONLY | O_BINARY, 0);
+    readOnly_      = true;
+    fileLength_    = lseek64(0LL, SEEK_END);
+    logicalLength_ = physicalToLogical(fileLength_);
+    /// If can't map, stay with the readOnly code path
+    mapFile();
     break;
   case writeCreate:
     /// File truncated to zero length if already exists
@@ -4123,7 +5066,8 @@ CheckedFile::CheckedFile(ustring fileName, Mode mode) : fileName_(fileName), fd_
   case writeExisting:
     fd_            = open64(fileName_, O_RDWR | O_BINARY, 0);
     readOnly_      = false;
-    logicalLength_ = physicalToLogical(length(physical)); //???
+    fileLength_    = lseek64(0LL, SEEK_END);
+    logicalLength_ = physicalToLogical(fileLength_); //???
     break;
   }
 }
@@ -4169,37 +5113,73 @@ void CheckedFile::read(char* buf, size_t nRead, size_t /*bufSize*/)
   //??? what if read past logical end?, or physical end?
   //??? need to keep track of logical length?
   //??? check bufSize OK
+  waitForQueuedWrites();
 
 #ifdef SAFE_MODE
-  uint64_t end = position(logical) + nRead;
+  uint64_t start = position(logical);
+  uint64_t end   = start + nRead;
 
   if (end > length(logical))
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "fileName=" + fileName_ + " end=" + toString(end) + " length=" + toString(length(logical)));
 
-  uint64_t page;
-  size_t   pageOffset;
-  getCurrentPageAndOffset(page, pageOffset);
+  if (map_ != nullptr)
+  {
+    readMapped(buf, nRead);
+    return;
+  }
 
-  size_t n = min(nRead, logicalPageSize - pageOffset);
+  readPages(start, buf, nRead, readBuffer_);
+
+  /// When done, leave cursor just past end of last byte read
+  seek(end, logical);
+#endif // SAFE_MODE
+}
 
-  /// Allocate temp page buffer
-  vector<char> page_buffer_v(physicalPageSize);
-  char*        page_buffer = &page_buffer_v[0];
+bool CheckedFile::canReadConcurrently()
+{
+  /// Positioned reads don't share the cursor, and a read only file has no write cache to consult.
+#if defined(SAFE_MODE) && defined(E57_HAVE_PREAD)
+  return (readOnly_);
+#else
+  return (readOnly_ && map_ != nullptr);
+#endif
+}
+
+void CheckedFile::readAt(uint64_t logicalOffset, char* buf, size_t nRead, std::vector<char>& pageBuffer)
+{
+  /// Like read(), but at the given offset, without moving the cursor or touching any other state of the object.
+  /// Only safe to call from several threads at once if canReadConcurrently() is true.
+  if (!canReadConcurrently())
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "fileName=" + fileName_);
+
+#ifdef SAFE_MODE
+  uint64_t end = logicalOffset + nRead;
+  if (end > length(logical))
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "fileName=" + fileName_ + " end=" + toString(end) + " length=" + toString(length(logical)));
 
-  while (nRead > 0)
+  if (map_ != nullptr)
   {
-    readPhysicalPage(page_buffer, page);
-    memcpy(buf, page_buffer + pageOffset, n);
+    /// Verify each page here rather than in mapPageVerified_, which belongs to the thread using the cursor
+    uint64_t page       = logicalOffset / logicalPageSize;
+    size_t   pageOffset = static_cast<size_t>(logicalOffset - page * logicalPageSize);
+    while (nRead > 0)
+    {
+      if ((page + 1) * physicalPageSize > mapLength_)
+        throw E57_EXCEPTION2(E57_ERROR_READ_FAILED, "fileName=" + fileName_ + " page=" + toString(page) + " length=" + toString(mapLength_));
+      verifyPageChecksum(map_ + page * physicalPageSize, page);
 
-    buf += n;
-    nRead -= n;
-    pageOffset = 0;
-    page++;
-    n = min(nRead, logicalPageSize);
+      size_t n = min(nRead, logicalPageSize - pageOffset);
+      memcpy(buf, map_ + page * physicalPageSize + pageOffset, n);
+
+      buf += n;
+      nRead -= n;
+      pageOffset = 0;
+      page++;
+    }
+    return;
   }
 
-  /// When done, leave cursor just past end of last byte read
-  seek(end, logical);
+  readPages(logicalOffset, buf, nRead, pageBuffer);
 #endif // SAFE_MODE
 }
 
@@ -4210,47 +5190,10 @@ void CheckedFile::write(const char* buf, size_t nWrite)
 #endif
   if (readOnly_)
     throw E57_EXCEPTION2(E57_ERROR_FILE_IS_READ_ONLY, "fileName=" + fileName_);
+  waitForQueuedWrites();
 
 #ifdef SAFE_MODE
-  uint64_t end = position(logical) + nWrite;
-
-  uint64_t page;
-  size_t   pageOffset;
-  getCurrentPageAndOffset(page, pageOffset);
-
-  size_t n = min(nWrite, logicalPageSize - pageOffset);
-
-  /// Allocate temp page buffer
-  vector<char> page_buffer_v(physicalPageSize);
-  char*        page_buffer = &page_buffer_v[0];
-
-  while (nWrite > 0)
-  {
-    readPhysicalPage(page_buffer, page);
-#  ifdef E57_MAX_VERBOSE
-    // cout << "  page_buffer[0] read: '" << page_buffer[0] << "'" << endl;
-    // cout << "copy " << n << "bytes to page=" << page << " pageOffset=" << pageOffset << " buf='"; //???
-    for (size_t i = 0; i < n; i++)
-    // cout << buf[i];
-    // cout << "'" << endl;
-#  endif
-      memcpy(page_buffer + pageOffset, buf, n);
-    writePhysicalPage(page_buffer, page);
-#  ifdef E57_MAX_VERBOSE
-    // cout << "  page_buffer[0] after write: '" << page_buffer[0] << "'" << endl; //???
-#  endif
-    buf += n;
-    nWrite -= n;
-    pageOffset = 0;
-    page++;
-    n = min(nWrite, logicalPageSize);
-  }
-
-  if (end > logicalLength_)
-    logicalLength_ = end;
-
-  /// When done, leave cursor just past end of buf
-  seek(end, logical);
+  writeCached(buf, nWrite);
 #endif // SAFE_MODE
 }
 
@@ -4346,6 +5289,8 @@ CheckedFile& CheckedFile::writeFloatingPoint(FTYPE value, int precision)
 
 void CheckedFile::seek(uint64_t offset, OffsetMode omode)
 {
+  waitForQueuedWrites();
+
 #ifdef SAFE_MODE
   //??? check for seek beyond logicalLength_
   int64_t pos = static_cast<int64_t>(omode == physical ? offset : logicalToPhysical(offset));
@@ -4353,7 +5298,9 @@ void CheckedFile::seek(uint64_t offset, OffsetMode omode)
 #  ifdef E57_MAX_VERBOSE
   // cout << "seek offset=" << offset << " omode=" << omode << " pos=" << pos << endl; //???
 #  endif
-  lseek64(pos, SEEK_SET);
+  if (pos < 0)
+    throw E57_EXCEPTION2(E57_ERROR_LSEEK_FAILED, "fileName=" + fileName_ + " offset=" + toString(offset) + " pos=" + toString(pos));
+  position_ = static_cast<uint64_t>(pos);
 #endif
 }
 
@@ -4388,9 +5335,11 @@ uint64_t CheckedFile::lseek64(int64_t offset, int whence)
 
 uint64_t CheckedFile::position(OffsetMode omode)
 {
+  waitForQueuedWrites();
+
 #ifdef SAFE_MODE
   /// Get current file cursor position
-  uint64_t pos = lseek64(0LL, SEEK_CUR);
+  uint64_t pos = position_;
 
   if (omode == physical)
     return (pos);
@@ -4401,19 +5350,16 @@ uint64_t CheckedFile::position(OffsetMode omode)
 
 uint64_t CheckedFile::length(OffsetMode omode)
 {
+  waitForQueuedWrites();
+
 #ifdef SAFE_MODE
   if (omode == physical)
   {
-    //??? is there a 64bit length call?
-    /// Get current file cursor position
-    uint64_t original_pos = lseek64(0LL, SEEK_CUR);
-
-    /// Get current file cursor position
-    uint64_t end_pos = lseek64(0LL, SEEK_END);
-
-    /// Restore original position
-    lseek64(original_pos, SEEK_SET);
-
+    /// Only this object writes to the file, so fileLength_ tracks what is on disk.
+    /// Include pages still waiting in the write cache.
+    uint64_t end_pos = fileLength_;
+    if (!writeCache_.empty())
+      end_pos = max(end_pos, (writeCache_.rbegin()->first + 1) * physicalPageSize);
     return (end_pos);
   }
   else
@@ -4428,6 +5374,7 @@ void CheckedFile::extend(uint64_t newLength, OffsetMode omode)
 #endif
   if (readOnly_)
     throw E57_EXCEPTION2(E57_ERROR_FILE_IS_READ_ONLY, "fileName=" + fileName_);
+  waitForQueuedWrites();
 
 #ifdef SAFE_MODE
   uint64_t newLogicalLength;
@@ -4448,64 +5395,41 @@ void CheckedFile::extend(uint64_t newLength, OffsetMode omode)
   /// Calc how may zero bytes we have to add to end
   uint64_t nWrite = newLogicalLength - currentLogicalLength;
 
-  /// Seek to current end of file
+  /// Seek to current end of file, and append zeros.
+  /// Leaves cursor at end of file.
   seek(currentLogicalLength, logical);
-
-  uint64_t page;
-  size_t   pageOffset;
-  getCurrentPageAndOffset(page, pageOffset);
-
-  /// Calc first write size (may be partial page)
-  /// Watch out for different int sizes here.
-  size_t n;
-  if (nWrite < logicalPageSize - pageOffset)
-    n = static_cast<size_t>(nWrite);
-  else
-    n = logicalPageSize - pageOffset;
-
-  /// Allocate temp page buffer
-  vector<char> page_buffer_v(physicalPageSize);
-  char*        page_buffer = &page_buffer_v[0];
-
-  while (nWrite > 0)
-  {
-    readPhysicalPage(page_buffer, page);
-#  ifdef E57_MAX_VERBOSE
-    // cout << "extend " << n << "bytes on page=" << page << " pageOffset=" << pageOffset << endl; //???
-#  endif
-    memset(page_buffer + pageOffset, 0, n);
-    writePhysicalPage(page_buffer, page);
-
-    nWrite -= n;
-    pageOffset = 0;
-    page++;
-
-    if (nWrite < logicalPageSize)
-      n = static_cast<size_t>(nWrite);
-    else
-      n = logicalPageSize;
-  }
-
-  //??? what if loop above throws, logicalLength_ may be wrong
-  logicalLength_ = newLogicalLength;
-
-  /// When done, leave cursor at end of file
-  seek(newLogicalLength, logical);
+  writeCached(nullptr, nWrite);
 #endif // SAFE_MODE
 }
 
 void CheckedFile::flush()
 {
+  waitForQueuedWrites();
+
 #ifdef SAFE_MODE
-  /// Nothing to do
+  flushWriteCache(false);
 #endif // SAFE_MODE
 }
 
 void CheckedFile::close()
 {
+  /// Finish the queued writes before the write cache is flushed, and report the first one that failed
+  stopWriteQueue();
+  if (queueError_)
+  {
+    std::exception_ptr error = queueError_;
+    queueError_              = nullptr;
+    std::rethrow_exception(error);
+  }
+
+  unmapFile();
+
   if (fd_ >= 0)
   {
-#ifndef SAFE_MODE
+#ifdef SAFE_MODE
+    flushWriteCache(false);
+#else
+
     if (currentPageDirty_)
       finishPage();
 #endif // SAFE_MODE
@@ -4524,6 +5448,15 @@ void CheckedFile::close()
 
 void CheckedFile::unlink()
 {
+  /// File is going away, so errors of queued writes don't matter
+  stopWriteQueue();
+  queueError_ = nullptr;
+
+  unmapFile();
+
+  /// File is going away, so drop any unwritten pages
+  writeCache_.clear();
+
   if (fd_ >= 0)
   {
 #if defined(_MSC_VER)
@@ -4542,6 +5475,137 @@ void CheckedFile::unlink()
   ::_unlink(fileName_.c_str()); //??? unicode support here
 }
 
+void CheckedFile::startWriteQueue(unsigned bufferCount)
+{
+  if (readOnly_)
+    throw E57_EXCEPTION2(E57_ERROR_FILE_IS_READ_ONLY, "fileName=" + fileName_);
+  if (bufferCount == 0 || queueThread_.joinable())
+    return;
+
+  writeQueueSize_ = bufferCount;
+  queueThread_    = std::thread(&CheckedFile::writeQueueWorker, this);
+}
+
+std::vector<char> CheckedFile::writeQueueBuffer()
+{
+  /// A buffer for the next writeQueued(), waiting for room in the queue so the caller can't get more than writeQueueSize_ writes ahead of the file.
+  /// Buffers come back from the I/O thread with their old size and contents.
+  std::vector<char> buffer;
+  if (writeQueueSize_ == 0)
+    return (buffer);
+
+  std::unique_lock<std::mutex> guard(queueMutex_);
+  queueChanged_.wait(guard, [this] { return writeQueue_.size() < writeQueueSize_; });
+  if (!freeQueueBuffers_.empty())
+  {
+    buffer.swap(freeQueueBuffers_.back());
+    freeQueueBuffers_.pop_back();
+  }
+  return (buffer);
+}
+
+void CheckedFile::writeQueued(uint64_t logicalOffset, std::vector<char>&& buffer, size_t nWrite)
+{
+  /// Write the first nWrite bytes of buffer at logicalOffset, on the I/O thread if the queue is started.
+  /// Either way the cursor doesn't move.
+  if (readOnly_)
+    throw E57_EXCEPTION2(E57_ERROR_FILE_IS_READ_ONLY, "fileName=" + fileName_);
+  if (nWrite > buffer.size())
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "fileName=" + fileName_ + " nWrite=" + toString(nWrite) + " bufferSize=" + toString(buffer.size()));
+
+  if (writeQueueSize_ == 0)
+  {
+    uint64_t position = position_;
+    seek(logicalOffset);
+    write(buffer.data(), nWrite);
+    position_ = position;
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(queueMutex_);
+
+  /// Report a failed write as soon as possible, the file is broken anyway
+  if (queueError_)
+  {
+    std::exception_ptr error = queueError_;
+    queueError_              = nullptr;
+    std::rethrow_exception(error);
+  }
+
+  writeQueue_.push_back(QueuedWrite{logicalOffset, std::move(buffer), nWrite});
+  queueChanged_.notify_all();
+}
+
+void CheckedFile::waitForQueuedWrites()
+{
+  /// The I/O thread calls the other functions to do the queued writes, it mustn't wait for itself
+  if (writeQueueSize_ == 0 || std::this_thread::get_id() == queueThread_.get_id())
+    return;
+
+  std::unique_lock<std::mutex> guard(queueMutex_);
+  queueChanged_.wait(guard, [this] { return writeQueue_.empty(); });
+  if (queueError_)
+  {
+    std::exception_ptr error = queueError_;
+    queueError_              = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void CheckedFile::stopWriteQueue()
+{
+  /// Let the I/O thread finish the writes already queued, later ones go straight to the file
+  if (!queueThread_.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> guard(queueMutex_);
+    stopQueue_ = true;
+  }
+  queueChanged_.notify_all();
+  queueThread_.join();
+  writeQueueSize_ = 0;
+}
+
+void CheckedFile::writeQueueWorker()
+{
+  /// Do the writes in the order they were queued.  A write stays at the front of writeQueue_ until done, so an empty queue means the thread is idle.
+  std::unique_lock<std::mutex> guard(queueMutex_);
+  while (true)
+  {
+    queueChanged_.wait(guard, [this] { return stopQueue_ || !writeQueue_.empty(); });
+    if (writeQueue_.empty())
+      return;
+
+    QueuedWrite& job  = writeQueue_.front();
+    bool         skip = (queueError_ != nullptr);
+    guard.unlock();
+
+    std::exception_ptr error;
+    if (!skip)
+    {
+      uint64_t position = position_;
+      try
+      {
+        seek(job.logicalOffset);
+        write(job.buffer.data(), job.nWrite);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+      position_ = position;
+    }
+
+    guard.lock();
+    if (error)
+      queueError_ = error;
+    freeQueueBuffers_.push_back(std::move(job.buffer));
+    writeQueue_.pop_front();
+    queueChanged_.notify_all();
+  }
+}
+
 size_t CheckedFile::efficientBufferSize(size_t logicalBytes)
 {
 #ifdef SAFE_MODE
@@ -4549,9 +5613,84 @@ size_t CheckedFile::efficientBufferSize(size_t logicalBytes)
 #endif // SAFE_MODE
 }
 
+void CheckedFile::mapFile()
+{
+#ifdef E57_HAVE_MMAP
+  uint64_t len = fileLength_;
+
+  /// Can't map an empty file, or one bigger than the address space, leave map_ null and use read() calls instead
+  if (len == 0 || len > static_cast<uint64_t>(SIZE_MAX))
+    return;
+
+  void* p = ::mmap(nullptr, static_cast<size_t>(len), PROT_READ, MAP_SHARED, fd_, 0);
+  if (p == MAP_FAILED)
+    return;
+
+  map_       = static_cast<char*>(p);
+  mapLength_ = len;
+
+  /// Each page checksum is verified once, the first time any of its bytes are read
+  mapPageVerified_.assign(static_cast<size_t>((len + physicalPageSize - 1) >> physicalPageSizeLog2), false);
+#endif
+}
+
+void CheckedFile::unmapFile()
+{
+#ifdef E57_HAVE_MMAP
+  if (map_ != nullptr)
+  {
+    ::munmap(map_, static_cast<size_t>(mapLength_));
+    map_       = nullptr;
+    mapLength_ = 0;
+    mapPageVerified_.clear();
+  }
+#endif
+}
+
+void CheckedFile::readMapped(char* buf, size_t nRead)
+{
+  uint64_t end = position(logical) + nRead;
+
+  uint64_t page;
+  size_t   pageOffset;
+  getCurrentPageAndOffset(page, pageOffset);
+
+  size_t n = min(nRead, logicalPageSize - pageOffset);
+
+  /// Copy logical bytes straight out of the mapping, skipping the checksum at the end of each page
+  while (nRead > 0)
+  {
+    verifyMappedPage(page);
+    memcpy(buf, map_ + page * physicalPageSize + pageOffset, n);
+
+    buf += n;
+    nRead -= n;
+    pageOffset = 0;
+    page++;
+    n = min(nRead, logicalPageSize);
+  }
+
+  /// When done, leave cursor just past end of last byte read
+  seek(end, logical);
+}
+
+void CheckedFile::verifyMappedPage(uint64_t page)
+{
+  /// Page must be completely inside the file, same as a full size read() in readPhysicalPage
+  if ((page + 1) * physicalPageSize > mapLength_)
+    throw E57_EXCEPTION2(E57_ERROR_READ_FAILED, "fileName=" + fileName_ + " page=" + toString(page) + " length=" + toString(mapLength_));
+
+  if (mapPageVerified_[static_cast<size_t>(page)])
+    return;
+
+  verifyPageChecksum(map_ + page * physicalPageSize, page);
+  mapPageVerified_[static_cast<size_t>(page)] = true;
+}
+
 uint32_t CheckedFile::checksum(char* buf, size_t size)
 {
-  std::uint32_t crc = CRC::Calculate(buf, size, CRC32C_LOOKUP_TABLE);
+  /// Dispatches to hardware CRC32C instructions if the CPU has them, table driven otherwise
+  std::uint32_t crc = utils::crc32c(buf, size);
   swab(crc); //!!! inside BIGENDIAN?
   return crc;
 }
@@ -4573,64 +5712,237 @@ void CheckedFile::getCurrentPageAndOffset(uint64_t& page, size_t& pageOffset, Of
   }
 }
 
+void CheckedFile::readPages(uint64_t start, char* buf, size_t nRead, std::vector<char>& pageBuffer)
+{
+  uint64_t page       = start / logicalPageSize;
+  size_t   pageOffset = static_cast<size_t>(start - page * logicalPageSize);
+
+  /// Read all the physical pages covering the logical range in batches of up to readBatchPages, one read call per batch.
+  /// Check the checksums of the whole batch, then strip them while copying the logical bytes to buf.
+  while (nRead > 0)
+  {
+    size_t pageCount = static_cast<size_t>(min<uint64_t>((pageOffset + nRead + logicalPageSize - 1) / logicalPageSize, readBatchPages));
+    if (pageBuffer.size() < pageCount * physicalPageSize)
+      pageBuffer.resize(pageCount * physicalPageSize);
+
+    size_t nBytes = readPhysicalBytes(&pageBuffer[0], pageCount * physicalPageSize, page * physicalPageSize);
+
+    for (size_t i = 0; i < pageCount; i++)
+    {
+      char* page_buffer = &pageBuffer[i * physicalPageSize];
+
+      /// Pages not yet flushed from the write cache are newer than what is in the file, and don't have checksums yet
+      auto cached = writeCache_.empty() ? writeCache_.end() : writeCache_.find(page + i);
+      if (cached != writeCache_.end())
+        page_buffer = &cached->second[0];
+      else if ((i + 1) * physicalPageSize <= nBytes)
+        verifyPageChecksum(page_buffer, page + i);
+      else if (i * physicalPageSize >= nBytes)
+        memset(page_buffer, 0, physicalPageSize); /// If beyond end of file, just return blank page (same as readPhysicalPage)
+      else
+        throw E57_EXCEPTION2(E57_ERROR_READ_FAILED, "fileName=" + fileName_ + " result=" + toString(nBytes) + " page=" + toString(page + i));
+
+      size_t n = min(nRead, logicalPageSize - pageOffset);
+      memcpy(buf, page_buffer + pageOffset, n);
+
+      buf += n;
+      nRead -= n;
+      pageOffset = 0;
+    }
+    page += pageCount;
+  }
+}
+
 void CheckedFile::readPhysicalPage(char* page_buffer, uint64_t page)
 {
 #  ifdef E57_MAX_VERBOSE
   // cout << "readPhysicalPage, page:" << page << endl;
 #  endif
 
-  if (page * physicalPageSize >= length(physical))
+  if (page * physicalPageSize >= fileLength_)
   {
     /// If beyond end of file, just return blank buffer  ???sure isn't partially beyond end?
     memset(page_buffer, 0, physicalPageSize);
   }
   else
   {
-    /// Seek to start of physical page
-    seek(page * physicalPageSize, physical);
+    size_t result = readPhysicalBytes(page_buffer, physicalPageSize, page * physicalPageSize);
+    if (result != physicalPageSize)
+      throw E57_EXCEPTION2(E57_ERROR_READ_FAILED, "fileName=" + fileName_ + " result=" + toString(result));
+
+    verifyPageChecksum(page_buffer, page);
+  }
+}
+
+void CheckedFile::verifyPageChecksum(char* page_buffer, uint64_t page)
+{
+  uint32_t check_sum = checksum(page_buffer, logicalPageSize);
+  uint32_t stored_sum;
+  memcpy(&stored_sum, &page_buffer[logicalPageSize], sizeof(stored_sum)); //??? little endian dependency
+  if (stored_sum != check_sum)
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BAD_CHECKSUM, "fileName=" + fileName_ + " computedChecksum=" + toString(check_sum) + " storedChecksum="
+                                                   + toString(stored_sum) + " page=" + toString(page) + " length=" + toString(length(physical)));
+  }
+}
 
-#  if defined(_MSC_VER)
-    int result = ::_read(fd_, page_buffer, physicalPageSize);
-#  elif defined(__GNUC__)
-    int result = ::read(fd_, page_buffer, physicalPageSize);
+size_t CheckedFile::readPhysicalBytes(char* buf, size_t nRead, uint64_t physicalOffset)
+{
+  /// Read up to nRead bytes starting at physicalOffset, return fewer only if hit end of file.
+  /// Where possible use positioned reads, so the file cursor is not involved.
+  size_t total = 0;
+  while (total < nRead)
+  {
+#  if defined(E57_HAVE_PREAD) && defined(LINUX)
+    int64_t result = ::pread64(fd_, buf + total, nRead - total, static_cast<off64_t>(physicalOffset + total));
+#  elif defined(E57_HAVE_PREAD)
+    int64_t result = ::pread(fd_, buf + total, nRead - total, static_cast<off_t>(physicalOffset + total));
 #  else
-#    error "no supported compiler defined"
+    lseek64(static_cast<int64_t>(physicalOffset + total), SEEK_SET);
+#    if defined(_MSC_VER)
+    int64_t result = ::_read(fd_, buf + total, static_cast<unsigned>(nRead - total));
+#    else
+    int64_t result = ::read(fd_, buf + total, nRead - total);
+#    endif
 #  endif
-    if (result < 0 || static_cast<size_t>(result) != physicalPageSize)
+    if (result < 0)
       throw E57_EXCEPTION2(E57_ERROR_READ_FAILED, "fileName=" + fileName_ + " result=" + toString(result));
+    if (result == 0)
+      break;
+    total += static_cast<size_t>(result);
+  }
+  return (total);
+}
+
+void CheckedFile::writeCached(const char* buf, uint64_t nWrite)
+{
+  /// Copy buf (or zeros if buf is nullptr) into the cached pages covering the logical range starting at the cursor.
+  /// The file itself isn't touched until the cache is flushed.
+  uint64_t end = position(logical) + nWrite;
+
+  uint64_t page;
+  size_t   pageOffset;
+  getCurrentPageAndOffset(page, pageOffset);
+
+  while (nWrite > 0)
+  {
+    size_t n = static_cast<size_t>(min<uint64_t>(nWrite, logicalPageSize - pageOffset));
 
-    uint32_t check_sum = checksum(page_buffer, logicalPageSize);
-    if (*reinterpret_cast<uint32_t*>(&page_buffer[logicalPageSize]) != check_sum)
-    { //??? little endian dependency
-      throw E57_EXCEPTION2(E57_ERROR_BAD_CHECKSUM, "fileName=" + fileName_ + " computedChecksum=" + toString(check_sum)
-                                                     + " storedChecksum=" + toString(*reinterpret_cast<uint32_t*>(&page_buffer[logicalPageSize]))
-                                                     + " page=" + toString(page) + " length=" + toString(length(physical)));
+    char* page_buffer = cachedPage(page, n == logicalPageSize);
+    if (buf != nullptr)
+    {
+      memcpy(page_buffer + pageOffset, buf, n);
+      buf += n;
     }
+    else
+      memset(page_buffer + pageOffset, 0, n);
+
+    nWrite -= n;
+    pageOffset = 0;
+    page++;
   }
+
+  if (end > logicalLength_)
+    logicalLength_ = end;
+
+  /// When done, leave cursor just past end of buf
+  seek(end, logical);
+
+  if (writeCache_.size() >= writeCachePages)
+    flushWriteCache(true);
 }
 
-void CheckedFile::writePhysicalPage(char* page_buffer, uint64_t page)
+char* CheckedFile::cachedPage(uint64_t page, bool overwriteAll)
 {
-#  ifdef E57_MAX_VERBOSE
-  // cout << "writePhysicalPage, page:" << page << endl;
-#  endif
+  auto found = writeCache_.find(page);
+  if (found != writeCache_.end())
+    return (&found->second[0]);
+
+  /// Reuse the buffer of a previously flushed page if have one
+  vector<char> page_buffer_v;
+  if (!freePages_.empty())
+  {
+    page_buffer_v.swap(freePages_.back());
+    freePages_.pop_back();
+  }
+  else
+    page_buffer_v.resize(physicalPageSize);
+
+  /// Only need the current contents of the page if some of them will survive the write
+  if (!overwriteAll)
+    readPhysicalPage(&page_buffer_v[0], page);
+
+  return (&writeCache_.emplace(page, std::move(page_buffer_v)).first->second[0]);
+}
+
+void CheckedFile::flushWriteCache(bool keepTail)
+{
+  /// A partially filled last page is likely to be appended to by the next write, so optionally leave it in the cache
+  uint64_t tailPage     = logicalLength_ / logicalPageSize;
+  bool     keepTailPage = keepTail && (logicalLength_ % logicalPageSize) != 0;
+
+  auto it = writeCache_.begin();
+  while (it != writeCache_.end())
+  {
+    /// Gather a run of consecutive pages, append their checksums, and write the run with one call
+    uint64_t firstPage = it->first;
+    size_t   pageCount = 0;
+    while (it != writeCache_.end() && it->first == firstPage + pageCount && !(keepTailPage && it->first == tailPage))
+    {
+      char*    page_buffer = &it->second[0];
+      uint32_t check_sum   = checksum(page_buffer, logicalPageSize);
+      memcpy(&page_buffer[logicalPageSize], &check_sum, sizeof(check_sum)); //??? little endian dependency
+
+      if (writeBuffer_.size() < (pageCount + 1) * physicalPageSize)
+        writeBuffer_.resize((pageCount + 1) * physicalPageSize);
+      memcpy(&writeBuffer_[pageCount * physicalPageSize], page_buffer, physicalPageSize);
+      pageCount++;
+      ++it;
+    }
 
-  /// Append checksum
-  uint32_t check_sum                                          = checksum(page_buffer, logicalPageSize);
-  *reinterpret_cast<uint32_t*>(&page_buffer[logicalPageSize]) = check_sum; //??? little endian dependency
+    if (pageCount > 0)
+      writePhysicalBytes(&writeBuffer_[0], pageCount * physicalPageSize, firstPage * physicalPageSize);
+    else
+      ++it; /// skip kept tail page
+  }
 
-  /// Seek to start of physical page
-  seek(page * physicalPageSize, physical);
+  /// Recycle page buffers of everything written
+  for (it = writeCache_.begin(); it != writeCache_.end();)
+  {
+    if (keepTailPage && it->first == tailPage)
+    {
+      ++it;
+      continue;
+    }
+    freePages_.push_back(std::move(it->second));
+    it = writeCache_.erase(it);
+  }
+}
 
-#  if defined(_MSC_VER)
-  int result = ::_write(fd_, page_buffer, physicalPageSize);
-#  elif defined(__GNUC__)
-  int result = ::write(fd_, page_buffer, physicalPageSize);
+void CheckedFile::writePhysicalBytes(const char* buf, size_t nWrite, uint64_t physicalOffset)
+{
+  size_t total = 0;
+  while (total < nWrite)
+  {
+#  if defined(E57_HAVE_PREAD) && defined(LINUX)
+    int64_t result = ::pwrite64(fd_, buf + total, nWrite - total, static_cast<off64_t>(physicalOffset + total));
+#  elif defined(E57_HAVE_PREAD)
+    int64_t result = ::pwrite(fd_, buf + total, nWrite - total, static_cast<off_t>(physicalOffset + total));
 #  else
-#    error "no supported compiler defined"
+    lseek64(static_cast<int64_t>(physicalOffset + total), SEEK_SET);
+#    if defined(_MSC_VER)
+    int64_t result = ::_write(fd_, buf + total, static_cast<unsigned>(nWrite - total));
+#    else
+    int64_t result = ::write(fd_, buf + total, nWrite - total);
+#    endif
 #  endif
-  if (result < 0)
-    throw E57_EXCEPTION2(E57_ERROR_WRITE_FAILED, "fileName=" + fileName_ + " result=" + toString(result));
+    if (result <= 0)
+      throw E57_EXCEPTION2(E57_ERROR_WRITE_FAILED, "fileName=" + fileName_ + " result=" + toString(result));
+    total += static_cast<size_t>(result);
+  }
+
+  if (physicalOffset + nWrite > fileLength_)
+    fileLength_ = physicalOffset + nWrite;
 }
 
 #endif // SAFE_MODE
@@ -5030,9 +6342,10 @@ void IndexPacket::verify(unsigned bufferLength, uint64_t totalRecordCount, uint6
   if (packetType != E57_INDEX_PACKET)
     throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "packetType=" + toString(packetType));
 
-  /// Check packetLength is at least large enough to hold header
+  /// Check packetLength is at least large enough to hold header.
+  /// Packet only holds the entries in use, so it can be much shorter than the whole struct.
   unsigned packetLength = packetLogicalLengthMinus1 + 1;
-  if (packetLength < sizeof(*this))
+  if (packetLength < sizeof(*this) - sizeof(entries))
     throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "packetLength=" + toString(packetLength));
 
   /// Check packet length is multiple of 4
@@ -5071,7 +6384,7 @@ void IndexPacket::verify(unsigned bufferLength, uint64_t totalRecordCount, uint6
   }
 
   /// Check if entries will fit in space provided
-  unsigned neededLength = 16 + 8 * entryCount;
+  unsigned neededLength = sizeof(*this) - sizeof(entries) + sizeof(entries[0]) * entryCount;
   if (packetLength < neededLength)
   {
     throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "packetLength=" + toString(packetLength) + " neededLength=" + toString(neededLength));
@@ -5096,8 +6409,8 @@ void IndexPacket::verify(unsigned bufferLength, uint64_t totalRecordCount, uint6
                                                       + " totalRecordCount=" + toString(totalRecordCount));
     }
 
-    /// Check record numbers are strictly increasing
-    if (i > 0 && entries[i - 1].chunkRecordNumber >= entries[i].chunkRecordNumber)
+    /// Check record numbers are increasing.  Consecutive chunks can start in the same record if it is longer than a packet (e.g. a long string).
+    if (i > 0 && entries[i - 1].chunkRecordNumber > entries[i].chunkRecordNumber)
     {
       throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "i=" + toString(i) + " prevChunkRecordNumber=" + toString(entries[i - 1].chunkRecordNumber)
                                                       + " currentChunkRecordNumber=" + toString(entries[i].chunkRecordNumber));
@@ -5237,9 +6550,333 @@ struct SortByBytestreamNumber
   }
 };
 
+void SeekIndex::append(uint64_t chunkRecordNumber, uint64_t chunkPhysicalOffset)
+{
+  Entry entry;
+  entry.chunkRecordNumber   = chunkRecordNumber;
+  entry.chunkPhysicalOffset = chunkPhysicalOffset;
+  entries_.push_back(entry);
+}
+
+uint64_t SeekIndex::write(std::shared_ptr<ImageFileImpl> imf, uint64_t& indexPacketsCount)
+{
+  /// No data packets, so no index
+  if (entries_.empty())
+    return (0);
+
+  /// IndexPacket is big, so keep it off the stack.
+  std::unique_ptr<IndexPacket> ipkt(new IndexPacket);
+
+  /// Write the tree bottom up.  Each level has one entry per packet of the level below, until a level fits in a single packet (the root).
+  vector<Entry> level;
+  level.swap(entries_);
+  for (unsigned indexLevel = 0;; indexLevel++)
+  {
+    size_t        packetCount = (level.size() + IndexPacket::MAX_ENTRIES - 1) / IndexPacket::MAX_ENTRIES;
+    vector<Entry> parentLevel;
+    size_t        first = 0;
+    for (size_t packetIndex = 0; packetIndex < packetCount; packetIndex++)
+    {
+      /// Spread entries evenly over the packets, so packets above level 0 always get the two entries they need.
+      size_t end = (level.size() * (packetIndex + 1)) / packetCount;
+
+      *ipkt = IndexPacket();
+      ipkt->packetType = E57_INDEX_PACKET;
+      ipkt->entryCount = static_cast<uint16_t>(end - first);
+      ipkt->indexLevel = static_cast<uint8_t>(indexLevel);
+      for (size_t i = first; i < end; i++)
+      {
+        ipkt->entries[i - first].chunkRecordNumber   = level[i].chunkRecordNumber;
+        ipkt->entries[i - first].chunkPhysicalOffset = level[i].chunkPhysicalOffset;
+      }
+      /// Readers based on the reference implementation reject index packets shorter than the whole struct, so always write it full size.
+      /// Unused entries stay zero, which is allowed padding.
+      unsigned packetLength           = sizeof(IndexPacket);
+      ipkt->packetLogicalLengthMinus1 = static_cast<uint16_t>(packetLength - 1);
+
+      /// Double check that index packet is well formed
+      ipkt->verify(packetLength);
+
+#ifdef E57_BIGENDIAN
+      /// On bigendian CPUs, swab packet to little-endian byte order before writing.
+      ipkt->swab(true);
+#endif
+
+      /// Append index packet at beginning of free space in file, like the data packets
+      uint64_t packetLogicalOffset  = imf->allocateSpace(packetLength, false);
+      uint64_t packetPhysicalOffset = imf->file()->logicalToPhysical(packetLogicalOffset);
+      imf->file()->seek(packetLogicalOffset);
+      imf->file()->write(reinterpret_cast<char*>(ipkt.get()), packetLength);
+      indexPacketsCount++;
+
+      /// Parent entry points at this packet, starting at its first record
+      Entry entry;
+      entry.chunkRecordNumber   = level[first].chunkRecordNumber;
+      entry.chunkPhysicalOffset = packetPhysicalOffset;
+      parentLevel.push_back(entry);
+
+      first = end;
+    }
+
+    if (parentLevel.size() == 1)
+      return (parentLevel[0].chunkPhysicalOffset);
+    level.swap(parentLevel);
+  }
+}
+
+#ifdef E57_DEBUG
+void SeekIndex::dump(int indent, std::ostream& os)
+{
+  os << space(indent) << "entryCount: " << entries_.size() << endl;
+  for (size_t i = 0; i < entries_.size() && i < 10; i++)
+  {
+    os << space(indent) << "entry[" << i << "]: chunkRecordNumber=" << entries_[i].chunkRecordNumber
+       << " chunkPhysicalOffset=" << entries_[i].chunkPhysicalOffset << endl;
+  }
+  if (entries_.size() > 10)
+    os << space(indent) << entries_.size() - 10 << " more entries unprinted..." << endl;
+}
+#endif
+
+//================================================================
+
+CompressedVectorSection::CompressedVectorSection(std::shared_ptr<CompressedVectorNodeImpl> cVector)
+: cVector_(cVector), ownsTail_(false), spoolFile_(nullptr), spoolFileLength_(0), seekIndex_(), sectionHeaderLogicalStart_(0), sectionLogicalLength_(0),
+  dataPhysicalOffset_(0), topIndexPhysicalOffset_(0), dataPacketsCount_(0), indexPacketsCount_(0)
+{
+}
+
+CompressedVectorSection::~CompressedVectorSection()
+{
+  /// A temporary file is deleted when closed
+  if (spoolFile_ != nullptr)
+    std::fclose(spoolFile_);
+}
+
+bool CompressedVectorSection::claimTail()
+{
+  /// Take the end of the file if no other section has it.  Returns whether this section owns the tail.
+  if (ownsTail_)
+    return (true);
+
+  std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
+  {
+    std::lock_guard<std::mutex> guard(imf->tailMutex_);
+    if (imf->tailSection_ != nullptr)
+      return (false);
+    imf->tailSection_ = this;
+  }
+  ownsTail_ = true;
+
+  start();
+  return (true);
+}
+
+void CompressedVectorSection::start()
+{
+  std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
+
+  /// Reserve space for CompressedVector binary section header, record location so can save to when section is finished.
+  /// Request that file be extended with zeros since we will write to it at a later time (when writer closes).
+  sectionHeaderLogicalStart_ = imf->allocateSpace(sizeof(CompressedVectorSectionHeader), true);
+
+  /// Packets made while waiting for the tail follow the header, now that their offsets are known
+  if (!spoolChunks_.empty())
+  {
+    uint64_t spoolLogicalStart = imf->allocateSpace(spoolFileLength_ + spool_.size(), false);
+    imf->file_->seek(spoolLogicalStart);
+
+    /// The packets moved to the temporary file come first, copy them back through a buffer the size of the memory spool
+    if (spoolFile_ != nullptr)
+    {
+      std::rewind(spoolFile_);
+      std::vector<char> buffer(static_cast<size_t>(min<uint64_t>(spoolFileLength_, E57_SPOOL_MEMORY_MAX)));
+      for (uint64_t copied = 0; copied < spoolFileLength_;)
+      {
+        size_t n = static_cast<size_t>(min<uint64_t>(spoolFileLength_ - copied, buffer.size()));
+        if (std::fread(buffer.data(), 1, n, spoolFile_) != n)
+          throw E57_EXCEPTION2(E57_ERROR_READ_FAILED, "spoolFileLength=" + toString(spoolFileLength_) + " copied=" + toString(copied));
+        imf->file_->write(buffer.data(), n);
+        copied += n;
+      }
+      std::fclose(spoolFile_);
+      spoolFile_       = nullptr;
+      spoolFileLength_ = 0;
+    }
+    imf->file_->write(spool_.data(), spool_.size());
+    for (size_t i = 0; i < spoolChunks_.size(); i++)
+      appendPacket(spoolLogicalStart + spoolChunks_[i].second, spoolChunks_[i].first);
+
+    /// Free the memory
+    std::vector<char>().swap(spool_);
+    std::vector<std::pair<uint64_t, uint64_t>>().swap(spoolChunks_);
+  }
+}
+
+void CompressedVectorSection::appendPacket(uint64_t packetLogicalOffset, uint64_t chunkRecordNumber)
+{
+  /// A data packet was written at packetLogicalOffset, at the end of the section
+  uint64_t packetPhysicalOffset = CheckedFile::logicalToPhysical(packetLogicalOffset);
+
+  /// If first data packet written for this CompressedVector binary section, save address to put in section header
+  if (dataPacketsCount_ == 0)
+    dataPhysicalOffset_ = packetPhysicalOffset;
+  dataPacketsCount_++;
+
+  /// Every data packet is a chunk in the index
+  seekIndex_.append(chunkRecordNumber, packetPhysicalOffset);
+}
+
+void CompressedVectorSection::spoolPacket(const char* packet, size_t packetLength, uint64_t chunkRecordNumber)
+{
+  /// Keep the packet until the section gets the tail, moving the ones before it out of memory if there are too many
+  if (spool_.size() + packetLength > E57_SPOOL_MEMORY_MAX)
+    spillSpool();
+  spoolChunks_.push_back(std::make_pair(chunkRecordNumber, spoolFileLength_ + spool_.size()));
+  spool_.insert(spool_.end(), packet, packet + packetLength);
+}
+
+void CompressedVectorSection::spillSpool()
+{
+  /// Append the packets in memory to the temporary file, creating it the first time
+  if (spoolFile_ == nullptr)
+  {
+    spoolFile_ = std::tmpfile();
+    if (spoolFile_ == nullptr)
+      throw E57_EXCEPTION2(E57_ERROR_OPEN_FAILED, "imageFileName=" + cVector_->imageFileName() + " cvPathName=" + cVector_->pathName());
+  }
+
+  if (std::fwrite(spool_.data(), 1, spool_.size(), spoolFile_) != spool_.size())
+  {
+    throw E57_EXCEPTION2(E57_ERROR_WRITE_FAILED, "imageFileName=" + cVector_->imageFileName() + " cvPathName=" + cVector_->pathName()
+                                                   + " spoolFileLength=" + toString(spoolFileLength_));
+  }
+  spoolFileLength_ += spool_.size();
+  spool_.clear();
+}
+
+void CompressedVectorSection::close(uint64_t recordCount)
+{
+  std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
+
+  /// Records are counted now, even if the section is written later
+  cVector_->setRecordCount(recordCount);
+
+  /// If another section has the tail, leave this one for it to write when it closes
+  while (!claimTail())
+  {
+    std::lock_guard<std::mutex> guard(imf->tailMutex_);
+    if (imf->tailSection_ != nullptr)
+    {
+      imf->pendingSections_.push_back(shared_from_this());
+      return;
+    }
+  }
+
+  try
+  {
+    finish();
+  }
+  catch (...)
+  {
+    /// Let the other writers carry on, the file is bad anyway
+    std::lock_guard<std::mutex> guard(imf->tailMutex_);
+    imf->tailSection_ = nullptr;
+    ownsTail_         = false;
+    throw;
+  }
+  releaseTail();
+}
+
+void CompressedVectorSection::finish()
+{
+  std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
+
+  /// Write index packets after the data packets, so readers can seek without scanning the whole section
+  topIndexPhysicalOffset_ = seekIndex_.write(imf, indexPacketsCount_);
+
+  /// Compute length of whole section we just wrote (from section start to current start of free space).
+  sectionLogicalLength_ = imf->unusedLogicalStart_ - sectionHeaderLogicalStart_;
+#ifdef E57_MAX_VERBOSE
+  cout << "  sectionLogicalLength_=" << sectionLogicalLength_ << endl; //???
+#endif
+
+  /// Prepare CompressedVectorSectionHeader
+  CompressedVectorSectionHeader header;
+  header.sectionId            = E57_COMPRESSED_VECTOR_SECTION;
+  header.sectionLogicalLength = sectionLogicalLength_;
+  header.dataPhysicalOffset   = dataPhysicalOffset_;     ///??? can be zero, if no data written ???not set yet
+  header.indexPhysicalOffset  = topIndexPhysicalOffset_; /// zero if no data written
+#ifdef E57_MAX_VERBOSE
+  cout << "  CompressedVectorSectionHeader:" << endl;
+  header.dump(4); //???
+#endif
+#ifdef E57_DEBUG
+  /// Verify OK before write it.
+  header.verify(imf->file_->length(CheckedFile::physical));
+#endif
+  header.swab(); /// swab if neccesary
+
+  /// Write header at beginning of section, previously allocated
+  imf->file_->seek(sectionHeaderLogicalStart_);
+  imf->file_->write(reinterpret_cast<char*>(&header), sizeof(header));
+
+  /// Set address of associated CompressedVector
+  cVector_->setBinarySectionLogicalStart(sectionHeaderLogicalStart_);
+}
+
+void CompressedVectorSection::releaseTail()
+{
+  /// Write out the sections that closed while waiting for the tail, then free it for any section.
+  /// tailMutex_ is held meanwhile, so a section can't claim the tail and start writing in between.
+  std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
+  std::lock_guard<std::mutex>    guard(imf->tailMutex_);
+  try
+  {
+    while (!imf->pendingSections_.empty())
+    {
+      std::shared_ptr<CompressedVectorSection> section = imf->pendingSections_.front();
+      imf->pendingSections_.erase(imf->pendingSections_.begin());
+
+      imf->tailSection_ = section.get();
+      section->start();
+      section->finish();
+    }
+  }
+  catch (...)
+  {
+    imf->pendingSections_.clear();
+    imf->tailSection_ = nullptr;
+    ownsTail_         = false;
+    throw;
+  }
+  imf->tailSection_ = nullptr;
+  ownsTail_         = false;
+}
+
+#ifdef E57_DEBUG
+void CompressedVectorSection::dump(int indent, std::ostream& os)
+{
+  os << space(indent) << "seekIndex:" << endl;
+  seekIndex_.dump(indent + 4, os);
+
+  os << space(indent) << "ownsTail:                  " << ownsTail_ << endl;
+  os << space(indent) << "spoolSize:                 " << spool_.size() << endl;
+  os << space(indent) << "spoolFileLength:           " << spoolFileLength_ << endl;
+  os << space(indent) << "sectionHeaderLogicalStart: " << sectionHeaderLogicalStart_ << endl;
+  os << space(indent) << "sectionLogicalLength:      " << sectionLogicalLength_ << endl;
+  os << space(indent) << "dataPhysicalOffset:        " << dataPhysicalOffset_ << endl;
+  os << space(indent) << "topIndexPhysicalOffset:    " << topIndexPhysicalOffset_ << endl;
+  os << space(indent) << "dataPacketsCount:          " << dataPacketsCount_ << endl;
+  os << space(indent) << "indexPacketsCount:         " << indexPacketsCount_ << endl;
+}
+#endif
+
+//================================================================
+
 CompressedVectorWriterImpl::CompressedVectorWriterImpl(std::shared_ptr<CompressedVectorNodeImpl> ni, vector<SourceDestBuffer>& sbufs)
-: isOpen_(false),            // set to true when succeed below
-  cVector_(ni), seekIndex_() /// Init seek index for random access to beginning of chunks
+: isOpen_(false), // set to true when succeed below
+  cVector_(ni)
 {
   //???  check if cvector already been written (can't write twice)
 
@@ -5292,19 +6929,20 @@ CompressedVectorWriterImpl::CompressedVectorWriterImpl(std::shared_ptr<Compresse
 
   std::shared_ptr<ImageFileImpl> imf(ni->destImageFile_);
 
-  /// Reserve space for CompressedVector binary section header, record location so can save to when writer closes.
-  /// Request that file be extended with zeros since we will write to it at a later time (when writer closes).
-  sectionHeaderLogicalStart_ = imf->allocateSpace(sizeof(CompressedVectorSectionHeader), true);
+  /// Encoders are independent of each other, so if asked for, run them on a pool with at most one thread per bytestream
+  unsigned encoderThreads = static_cast<unsigned>(min(static_cast<size_t>(imf->encoderThreadCount_), bytestreams_.size()));
+  if (encoderThreads > 1)
+    encoderPool_ = std::make_unique<WorkerPool>(encoderThreads);
+
+  /// Start the binary section at the end of the file, unless another writer is appending there
+  section_ = std::make_shared<CompressedVectorSection>(cVector_);
+  section_->claimTail();
 
-  sectionLogicalLength_   = 0;
-  dataPhysicalOffset_     = 0;
-  topIndexPhysicalOffset_ = 0;
-  recordCount_            = 0;
-  dataPacketsCount_       = 0;
-  indexPacketsCount_      = 0;
+  recordCount_ = 0;
 
   /// Just before return (and can't throw) increment writer count  ??? safer way to assure don't miss close?
   imf->incrWriterCount();
+  cVector_->writerOpen_ = true;
 
   /// If get here, the writer is open
   isOpen_ = true;
@@ -5334,9 +6972,6 @@ void CompressedVectorWriterImpl::close()
 #endif
   std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
 
-  /// Before anything that can throw, decrement writer count
-  imf->decrWriterCount();
-
   checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
   /// don't call checkWriterOpen();
 
@@ -5344,8 +6979,24 @@ void CompressedVectorWriterImpl::close()
     return;
 
   /// Set closed before do anything, so if get fault and start unwinding, don't try to close again.
-  isOpen_ = false;
+  isOpen_               = false;
+  cVector_->writerOpen_ = false;
+
+  /// Decrement writer count even if fail, but only once the section is done, so no reader can be opened before its data is in the file.
+  try
+  {
+    closeSection();
+  }
+  catch (...)
+  {
+    imf->decrWriterCount();
+    throw;
+  }
+  imf->decrWriterCount();
+}
 
+void CompressedVectorWriterImpl::closeSection()
+{
   /// If have any data, write packet
   /// Write all remaining ioBuffers and internal encoder register cache into file.
   /// Know we are done when totalOutputAvailable() returns 0 after a flush().
@@ -5356,37 +7007,11 @@ void CompressedVectorWriterImpl::close()
     flush();
   }
 
-  /// Compute length of whole section we just wrote (from section start to current start of free space).
-  sectionLogicalLength_ = imf->unusedLogicalStart_ - sectionHeaderLogicalStart_;
-#ifdef E57_MAX_VERBOSE
-  cout << "  sectionLogicalLength_=" << sectionLogicalLength_ << endl; //???
-#endif
-
-  /// Prepare CompressedVectorSectionHeader
-  CompressedVectorSectionHeader header;
-  header.sectionId            = E57_COMPRESSED_VECTOR_SECTION;
-  header.sectionLogicalLength = sectionLogicalLength_;
-  header.dataPhysicalOffset   = dataPhysicalOffset_;     ///??? can be zero, if no data written ???not set yet
-  header.indexPhysicalOffset  = topIndexPhysicalOffset_; ///??? can be zero, if no data written ???not set yet
-#ifdef E57_MAX_VERBOSE
-  cout << "  CompressedVectorSectionHeader:" << endl;
-  header.dump(4); //???
-#endif
-#ifdef E57_DEBUG
-  /// Verify OK before write it.
-  header.verify(imf->file_->length(CheckedFile::physical));
-#endif
-  header.swab(); /// swab if neccesary
-
-  /// Write header at beginning of section, previously allocated
-  imf->file_->seek(sectionHeaderLogicalStart_);
-  imf->file_->write(reinterpret_cast<char*>(&header), sizeof(header));
-
-  /// Set address and size of associated CompressedVector
-  cVector_->setRecordCount(recordCount_);
-  cVector_->setBinarySectionLogicalStart(sectionHeaderLogicalStart_);
+  /// Write index and section header, now or when the section gets the tail, and set size and address of associated CompressedVector
+  section_->close(recordCount_);
 
   /// Free channels
+  encoderPool_.reset();
   bytestreams_.clear();
 
 #ifdef E57_MAX_VERBOSE
@@ -5432,6 +7057,22 @@ void CompressedVectorWriterImpl::setBuffers(vector<SourceDestBuffer>& sbufs)
   proto_->checkBuffers(sbufs, false);
 
   sbufs_ = sbufs;
+
+  /// Once the encoders exist, point them at the new buffers too.  bytestreams_ is ordered by bytestream number, not by sbufs order.
+  if (!bytestreams_.empty())
+  {
+    for (unsigned i = 0; i < sbufs_.size(); i++)
+    {
+      std::shared_ptr<NodeImpl> writeNode        = proto_->get(sbufs_[i].pathName());
+      uint64_t                  bytestreamNumber = 0;
+      if (!proto_->findTerminalPosition(writeNode, bytestreamNumber) || bytestreamNumber >= bytestreams_.size())
+        throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "sbufIndex=" + toString(i));
+
+      vector<SourceDestBuffer> theSbuf;
+      theSbuf.push_back(sbufs_[i]);
+      bytestreams_[static_cast<size_t>(bytestreamNumber)]->sourceBufferSetNew(theSbuf);
+    }
+  }
 }
 
 void CompressedVectorWriterImpl::write(vector<SourceDestBuffer>& sbufs, const size_t requestedRecordCount)
@@ -5443,6 +7084,14 @@ void CompressedVectorWriterImpl::write(vector<SourceDestBuffer>& sbufs, const si
   write(requestedRecordCount);
 }
 
+#if E57_WRITE_CRAZY_PACKET_MODE
+///??? depends on number of streams
+#  define E57_TARGET_PACKET_SIZE 500
+#else
+#  define E57_TARGET_PACKET_SIZE (E57_DATA_PACKET_MAX * 3 / 4)
+#endif
+#define E57_WRITE_ROUND_RECORDS 50 /// records per channel between packet size checks, see packetRecordCount()
+
 void CompressedVectorWriterImpl::write(const size_t requestedRecordCount)
 {
 #ifdef E57_MAX_VERBOSE
@@ -5451,11 +7100,14 @@ void CompressedVectorWriterImpl::write(const size_t requestedRecordCount)
   checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
   checkWriterOpen(__FILE__, __LINE__, __FUNCTION__);
 
-  /// Check that requestedRecordCount is not larger than the sbufs
-  if (requestedRecordCount > sbufs_.at(0).impl()->capacity())
+  /// Check that requestedRecordCount is not larger than the sbufs, any of which may have been rebased since they were bound
+  for (unsigned i = 0; i < sbufs_.size(); i++)
   {
-    throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "requested=" + toString(requestedRecordCount) + " capacity=" + toString(sbufs_.at(0).impl()->capacity())
-                                                       + " imageFileName=" + cVector_->imageFileName() + " cvPathName=" + cVector_->pathName());
+    if (requestedRecordCount > sbufs_.at(i).impl()->capacity())
+    {
+      throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "requested=" + toString(requestedRecordCount) + " capacity=" + toString(sbufs_.at(i).impl()->capacity())
+                                                         + " imageFileName=" + cVector_->imageFileName() + " cvPathName=" + cVector_->pathName());
+    }
   }
 
   /// Rewind all sbufs so start reading from beginning
@@ -5488,12 +7140,6 @@ void CompressedVectorWriterImpl::write(const size_t requestedRecordCount)
     cout << "  currentPacketSize()=" << currentPacketSize() << endl; //???
 #endif
 
-#if E57_WRITE_CRAZY_PACKET_MODE
-///??? depends on number of streams
-#  define E57_TARGET_PACKET_SIZE 500
-#else
-#  define E57_TARGET_PACKET_SIZE (E57_DATA_PACKET_MAX * 3 / 4)
-#endif
     /// If have more than target fraction of packet, send it now
     if (currentPacketSize() >= E57_TARGET_PACKET_SIZE)
     { //???
@@ -5501,35 +7147,8 @@ void CompressedVectorWriterImpl::write(const size_t requestedRecordCount)
       continue; /// restart loop so recalc statistics (packet size may not be zero after write, if have too much data)
     }
 
-    ///??? useful?
-    /// Get approximation of number of bytes per record of CompressedVector and total of bytes used
-    float totalBitsPerRecord = 0; // an estimate of future performance
-    for (unsigned i = 0; i < bytestreams_.size(); i++)
-      totalBitsPerRecord += bytestreams_.at(i)->bitsPerRecord();
-    // float totalBytesPerRecord = max(totalBitsPerRecord / 8, 0.1F); //??? trust
-
-    //!!!        unsigned spaceRemaining = E57_DATA_PACKET_MAX - currentPacketSize();
-    //!!!        unsigned appoxRecordsNeeded = static_cast<unsigned>(floor(spaceRemaining / totalBytesPerRecord)); //??? divide by zero if all constants
-
-    /// Don't allow straggler to get too far behind. ???
-    /// Don't allow a single channel to get too far ahead ???
-    /// Process channels that are furthest behind first. ???
-
-    ///!!!! For now just process one record per loop until packet is full enough, or completed request
-    for (unsigned i = 0; i < bytestreams_.size(); i++)
-    {
-      if (bytestreams_.at(i)->currentRecordIndex() < endRecordIndex)
-      {
-#if 0
-                bytestreams_.at(i)->processRecords(1);
-#else
-        //!!! For now, process up to 50 records at a time
-        uint64_t recordCount = endRecordIndex - bytestreams_.at(i)->currentRecordIndex();
-        recordCount          = (recordCount < 50ULL) ? recordCount : 50ULL; // min(recordCount, 50ULL);
-        bytestreams_.at(i)->processRecords((unsigned)recordCount);
-#endif
-      }
-    }
+    /// Feed each channel the records that take the packet to its target size
+    processPacketRecords(packetRecordCount(endRecordIndex), endRecordIndex);
   }
 
   recordCount_ += requestedRecordCount;
@@ -5553,6 +7172,75 @@ size_t CompressedVectorWriterImpl::currentPacketSize()
   return (sizeof(DataPacketHeader) + bytestreams_.size() * sizeof(uint16_t) + totalOutputAvailable());
 }
 
+uint64_t CompressedVectorWriterImpl::packetRecordCount(uint64_t endRecordIndex)
+{
+  /// The writer used to feed every channel rounds of up to 50 records, checking the packet size after each round.
+  /// Files must stay the same, so process all the rounds up to the one that takes the packet to E57_TARGET_PACKET_SIZE at once,
+  /// using the exact output size of each encoder to find that round.  Encoders that can't predict their size (strings) still go one round at a time.
+  constexpr uint64_t recordsPerRound = E57_WRITE_ROUND_RECORDS;
+
+  /// Number of rounds until the channel furthest behind is done
+  uint64_t maxRounds = 0;
+  for (unsigned i = 0; i < bytestreams_.size(); i++)
+    maxRounds = max(maxRounds, (endRecordIndex - bytestreams_.at(i)->currentRecordIndex() + recordsPerRound - 1) / recordsPerRound);
+
+  /// Packet size after some rounds, false if some encoder can't tell
+  auto packetSizeAfter = [&](uint64_t rounds, size_t& packetSize) {
+    packetSize = sizeof(DataPacketHeader) + bytestreams_.size() * sizeof(uint16_t);
+    for (unsigned i = 0; i < bytestreams_.size(); i++)
+    {
+      uint64_t recordCount = min(rounds * recordsPerRound, endRecordIndex - bytestreams_.at(i)->currentRecordIndex());
+      size_t   byteCount;
+      if (!bytestreams_.at(i)->outputAvailableAfter(static_cast<size_t>(recordCount), byteCount))
+        return (false);
+      packetSize += byteCount;
+    }
+    return (true);
+  };
+
+  /// The packet only grows with more rounds, so bisect for the first round after which it is full enough or can't be predicted.
+  /// The packet is short after round low (write() just checked it is now), round high is the last one to consider.
+  size_t   packetSize;
+  uint64_t low  = 0;
+  uint64_t high = maxRounds;
+  while (high - low > 1)
+  {
+    uint64_t middle = low + (high - low) / 2;
+    if (!packetSizeAfter(middle, packetSize) || packetSize >= E57_TARGET_PACKET_SIZE)
+      high = middle;
+    else
+      low = middle;
+  }
+
+  /// Stop short of a round that can't be predicted, unless it is the next one
+  if (high > 1 && !packetSizeAfter(high, packetSize))
+    high--;
+  return (high * recordsPerRound);
+}
+
+void CompressedVectorWriterImpl::processPacketRecords(uint64_t packetRecords, uint64_t endRecordIndex)
+{
+  /// Feed each channel up to packetRecords records, in one call per channel.
+  /// The channels only share the read-only source buffers, so with an encoder pool they are fed in parallel.
+  /// Either way all calls are done when this returns, so packets are cut at the same places as by a single thread.
+  auto encode = [&](size_t i) {
+    if (bytestreams_[i]->currentRecordIndex() < endRecordIndex)
+    {
+      uint64_t recordCount = min(packetRecords, endRecordIndex - bytestreams_[i]->currentRecordIndex());
+      bytestreams_[i]->processRecords(static_cast<size_t>(recordCount));
+    }
+  };
+
+  /// A single round (a string channel is present, or the last records) is less work than waking the pool
+  if (encoderPool_ && packetRecords > E57_WRITE_ROUND_RECORDS)
+    encoderPool_->run(bytestreams_.size(), encode);
+  else
+  {
+    for (size_t i = 0; i < bytestreams_.size(); i++)
+      encode(i);
+  }
+}
+
 uint64_t CompressedVectorWriterImpl::packetWrite()
 {
 #ifdef E57_MAX_VERBOSE
@@ -5567,6 +7255,13 @@ uint64_t CompressedVectorWriterImpl::packetWrite()
   cout << "  totalOutput=" << totalOutput << endl; //???
 #endif
 
+  /// Index entry for this packet: the first record with any data in this packet, whose data may have started in an earlier packet.
+  /// Only the records after chunkRecordNumber are sure to have all their data in this packet or later ones.
+  /// Must get this before reading any output from the encoders.
+  uint64_t chunkRecordNumber = E57_UINT64_MAX;
+  for (unsigned i = 0; i < bytestreams_.size(); i++)
+    chunkRecordNumber = min(chunkRecordNumber, bytestreams_.at(i)->outputRecordNumber());
+
   /// Calc maximum number of bytestream values can put in data packet.
   size_t packetMaxPayloadBytes = E57_DATA_PACKET_MAX - sizeof(DataPacketHeader) - bytestreams_.size() * sizeof(uint16_t);
 #ifdef E57_MAX_VERBOSE
@@ -5613,8 +7308,20 @@ uint64_t CompressedVectorWriterImpl::packetWrite()
   /// Get smart pointer to ImageFileImpl from associated CompressedVector
   std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
 
-  /// Use temp buf in object (is 64KBytes long) instead of allocating each time here
-  char* packet = reinterpret_cast<char*>(&dataPacket_);
+  /// The packet goes to the end of the file if this writer's section has the tail, otherwise it is spooled until the section gets it
+  bool appending = section_->claimTail();
+
+  /// Use temp buf in object (is 64KBytes long) instead of allocating each time here.
+  /// If the file has a write queue, build the packet in a queue buffer instead, to be written while the next packet is encoded.
+  std::vector<char> queueBuffer;
+  DataPacket*       dataPacket = &dataPacket_;
+  if (appending && imf->file_->writeQueueSize() > 0)
+  {
+    queueBuffer = imf->file_->writeQueueBuffer();
+    queueBuffer.resize(sizeof(DataPacket));
+    dataPacket = reinterpret_cast<DataPacket*>(queueBuffer.data());
+  }
+  char* packet = reinterpret_cast<char*>(dataPacket);
 #ifdef E57_MAX_VERBOSE
   cout << "  packet=" << (unsigned)packet << endl; //???
 #endif
@@ -5622,7 +7329,7 @@ uint64_t CompressedVectorWriterImpl::packetWrite()
   /// To be safe, clear header part of packet
   memset(packet, 0, sizeof(DataPacketHeader));
 
-  /// Write bytestreamBufferLength[bytestreamCount] after header, in dataPacket_
+  /// Write bytestreamBufferLength[bytestreamCount] after header, in packet
   uint16_t* bsbLength = reinterpret_cast<uint16_t*>(&packet[sizeof(DataPacketHeader)]);
 #ifdef E57_MAX_VERBOSE
   cout << "  bsbLength=" << (unsigned)bsbLength << endl; //???
@@ -5641,7 +7348,7 @@ uint64_t CompressedVectorWriterImpl::packetWrite()
   cout << "  after bsbLength, p=" << (unsigned)p << endl; //???
 #endif
 
-  /// Write contents of each bytestream in dataPacket_
+  /// Write contents of each bytestream in packet
   for (size_t i = 0; i < bytestreams_.size(); i++)
   {
     size_t n = count.at(i);
@@ -5678,7 +7385,7 @@ uint64_t CompressedVectorWriterImpl::packetWrite()
   while (packetLength % 4)
   {
     /// Double check we aren't accidentally going to write off end of vector<char>
-    if (p >= &packet[E57_DATA_PACKET_MAX - 1])
+    if (p >= &packet[E57_DATA_PACKET_MAX])
       throw E57_EXCEPTION1(E57_ERROR_INTERNAL);
     *p++ = 0;
     packetLength++;
@@ -5687,41 +7394,47 @@ uint64_t CompressedVectorWriterImpl::packetWrite()
 #endif
   }
 
-  /// Prepare header in dataPacket_, now that we are sure of packetLength
-  dataPacket_.packetType                = E57_DATA_PACKET;
-  dataPacket_.packetFlags               = 0;
-  dataPacket_.packetLogicalLengthMinus1 = static_cast<uint16_t>(packetLength - 1);         // %%% Truncation
-  dataPacket_.bytestreamCount           = static_cast<std::uint16_t>(bytestreams_.size()); // %%% Truncation
+  /// Prepare header in packet, now that we are sure of packetLength
+  dataPacket->packetType                = E57_DATA_PACKET;
+  dataPacket->packetFlags               = 0;
+  dataPacket->packetLogicalLengthMinus1 = static_cast<uint16_t>(packetLength - 1);         // %%% Truncation
+  dataPacket->bytestreamCount           = static_cast<std::uint16_t>(bytestreams_.size()); // %%% Truncation
 
   /// Double check that data packet is well formed
-  dataPacket_.verify(packetLength);
+  dataPacket->verify(packetLength);
 
 #ifdef E57_BIGENDIAN
   /// On bigendian CPUs, swab packet to little-endian byte order before writing.
-  dataPacket_.swab(true);
+  dataPacket->swab(true);
 #endif
 
-  /// Write whole data packet at beginning of free space in file
+  if (!appending)
+  {
+    section_->spoolPacket(packet, packetLength, chunkRecordNumber);
+    return (0);
+  }
+
+  /// Write whole data packet at beginning of free space in file.
+  /// Space is allocated here in packet order, so a queued packet lands at the same offset as one written right away.
   uint64_t packetLogicalOffset  = imf->allocateSpace(packetLength, false);
   uint64_t packetPhysicalOffset = imf->file_->logicalToPhysical(packetLogicalOffset);
-  imf->file_->seek(packetLogicalOffset); //??? have seekLogical and seekPhysical instead? more explicit
-  imf->file_->write(packet, packetLength);
+  if (dataPacket != &dataPacket_)
+    imf->file_->writeQueued(packetLogicalOffset, std::move(queueBuffer), packetLength);
+  else
+  {
+    imf->file_->seek(packetLogicalOffset); //??? have seekLogical and seekPhysical instead? more explicit
+    imf->file_->write(packet, packetLength);
+  }
 
 #ifdef E57_MAX_VERBOSE
 //  cout << "data packet:" << endl;
-//  dataPacket_.dump(4);
+//  dataPacket->dump(4);
 #endif
 
-  /// If first data packet written for this CompressedVector binary section, save address to put in section header
-  ///??? what if no data packets?
   ///??? what if have exceptions while write, what is state of file?  will close report file good/bad?
-  if (dataPacketsCount_ == 0)
-    dataPhysicalOffset_ = packetPhysicalOffset;
-  dataPacketsCount_++;
-
-  ///!!! update seekIndex here? if started new chunk?
+  section_->appendPacket(packetLogicalOffset, chunkRecordNumber);
 
-  /// Return physical offset of data packet for potential use in seekIndex
+  /// Return physical offset of data packet
   return (packetPhysicalOffset); //??? needed
 }
 
@@ -5782,8 +7495,8 @@ void CompressedVectorWriterImpl::dump(int indent, std::ostream& os)
     bytestreams_.at(i)->dump(indent + 4, os);
   }
 
-  os << space(indent) << "seekIndex:" << endl;
-  seekIndex_.dump(indent + 4, os);
+  os << space(indent) << "section:" << endl;
+  section_->dump(indent + 4, os);
 
   /// Don't call dump() for DataPacket, since it may contain junk when debugging.  Just print a few byte values.
   os << space(indent) << "dataPacket:" << endl;
@@ -5794,22 +7507,18 @@ void CompressedVectorWriterImpl::dump(int indent, std::ostream& os)
   }
   os << space(indent + 4) << "more unprinted..." << endl;
 
-  os << space(indent) << "sectionHeaderLogicalStart: " << sectionHeaderLogicalStart_ << endl;
-  os << space(indent) << "sectionLogicalLength:      " << sectionLogicalLength_ << endl;
-  os << space(indent) << "dataPhysicalOffset:        " << dataPhysicalOffset_ << endl;
-  os << space(indent) << "topIndexPhysicalOffset:    " << topIndexPhysicalOffset_ << endl;
   os << space(indent) << "recordCount:               " << recordCount_ << endl;
-  os << space(indent) << "dataPacketsCount:          " << dataPacketsCount_ << endl;
-  os << space(indent) << "indexPacketsCount:         " << indexPacketsCount_ << endl;
 }
 
 ///================================================================
 ///================================================================
 ///================================================================
 
-CompressedVectorReaderImpl::CompressedVectorReaderImpl(std::shared_ptr<CompressedVectorNodeImpl> cvi, vector<SourceDestBuffer>& dbufs)
+CompressedVectorReaderImpl::CompressedVectorReaderImpl(std::shared_ptr<CompressedVectorNodeImpl> cvi, vector<SourceDestBuffer>& dbufs, unsigned cachePacketCount)
 : isOpen_(false), // set to true when succeed below
-  cVector_(cvi)
+  cVector_(cvi),
+  asyncPending_(false),
+  stopAsync_(false)
 {
 #ifdef E57_MAX_VERBOSE
   cout << "CompressedVectorReaderImpl() called" << endl; //???
@@ -5857,8 +7566,27 @@ CompressedVectorReaderImpl::CompressedVectorReaderImpl(std::shared_ptr<Compresse
 
   std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
 
+  /// Read-ahead needs a file that can be read from two threads at once
+  unsigned prefetchCount = imf->file_->canReadConcurrently() ? imf->prefetchPacketCount_ : 0;
+
+  /// Decoding several channels at once only pays off when there is more than one channel to decode.
+  unsigned decoderThreads = static_cast<unsigned>(min(static_cast<size_t>(imf->decoderThreadCount_), channels_.size()));
+  if (decoderThreads > 1)
+    decoderPool_.reset(new WorkerPool(decoderThreads));
+
+  /// If caller didn't give a cache size, start small and let adaptCache() grow it as the channels drift apart.
+  /// Channels can't be spread over more packets than there are channels, so one more than that is all that can be needed, plus the read-ahead.
+  /// Parallel decoders work on a window of packets at a time, which needs one more entry for finding the packet after the window.
+  cacheAutoSize_ = (cachePacketCount == 0);
+  if (cacheAutoSize_)
+  {
+    cachePacketCount = std::min(E57_PACKET_CACHE_MIN, static_cast<int>(channels_.size()) + 1) + prefetchCount;
+    if (decoderPool_)
+      cachePacketCount = std::max(cachePacketCount, static_cast<unsigned>(E57_DECODE_WINDOW_PACKETS) + 1 + prefetchCount);
+  }
+
   //??? what if fault in this constructor?
-  cache_ = new PacketReadCache(imf->file_.get(), 4 /*???*/);
+  cache_ = new PacketReadCache(imf->file_.get(), cachePacketCount, prefetchCount);
 
   /// Read CompressedVector section header
   CompressedVectorSectionHeader sectionHeader;
@@ -5868,8 +7596,7 @@ CompressedVectorReaderImpl::CompressedVectorReaderImpl(std::shared_ptr<Compresse
     //??? should have caught this before got here, in XML read, get this if CV wasn't written to by writer.
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "imageFileName=" + cVector_->imageFileName() + " cvPathName=" + cVector_->pathName());
   }
-  imf->file_->seek(sectionLogicalStart, CheckedFile::logical);
-  imf->file_->read(reinterpret_cast<char*>(&sectionHeader), sizeof(sectionHeader));
+  cache_->read(sectionLogicalStart, reinterpret_cast<char*>(&sectionHeader), sizeof(sectionHeader));
   sectionHeader.swab(); /// swab if neccesary
 
 #ifdef E57_DEBUG
@@ -5879,9 +7606,23 @@ CompressedVectorReaderImpl::CompressedVectorReaderImpl(std::shared_ptr<Compresse
   /// Pre-calc end of section, so can tell when we are out of packets.
   sectionEndLogicalOffset_ = sectionLogicalStart + sectionHeader.sectionLogicalLength;
 
+  /// Bound string lengths read from the file, before a corrupt one is used to size a string
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    std::shared_ptr<BitpackStringDecoder> decoder = std::dynamic_pointer_cast<BitpackStringDecoder>(channels_[i].decoder);
+    if (decoder)
+      decoder->setMaxStringLength(sectionHeader.sectionLogicalLength);
+  }
+
   /// Convert physical offset to first data packet to logical
   uint64_t dataLogicalOffset = imf->file_->physicalToLogical(sectionHeader.dataPhysicalOffset);
 
+  /// Remember where packets start for seek(), the chunk index itself isn't built until needed.
+  seekIndexReady_        = false;
+  dataLogicalOffset_     = dataLogicalOffset;
+  indexLogicalOffset_    = (sectionHeader.indexPhysicalOffset != 0) ? imf->file_->physicalToLogical(sectionHeader.indexPhysicalOffset) : 0;
+  seekScanLogicalOffset_ = dataLogicalOffset;
+
   /// Verify that packet given by dataPhysicalOffset is actually a data packet, init channels
   {
     char*                       anyPacket  = nullptr;
@@ -5905,6 +7646,8 @@ CompressedVectorReaderImpl::CompressedVectorReaderImpl(std::shared_ptr<Compresse
 
   /// Just before return (and can't throw) increment reader count  ??? safer way to assure don't miss close?
   imf->incrReaderCount();
+  if (prefetchCount > 0)
+    imf->addReadAheadCache(cache_);
 
   /// If get here, the reader is open
   isOpen_ = true;
@@ -5956,28 +7699,129 @@ void CompressedVectorReaderImpl::setBuffers(vector<SourceDestBuffer>& dbufs)
   }
 
   dbufs_ = dbufs;
+
+  /// Once the decoders exist, point them at the new buffers too
+  for (size_t i = 0; i < channels_.size(); i++)
+  {
+    vector<SourceDestBuffer> theDbuf;
+    theDbuf.push_back(dbufs_[i]);
+
+    channels_[i].dbuf = dbufs_[i];
+    channels_[i].decoder->destBufferSetNew(theDbuf);
+  }
 }
 
 unsigned CompressedVectorReaderImpl::read(vector<SourceDestBuffer>& dbufs)
 {
-  /// don't checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__), read() will do it
+  /// don't checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__), readBlock() will do it
 
+  waitAsync();
   checkReaderOpen(__FILE__, __LINE__, __FUNCTION__);
 
   /// Check compatible with current dbufs
   setBuffers(dbufs);
 
-  return (read());
+  return (readBlock());
 }
 
 unsigned CompressedVectorReaderImpl::read()
+{
+  waitAsync();
+  return (readBlock());
+}
+
+std::future<unsigned> CompressedVectorReaderImpl::readAsync(vector<SourceDestBuffer>& dbufs)
+{
+  checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
+
+  /// The buffers of the previous read stay in use until it finishes
+  waitAsync();
+  checkReaderOpen(__FILE__, __LINE__, __FUNCTION__);
+
+  /// Check compatible with current dbufs here, so that mistakes are thrown to the caller
+  setBuffers(dbufs);
+
+  std::future<unsigned> result;
+  {
+    std::lock_guard<std::mutex> guard(asyncMutex_);
+    if (!asyncThread_.joinable())
+      asyncThread_ = std::thread(&CompressedVectorReaderImpl::asyncWorker, this);
+
+    asyncResult_  = std::promise<unsigned>();
+    result        = asyncResult_.get_future();
+    asyncPending_ = true;
+  }
+  asyncChanged_.notify_all();
+
+  return (result);
+}
+
+void CompressedVectorReaderImpl::waitAsync()
+{
+  std::unique_lock<std::mutex> guard(asyncMutex_);
+  asyncChanged_.wait(guard, [this] { return !asyncPending_; });
+}
+
+void CompressedVectorReaderImpl::stopAsync()
+{
+  if (!asyncThread_.joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> guard(asyncMutex_);
+    asyncChanged_.wait(guard, [this] { return !asyncPending_; });
+    stopAsync_ = true;
+  }
+  asyncChanged_.notify_all();
+  asyncThread_.join();
+  stopAsync_ = false;
+}
+
+void CompressedVectorReaderImpl::asyncWorker()
+{
+  /// Errors are handed to the caller through the future of the read
+  std::unique_lock<std::mutex> guard(asyncMutex_);
+  while (true)
+  {
+    asyncChanged_.wait(guard, [this] { return stopAsync_ || asyncPending_; });
+    if (stopAsync_)
+      return;
+
+    std::promise<unsigned> result(std::move(asyncResult_));
+    guard.unlock();
+    try
+    {
+      result.set_value(readBlock());
+    }
+    catch (...)
+    {
+      result.set_exception(std::current_exception());
+    }
+    guard.lock();
+
+    asyncPending_ = false;
+    asyncChanged_.notify_all();
+  }
+}
+
+unsigned CompressedVectorReaderImpl::readBlock()
 {
 #ifdef E57_MAX_VERBOSE
-  cout << "CompressedVectorReaderImpl::read() called" << endl; //???
+  cout << "CompressedVectorReaderImpl::readBlock() called" << endl; //???
 #endif
   checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
   checkReaderOpen(__FILE__, __LINE__, __FUNCTION__);
 
+  /// Any of the dbufs may have been rebased since they were bound, so check they still hold the same number of records
+  for (unsigned i = 1; i < dbufs_.size(); i++)
+  {
+    if (dbufs_[i].impl()->capacity() != dbufs_[0].impl()->capacity())
+    {
+      throw E57_EXCEPTION2(E57_ERROR_BUFFER_SIZE_MISMATCH, "pathName=" + dbufs_[i].impl()->pathName() + " firstCapacity="
+                                                             + toString(dbufs_[0].impl()->capacity()) + " capacity=" + toString(dbufs_[i].impl()->capacity()));
+    }
+  }
+
   /// Rewind all dbufs so start writing to them at beginning
   for (unsigned i = 0; i < dbufs_.size(); i++)
     dbufs_[i].impl()->rewind();
@@ -5988,6 +7832,7 @@ unsigned CompressedVectorReaderImpl::read()
     channels_[i].decoder->inputProcess(nullptr, 0);
 
   /// Loop until every dbuf is full or we have reached end of the binary section.
+  /// The worker carries on reading ahead after returning, so the next call finds its first packets already in the cache.
   while (1)
   {
     /// Find the earliest packet position for channels that are still hungry
@@ -5998,10 +7843,59 @@ unsigned CompressedVectorReaderImpl::read()
     if (earliestPacketLogicalOffset == E57_UINT64_MAX)
       break;
 
-    /// Feed packet to the hungry decoders
-    feedPacketToDecoders(earliestPacketLogicalOffset);
+    /// Make room in cache for all the packets the channels are currently reading from, and start reading ahead of them
+    adaptCache();
+
+    /// Feed packet to the hungry decoders, or a window of packets if they run in parallel.
+    /// The window leaves the read-ahead entries alone, and one entry free for looking past its end.
+    unsigned windowPacketCount = 0;
+    if (decoderPool_ && cache_->packetCount() > cache_->prefetchCount() + 1)
+      windowPacketCount = std::min(cache_->packetCount() - cache_->prefetchCount() - 1, static_cast<unsigned>(E57_DECODE_WINDOW_PACKETS));
+    if (windowPacketCount > 0)
+      feedWindowToDecoders(earliestPacketLogicalOffset, windowPacketCount);
+    else
+      feedPacketToDecoders(earliestPacketLogicalOffset);
+  }
+
+  /// A channel whose char array filled up stopped at the string that didn't fit, while the others may have gone further.
+  /// Return only the records all channels have, and move the channels that went further back to that record for the next read.
+  /// String channels go back to where they stored the record, rather than decoding their bytestream again from the start.
+  uint64_t blockedRecordIndex = E57_UINT64_MAX;
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    if (channels_[i].decoder->isOutputBlocked())
+      blockedRecordIndex = min(blockedRecordIndex, channels_[i].decoder->totalRecordsCompleted());
+  }
+  if (blockedRecordIndex != E57_UINT64_MAX)
+  {
+    cache_->stopPrefetch();
+    if (!seekIndexReady_)
+      seekIndexInit();
+
+    for (unsigned i = 0; i < channels_.size(); i++)
+    {
+      DecodeChannel* chan      = &channels_[i];
+      uint64_t       completed = chan->decoder->totalRecordsCompleted();
+      if (completed <= blockedRecordIndex)
+        continue;
+
+      unsigned keepCount = chan->dbuf.impl()->nextIndex() - static_cast<unsigned>(completed - blockedRecordIndex);
+      chan->dbuf.impl()->truncate(keepCount);
+
+      uint64_t                              byteOffset;
+      std::shared_ptr<BitpackStringDecoder> stringDecoder = std::dynamic_pointer_cast<BitpackStringDecoder>(chan->decoder);
+      if (stringDecoder)
+        byteOffset = stringDecoder->seekRecordAt(blockedRecordIndex, stringDecoder->storedStringByteOffset(keepCount));
+      else
+        byteOffset = chan->decoder->seekRecord(blockedRecordIndex);
+      if (byteOffset != E57_UINT64_MAX)
+        seekChannel(chan, i, byteOffset);
+    }
   }
 
+  /// Point the worker at the packets the channels stopped in, it reads ahead of them while the caller uses the records
+  adaptCache();
+
   /// Verify that each channel produced the same number of records
   unsigned outputCount = 0;
   for (unsigned i = 0; i < channels_.size(); i++)
@@ -6022,6 +7916,38 @@ unsigned CompressedVectorReaderImpl::read()
   return (outputCount);
 }
 
+void CompressedVectorReaderImpl::adaptCache()
+{
+  /// Count distinct packets the unfinished channels are positioned in.  Channel counts are small, so quadratic is fine.
+  unsigned packetsInUse = 0;
+  uint64_t leadOffset   = 0;
+  uint64_t keepOffset   = E57_UINT64_MAX;
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    if (channels_[i].inputFinished)
+      continue;
+    unsigned j = 0;
+    while (j < i && (channels_[j].inputFinished || channels_[j].currentPacketLogicalOffset != channels_[i].currentPacketLogicalOffset))
+      j++;
+    if (j == i)
+      packetsInUse++;
+    leadOffset = max(leadOffset, channels_[i].currentPacketLogicalOffset);
+    keepOffset = min(keepOffset, channels_[i].currentPacketLogicalOffset);
+  }
+
+  /// Keep one more entry for the next packet the leading channels will move to
+  if (cacheAutoSize_)
+  {
+    unsigned wanted = std::min(packetsInUse + 1, static_cast<unsigned>(E57_PACKET_CACHE_MAX)) + cache_->prefetchCount();
+    if (wanted > cache_->packetCount())
+      cache_->grow(wanted);
+  }
+
+  /// Have worker read the packets after the lead channel's, without disturbing the ones the other channels still need
+  if (packetsInUse > 0)
+    cache_->prefetch(leadOffset, keepOffset, sectionEndLogicalOffset_);
+}
+
 uint64_t CompressedVectorReaderImpl::earliestPacketNeededForInput()
 {
   uint64_t earliestPacketLogicalOffset = E57_UINT64_MAX;
@@ -6110,60 +8036,290 @@ void CompressedVectorReaderImpl::feedPacketToDecoders(uint64_t currentPacketLogi
     }
   }
 
-  /// Skip over any index or empty packets to next data packet.
-  nextPacketLogicalOffset = findNextDataPacket(nextPacketLogicalOffset);
+  /// Skip over any index or empty packets to next data packet.
+  nextPacketLogicalOffset = findNextDataPacket(nextPacketLogicalOffset);
+
+  /// If some channel has exhausted this packet, find next data packet and update currentPacketLogicalOffset for all interested channels.
+  if (channelHasExhaustedPacket)
+  {
+    if (nextPacketLogicalOffset < E57_UINT64_MAX)
+    { //??? huh?
+      /// Get packet at nextPacketLogicalOffset into memory.
+      char*                       anyPacket  = nullptr;
+      std::unique_ptr<PacketLock> packetLock = cache_->lock(nextPacketLogicalOffset, anyPacket);
+      DataPacket*                 dpkt       = reinterpret_cast<DataPacket*>(anyPacket);
+
+      /// Got a data packet, update the channels with exhausted input
+      for (unsigned i = 0; i < channels_.size(); i++)
+      {
+        DecodeChannel* chan = &channels_[i];
+        if (chan->currentPacketLogicalOffset == currentPacketLogicalOffset && chan->isInputBlocked())
+        {
+          chan->currentPacketLogicalOffset   = nextPacketLogicalOffset;
+          chan->currentBytestreamBufferIndex = 0;
+
+          /// It is OK if the next packet doesn't contain any data for this channel, will skip packet on next iter of loop
+          chan->currentBytestreamBufferLength = dpkt->getBytestreamBufferLength(chan->bytestreamNumber);
+
+#ifdef E57_MAX_VERBOSE
+          cout << "  set new stream buffer for channel[" << i << "], length=" << chan->currentBytestreamBufferLength << endl;
+#endif
+          /// ??? perform flush if new packet flag set?
+        }
+      }
+    }
+    else
+    {
+      /// Reached end without finding data packet, mark exhausted channels as finished
+#ifdef E57_MAX_VERBOSE
+      cout << "  at end of data packets" << endl;
+#endif
+      if (nextPacketLogicalOffset >= sectionEndLogicalOffset_)
+      {
+        for (unsigned i = 0; i < channels_.size(); i++)
+        {
+          DecodeChannel* chan = &channels_[i];
+          if (chan->currentPacketLogicalOffset == currentPacketLogicalOffset && chan->isInputBlocked())
+          {
+#ifdef E57_MAX_VERBOSE
+            cout << "  Marking channel[" << i << "] as finished" << endl;
+#endif
+            chan->inputFinished = true;
+          }
+        }
+      }
+    }
+  }
+}
+
+void CompressedVectorReaderImpl::feedWindowToDecoders(uint64_t firstPacketLogicalOffset, unsigned windowPacketCount)
+{
+  /// Lock a run of consecutive data packets, starting with the earliest one a hungry channel needs.
+  /// Each channel then eats its way through the window on its own thread, stopping when its dbuf is full or it runs off the end of the window.
+  std::vector<std::unique_ptr<PacketLock>> packetLocks;
+  std::vector<uint64_t>                    offsets;
+  std::vector<DataPacket*>                 packets;
+  uint64_t                                 nextPacketLogicalOffset = firstPacketLogicalOffset;
+  while (nextPacketLogicalOffset < E57_UINT64_MAX && packets.size() < windowPacketCount)
+  {
+    char* anyPacket = nullptr;
+    packetLocks.push_back(cache_->lock(nextPacketLogicalOffset, anyPacket));
+    DataPacket* dpkt = reinterpret_cast<DataPacket*>(anyPacket);
+
+    /// Double check that have a data packet.  Should have already determined this.
+    if (dpkt->packetType != E57_DATA_PACKET)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "packetType=" + toString(dpkt->packetType));
+
+    offsets.push_back(nextPacketLogicalOffset);
+    packets.push_back(dpkt);
+
+    /// Skip over any index or empty packets to next data packet.
+    nextPacketLogicalOffset = findNextDataPacket(nextPacketLogicalOffset + dpkt->packetLogicalLengthMinus1 + 1);
+  }
+
+  decoderPool_->run(channels_.size(), [&](size_t i) { feedChannelFromWindow(&channels_[i], offsets, packets); });
+  packetLocks.clear();
+
+  /// Move the channels that have exhausted the last packet of the window on to the packet after it, or mark them finished if there is none.
+  uint64_t lastPacketLogicalOffset = offsets.back();
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    DecodeChannel* chan = &channels_[i];
+    if (chan->currentPacketLogicalOffset != lastPacketLogicalOffset || chan->inputFinished || !chan->isInputBlocked())
+      continue;
+
+    if (nextPacketLogicalOffset < E57_UINT64_MAX)
+    {
+      char*                       anyPacket  = nullptr;
+      std::unique_ptr<PacketLock> packetLock = cache_->lock(nextPacketLogicalOffset, anyPacket);
+      DataPacket*                 dpkt       = reinterpret_cast<DataPacket*>(anyPacket);
+
+      chan->currentPacketLogicalOffset    = nextPacketLogicalOffset;
+      chan->currentBytestreamBufferIndex  = 0;
+      chan->currentBytestreamBufferLength = dpkt->getBytestreamBufferLength(chan->bytestreamNumber);
+    }
+    else
+      chan->inputFinished = true;
+  }
+}
+
+void CompressedVectorReaderImpl::feedChannelFromWindow(DecodeChannel* chan, const std::vector<uint64_t>& offsets, const std::vector<DataPacket*>& packets)
+{
+  /// Channels positioned after the window wait for a later one
+  size_t k = 0;
+  while (k < offsets.size() && offsets[k] != chan->currentPacketLogicalOffset)
+    k++;
+  if (k == offsets.size())
+    return;
+
+  while (!chan->isOutputBlocked() && !chan->inputFinished)
+  {
+    if (chan->isInputBlocked())
+    {
+      /// The last packet is left for feedWindowToDecoders(), which can look beyond the window
+      if (k + 1 == offsets.size())
+        return;
+
+      /// It is OK if the next packet doesn't contain any data for this channel, the loop will skip it
+      k++;
+      chan->currentPacketLogicalOffset    = offsets[k];
+      chan->currentBytestreamBufferIndex  = 0;
+      chan->currentBytestreamBufferLength = packets[k]->getBytestreamBufferLength(chan->bytestreamNumber);
+      continue;
+    }
+
+    /// Get bytestream buffer for this channel from packet, and calc where we are in it
+    unsigned bsbLength;
+    char*    bsbStart = packets[k]->getBytestream(chan->bytestreamNumber, bsbLength);
+
+    /// Double check we are not off end of buffer
+    if (chan->currentBytestreamBufferIndex > bsbLength)
+    {
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL,
+                           "currentBytestreamBufferIndex =" + toString(chan->currentBytestreamBufferIndex) + " bsbLength=" + toString(bsbLength));
+    }
+    char*  uneatenStart  = &bsbStart[chan->currentBytestreamBufferIndex];
+    size_t uneatenLength = bsbLength - chan->currentBytestreamBufferIndex;
+
+    /// Feed into decoder, and adjust counts of bytestream location
+    size_t bytesProcessed = chan->decoder->inputProcess(uneatenStart, uneatenLength);
+    chan->currentBytestreamBufferIndex += bytesProcessed;
+
+    /// A decoder that took nothing and still wants more is retried on the next round, as feedPacketToDecoders() would
+    if (bytesProcessed == 0 && !chan->isInputBlocked() && !chan->isOutputBlocked())
+      return;
+  }
+}
+
+void CompressedVectorReaderImpl::seek(uint64_t recordNumber, const std::vector<uint64_t>& stringByteOffsets)
+{
+  /// Like seek(recordNumber), except that string channels with a known byte offset for the record start there, rather than decoding their way to it
+  seek(recordNumber);
+
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    if (stringByteOffsets.at(i) == E57_UINT64_MAX)
+      continue;
+
+    DecodeChannel*                        chan    = &channels_[i];
+    std::shared_ptr<BitpackStringDecoder> decoder = std::dynamic_pointer_cast<BitpackStringDecoder>(chan->decoder);
+    if (!decoder)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "channel=" + toString(i) + " byteOffset=" + toString(stringByteOffsets[i]));
+    seekChannel(chan, i, decoder->seekRecordAt(recordNumber, stringByteOffsets[i]));
+  }
+}
+
+std::vector<std::vector<uint64_t>> CompressedVectorReaderImpl::findStringRecords(const std::vector<uint64_t>& recordNumbers)
+{
+  /// Walk the bytestreams of the string channels reading only the length prefixes, skipping over the strings themselves.
+  /// recordNumbers must be increasing.  Returns, per channel, the byte offset in the bytestream of each record, E57_UINT64_MAX if not a string channel.
+  struct StringWalk
+  {
+    size_t   target;       /// index in recordNumbers of next record to find
+    uint64_t record;       /// record whose prefix or string is being read
+    uint64_t skipLength;   /// bytes left in the string of record
+    int      prefixRead;   /// prefix bytes read so far, zero at the start of a record
+    int      prefixLength; /// prefix length, given by the first byte of the prefix
+    uint8_t  prefixBytes[8];
+  };
+
+  vector<vector<uint64_t>> byteOffsets(channels_.size(), vector<uint64_t>(recordNumbers.size(), E57_UINT64_MAX));
+  vector<StringWalk>       walks(channels_.size());
+  unsigned                 unfinished = 0;
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    walks[i]        = StringWalk();
+    walks[i].target = recordNumbers.size();
+    if (!recordNumbers.empty() && std::dynamic_pointer_cast<BitpackStringDecoder>(channels_[i].decoder))
+    {
+      walks[i].target = 0;
+      unfinished++;
+    }
+  }
+  if (unfinished == 0)
+    return (byteOffsets);
+
+  if (!seekIndexReady_)
+    seekIndexInit();
 
-  /// If some channel has exhausted this packet, find next data packet and update currentPacketLogicalOffset for all interested channels.
-  if (channelHasExhaustedPacket)
+  for (size_t p = 0; unfinished > 0; p++)
   {
-    if (nextPacketLogicalOffset < E57_UINT64_MAX)
-    { //??? huh?
-      /// Get packet at nextPacketLogicalOffset into memory.
-      char*                       anyPacket  = nullptr;
-      std::unique_ptr<PacketLock> packetLock = cache_->lock(nextPacketLogicalOffset, anyPacket);
-      DataPacket*                 dpkt       = reinterpret_cast<DataPacket*>(anyPacket);
-
-      /// Got a data packet, update the channels with exhausted input
-      for (unsigned i = 0; i < channels_.size(); i++)
-      {
-        DecodeChannel* chan = &channels_[i];
-        if (chan->currentPacketLogicalOffset == currentPacketLogicalOffset && chan->isInputBlocked())
-        {
-          chan->currentPacketLogicalOffset   = nextPacketLogicalOffset;
-          chan->currentBytestreamBufferIndex = 0;
+    if (p == seekPacketOffsets_.size() && !seekIndexExtend())
+      break;
 
-          /// It is OK if the next packet doesn't contain any data for this channel, will skip packet on next iter of loop
-          chan->currentBytestreamBufferLength = dpkt->getBytestreamBufferLength(chan->bytestreamNumber);
+    char*                       anyPacket  = nullptr;
+    std::unique_ptr<PacketLock> packetLock = cache_->lock(seekPacketOffsets_[p], anyPacket);
+    DataPacket*                 dpkt       = reinterpret_cast<DataPacket*>(anyPacket);
 
-#ifdef E57_MAX_VERBOSE
-          cout << "  set new stream buffer for channel[" << i << "], length=" << chan->currentBytestreamBufferLength << endl;
-#endif
-          /// ??? perform flush if new packet flag set?
-        }
-      }
-    }
-    else
+    for (unsigned i = 0; i < channels_.size(); i++)
     {
-      /// Reached end without finding data packet, mark exhausted channels as finished
-#ifdef E57_MAX_VERBOSE
-      cout << "  at end of data packets" << endl;
-#endif
-      if (nextPacketLogicalOffset >= sectionEndLogicalOffset_)
+      StringWalk& w = walks[i];
+      if (w.target == recordNumbers.size())
+        continue;
+
+      unsigned       bsbLength;
+      const uint8_t* bsb = reinterpret_cast<const uint8_t*>(dpkt->getBytestream(channels_[i].bytestreamNumber, bsbLength));
+      size_t         j   = 0;
+      while (j < bsbLength && w.target < recordNumbers.size())
       {
-        for (unsigned i = 0; i < channels_.size(); i++)
+        if (w.skipLength > 0)
         {
-          DecodeChannel* chan = &channels_[i];
-          if (chan->currentPacketLogicalOffset == currentPacketLogicalOffset && chan->isInputBlocked())
+          size_t n = static_cast<size_t>(min(w.skipLength, static_cast<uint64_t>(bsbLength - j)));
+          j += n;
+          w.skipLength -= n;
+          continue;
+        }
+
+        if (w.prefixRead == 0)
+        {
+          if (recordNumbers[w.target] == w.record)
           {
-#ifdef E57_MAX_VERBOSE
-            cout << "  Marking channel[" << i << "] as finished" << endl;
-#endif
-            chan->inputFinished = true;
+            byteOffsets[i][w.target++] = seekStreamStarts_[i][p] + j;
+            if (w.target == recordNumbers.size())
+              unfinished--;
+            continue;
           }
+
+          /// Least significant bit of first byte tells how long prefix is, same as BitpackStringDecoder
+          w.prefixLength = (bsb[j] & 0x01) ? 8 : 1;
+        }
+        w.prefixBytes[w.prefixRead++] = bsb[j++];
+
+        if (w.prefixRead == w.prefixLength)
+        {
+          /// Length is in b63-b1 of the little endian prefix
+          w.skipLength = static_cast<uint64_t>(w.prefixBytes[0]) >> 1;
+          for (int b = 1; b < w.prefixLength; b++)
+            w.skipLength += static_cast<uint64_t>(w.prefixBytes[b]) << (b * 8 - 1);
+          w.prefixRead = 0;
+          w.record++;
         }
       }
     }
   }
+
+  return (byteOffsets);
+}
+
+void CompressedVectorReaderImpl::shareSeekIndex(const CompressedVectorReaderImpl& other)
+{
+  /// The per channel stream offsets only carry over between readers of the same fields in the same order
+  if (other.cVector_ != cVector_ || other.channels_.size() != channels_.size())
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "imageFileName=" + cVector_->imageFileName() + " cvPathName=" + cVector_->pathName());
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    if (other.channels_[i].bytestreamNumber != channels_[i].bytestreamNumber)
+      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "channel=" + toString(i) + " bytestreamNumber=" + toString(channels_[i].bytestreamNumber));
+  }
+
+  if (!other.seekIndexReady_)
+    return;
+  seekIndexReady_        = true;
+  seekTreePackets_       = other.seekTreePackets_;
+  seekScanLogicalOffset_ = other.seekScanLogicalOffset_;
+  seekPacketOffsets_     = other.seekPacketOffsets_;
+  seekStreamStarts_      = other.seekStreamStarts_;
+  seekStreamEnds_        = other.seekStreamEnds_;
 }
 
 uint64_t CompressedVectorReaderImpl::findNextDataPacket(uint64_t nextPacketLogicalOffset)
@@ -6197,12 +8353,177 @@ uint64_t CompressedVectorReaderImpl::findNextDataPacket(uint64_t nextPacketLogic
   return (E57_UINT64_MAX);
 }
 
-void CompressedVectorReaderImpl::seek(uint64_t /*recordNumber*/)
+void CompressedVectorReaderImpl::seek(uint64_t recordNumber)
 {
+  waitAsync();
   checkImageFileOpen(__FILE__, __LINE__, __FUNCTION__);
+  checkReaderOpen(__FILE__, __LINE__, __FUNCTION__);
+
+  /// It is not an error to seek to one past the last record
+  if (recordNumber > maxRecordCount_)
+  {
+    throw E57_EXCEPTION2(E57_ERROR_BAD_API_ARGUMENT, "recordNumber=" + toString(recordNumber) + " maxRecordCount=" + toString(maxRecordCount_)
+                                                       + " imageFileName=" + cVector_->imageFileName() + " cvPathName=" + cVector_->pathName());
+  }
+
+  /// Packets read ahead of the old position are unlikely to be wanted, so stop the worker before the channels move
+  cache_->stopPrefetch();
+
+  if (!seekIndexReady_)
+    seekIndexInit();
+
+  /// Each decoder knows where the record starts in its own bytestream, position its channel on the data packet holding that byte.
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    DecodeChannel* chan       = &channels_[i];
+    uint64_t       byteOffset = chan->decoder->seekRecord(recordNumber);
+
+    /// Decoders that can't locate a record (e.g. strings) decode up to it from their current input position.
+    if (byteOffset != E57_UINT64_MAX)
+      seekChannel(chan, i, byteOffset);
+  }
+}
+
+void CompressedVectorReaderImpl::seekIndexInit()
+{
+  seekPacketOffsets_.clear();
+  seekTreePackets_.clear();
+  seekStreamStarts_.assign(channels_.size(), vector<uint64_t>());
+  seekStreamEnds_.assign(channels_.size(), 0);
+  seekScanLogicalOffset_ = dataLogicalOffset_;
+
+  /// If the writer left an index, use it to visit only the data packets, rather than walking every packet in the section.
+  /// The record numbers in the index aren't enough by themselves, because the bytestreams of a packet don't all start at the same record,
+  /// so the data packet headers are still read to find where each bytestream is.
+  if (indexLogicalOffset_ != 0)
+    seekIndexReadTree(indexLogicalOffset_, 5);
+
+  seekIndexReady_ = true;
+}
+
+void CompressedVectorReaderImpl::seekIndexReadTree(uint64_t indexLogicalOffset, unsigned maxLevel)
+{
+  std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
+
+  if (indexLogicalOffset == 0 || indexLogicalOffset >= sectionEndLogicalOffset_)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "indexLogicalOffset=" + toString(indexLogicalOffset));
+
+  /// Read header first to get length, then the entries.  IndexPacket is big, so keep it off the stack.
+  std::unique_ptr<IndexPacket> ipkt(new IndexPacket);
+  const size_t                 headerLength = sizeof(IndexPacket) - sizeof(ipkt->entries);
+  cache_->read(indexLogicalOffset, reinterpret_cast<char*>(ipkt.get()), headerLength);
+
+  /// Any padding past the last possible entry isn't needed
+  size_t packetLength = min(static_cast<size_t>(ipkt->packetLogicalLengthMinus1) + 1, sizeof(IndexPacket));
+  if (packetLength > headerLength)
+    cache_->read(indexLogicalOffset + headerLength, reinterpret_cast<char*>(ipkt.get()) + headerLength, packetLength - headerLength);
+
+#ifdef E57_BIGENDIAN
+  ipkt->swab(false);
+#endif
+  ipkt->verify(0, maxRecordCount_);
+
+  /// Each level of tree must be below its parent, this also guarantees the walk terminates
+  if (ipkt->indexLevel > maxLevel)
+    throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "indexLevel=" + toString(ipkt->indexLevel) + " maxLevel=" + toString(maxLevel));
+
+  for (unsigned i = 0; i < ipkt->entryCount; i++)
+  {
+    uint64_t chunkLogicalOffset = imf->file_->physicalToLogical(ipkt->entries[i].chunkPhysicalOffset);
+    if (ipkt->indexLevel > 0)
+      seekIndexReadTree(chunkLogicalOffset, ipkt->indexLevel - 1);
+    else
+      seekTreePackets_.push_back(chunkLogicalOffset);
+  }
+}
+
+bool CompressedVectorReaderImpl::seekIndexExtend()
+{
+  std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
+
+  /// Find the next data packet after the ones already indexed
+  uint64_t packetLogicalOffset = 0;
+  if (indexLogicalOffset_ != 0)
+  {
+    if (seekPacketOffsets_.size() >= seekTreePackets_.size())
+      return (false);
+    packetLogicalOffset = seekTreePackets_[seekPacketOffsets_.size()];
+
+    /// Be paranoid about offsets that came from the file
+    if (packetLogicalOffset >= sectionEndLogicalOffset_ || (!seekPacketOffsets_.empty() && packetLogicalOffset <= seekPacketOffsets_.back()))
+      throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "packetLogicalOffset=" + toString(packetLogicalOffset));
+  }
+  else
+  {
+    /// No index, so walk the packet headers skipping over any index or empty packets.
+    /// All packets have length in same place, so can use EmptyPacketHeader to skip to next packet.
+    while (1)
+    {
+      if (seekScanLogicalOffset_ >= sectionEndLogicalOffset_)
+        return (false);
+
+      EmptyPacketHeader header;
+      cache_->read(seekScanLogicalOffset_, reinterpret_cast<char*>(&header), sizeof(header));
+      header.swab();
+      if (header.packetType == E57_DATA_PACKET)
+        break;
+      seekScanLogicalOffset_ += header.packetLogicalLengthMinus1 + 1;
+    }
+    packetLogicalOffset = seekScanLogicalOffset_;
+  }
+
+  /// Only need the header and bytestreamBufferLength array, not the whole packet
+  DataPacketHeader header;
+  cache_->read(packetLogicalOffset, reinterpret_cast<char*>(&header), sizeof(header));
+  header.swab();
+  header.verify();
+
+  vector<uint16_t> bufferLengths(header.bytestreamCount);
+  cache_->read(packetLogicalOffset + sizeof(header), reinterpret_cast<char*>(bufferLengths.data()), bufferLengths.size() * sizeof(uint16_t));
+
+  seekPacketOffsets_.push_back(packetLogicalOffset);
+  for (unsigned i = 0; i < channels_.size(); i++)
+  {
+    unsigned bytestreamNumber = channels_[i].bytestreamNumber;
+    if (bytestreamNumber >= bufferLengths.size())
+      throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "bytestreamNumber=" + toString(bytestreamNumber) + " bytestreamCount=" + toString(header.bytestreamCount));
+
+    uint16_t bufferLength = bufferLengths[bytestreamNumber];
+#ifdef E57_BIGENDIAN
+    swab(bufferLength);
+#endif
+    seekStreamStarts_[i].push_back(seekStreamEnds_[i]);
+    seekStreamEnds_[i] += bufferLength;
+  }
+
+  if (indexLogicalOffset_ == 0)
+    seekScanLogicalOffset_ = packetLogicalOffset + header.packetLogicalLengthMinus1 + 1;
+  return (true);
+}
+
+void CompressedVectorReaderImpl::seekChannel(DecodeChannel* chan, unsigned channelIndex, uint64_t byteOffset)
+{
+  /// Find the data packet whose bytestream buffer holds byteOffset, extending the chunk index as far as needed.
+  /// Byte zero is always found in the first data packet, even if its buffer is empty (so channels without input don't scan the whole section).
+  size_t packetIndex = 0;
+  if (seekPacketOffsets_.empty() && !seekIndexExtend())
+    throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "dataLogicalOffset=" + toString(dataLogicalOffset_));
+  if (byteOffset > 0)
+  {
+    while (seekStreamEnds_[channelIndex] <= byteOffset && seekIndexExtend())
+      ;
+    vector<uint64_t>& starts = seekStreamStarts_[channelIndex];
+    packetIndex              = std::upper_bound(starts.begin(), starts.end(), byteOffset) - starts.begin() - 1;
+  }
 
-  ///!!! implement
-  throw E57_EXCEPTION1(E57_ERROR_NOT_IMPLEMENTED);
+  uint64_t packetStart = seekStreamStarts_[channelIndex][packetIndex];
+  uint64_t packetEnd   = (packetIndex + 1 < seekPacketOffsets_.size()) ? seekStreamStarts_[channelIndex][packetIndex + 1] : seekStreamEnds_[channelIndex];
+
+  /// Seeking past the end of the bytestream (e.g. to one past last record) just leaves the channel with no input.
+  chan->currentPacketLogicalOffset    = seekPacketOffsets_[packetIndex];
+  chan->currentBytestreamBufferIndex  = static_cast<size_t>(min(byteOffset, packetEnd) - packetStart);
+  chan->currentBytestreamBufferLength = static_cast<size_t>(packetEnd - packetStart);
+  chan->inputFinished                 = false;
 }
 
 bool CompressedVectorReaderImpl::isOpen()
@@ -6216,8 +8537,32 @@ std::shared_ptr<CompressedVectorNodeImpl> CompressedVectorReaderImpl::compressed
   return (cVector_);
 }
 
+unsigned CompressedVectorReaderImpl::cachePacketCount()
+{
+  waitAsync();
+  checkReaderOpen(__FILE__, __LINE__, __FUNCTION__);
+  return (cache_->packetCount());
+}
+
+uint64_t CompressedVectorReaderImpl::cacheHitCount()
+{
+  waitAsync();
+  checkReaderOpen(__FILE__, __LINE__, __FUNCTION__);
+  return (cache_->hitCount());
+}
+
+uint64_t CompressedVectorReaderImpl::cacheMissCount()
+{
+  waitAsync();
+  checkReaderOpen(__FILE__, __LINE__, __FUNCTION__);
+  return (cache_->missCount());
+}
+
 void CompressedVectorReaderImpl::close()
 {
+  /// Let a background read finish before tearing down what it uses
+  stopAsync();
+
   /// Before anything that can throw, decrement reader count
   std::shared_ptr<ImageFileImpl> imf(cVector_->destImageFile_);
   imf->decrReaderCount();
@@ -6229,8 +8574,11 @@ void CompressedVectorReaderImpl::close()
     return;
 
   /// Destroy decoders
+  decoderPool_.reset();
   channels_.clear();
 
+  /// Deleting the cache stops its worker
+  imf->removeReadAheadCache(cache_);
   delete cache_;
   cache_ = nullptr;
 
@@ -6268,6 +8616,7 @@ void CompressedVectorReaderImpl::checkReaderOpen(const char* srcFileName, int sr
 
 void CompressedVectorReaderImpl::dump(int indent, std::ostream& os)
 {
+  waitAsync();
   os << space(indent) << "isOpen:" << isOpen_ << endl;
 
   for (unsigned i = 0; i < dbufs_.size(); i++)
@@ -6291,6 +8640,12 @@ void CompressedVectorReaderImpl::dump(int indent, std::ostream& os)
   os << space(indent) << "recordCount:             " << recordCount_ << endl;
   os << space(indent) << "maxRecordCount:          " << maxRecordCount_ << endl;
   os << space(indent) << "sectionEndLogicalOffset: " << sectionEndLogicalOffset_ << endl;
+  os << space(indent) << "cacheAutoSize:           " << cacheAutoSize_ << endl;
+  if (cache_)
+  {
+    os << space(indent) << "cache:" << endl;
+    cache_->dump(indent + 4, os);
+  }
 }
 
 //================================================================
@@ -6330,7 +8685,7 @@ std::shared_ptr<Encoder> Encoder::EncoderFactory(unsigned bytestreamNumber, std:
     /// Constuct Integer encoder with appropriate register size, based on number of bits stored.
     if (bitsPerRecord == 0)
     {
-      std::shared_ptr<Encoder> encoder(new ConstantIntegerEncoder(bytestreamNumber, sbuf, ini->minimum()));
+      std::shared_ptr<Encoder> encoder(new ConstantIntegerEncoder(false, bytestreamNumber, sbuf, ini->minimum(), 1.0, 0.0));
       return (encoder);
     }
     else if (bitsPerRecord <= 8)
@@ -6372,7 +8727,7 @@ std::shared_ptr<Encoder> Encoder::EncoderFactory(unsigned bytestreamNumber, std:
     /// Constuct ScaledInteger encoder with appropriate register size, based on number of bits stored.
     if (bitsPerRecord == 0)
     {
-      std::shared_ptr<Encoder> encoder(new ConstantIntegerEncoder(bytestreamNumber, sbuf, sini->minimum()));
+      std::shared_ptr<Encoder> encoder(new ConstantIntegerEncoder(true, bytestreamNumber, sbuf, sini->minimum(), sini->scale(), sini->offset()));
       return (encoder);
     }
     else if (bitsPerRecord <= 8)
@@ -6431,7 +8786,7 @@ void Encoder::dump(int indent, std::ostream& os)
 
 BitpackEncoder::BitpackEncoder(unsigned bytestreamNumber, SourceDestBuffer& sbuf, unsigned outputMaxSize, unsigned alignmentSize)
 : Encoder(bytestreamNumber), sourceBuffer_(sbuf.impl()), outBuffer_(outputMaxSize), outBufferFirst_(0), outBufferEnd_(0),
-  outBufferAlignmentSize_(alignmentSize), currentRecordIndex_(0)
+  outBufferAlignmentSize_(alignmentSize), outputByteCount_(0), currentRecordIndex_(0)
 {}
 
 unsigned BitpackEncoder::sourceBufferNextIndex()
@@ -6474,6 +8829,7 @@ void BitpackEncoder::outputRead(char* dest, const size_t byteCount)
 
   /// Advance head pointer.
   outBufferFirst_ += byteCount;
+  outputByteCount_ += byteCount;
 
   /// Don't slide remaining data down now, wait until do some more processing (that's when data needs to be aligned).
 }
@@ -6548,6 +8904,12 @@ void BitpackEncoder::outBufferShiftDown()
   outBufferEnd_   = newEnd;
 }
 
+size_t BitpackEncoder::outBufferEndAfterShiftDown()
+{
+  /// Available data is moved to end at the next multiple of outBufferAlignmentSize_
+  return ((outputAvailable() + outBufferAlignmentSize_ - 1) / outBufferAlignmentSize_ * outBufferAlignmentSize_);
+}
+
 #ifdef E57_DEBUG
 void BitpackEncoder::dump(int indent, std::ostream& os)
 {
@@ -6572,7 +8934,22 @@ void BitpackEncoder::dump(int indent, std::ostream& os)
 
 BitpackFloatEncoder::BitpackFloatEncoder(unsigned bytestreamNumber, SourceDestBuffer& sbuf, unsigned outputMaxSize, FloatPrecision precision)
 : BitpackEncoder(bytestreamNumber, sbuf, outputMaxSize, (precision == FloatPrecision::E57_SINGLE) ? sizeof(float) : sizeof(double)), precision_(precision)
-{}
+{
+  selectLoadKernel();
+}
+
+void BitpackFloatEncoder::sourceBufferSetNew(std::vector<SourceDestBuffer>& sbufs)
+{
+  BitpackEncoder::sourceBufferSetNew(sbufs);
+  selectLoadKernel();
+}
+
+void BitpackFloatEncoder::selectLoadKernel()
+{
+  /// Only the kernel matching precision_ is ever called
+  loadFloats_  = sourceBuffer_->loadFloatsKernel<float>();
+  loadDoubles_ = sourceBuffer_->loadFloatsKernel<double>();
+}
 
 uint64_t BitpackFloatEncoder::processRecords(size_t recordCount)
 {
@@ -6599,35 +8976,29 @@ uint64_t BitpackFloatEncoder::processRecords(size_t recordCount)
   if (recordCount > maxOutputRecords)
     recordCount = maxOutputRecords;
 
+  /// Load all the records straight into outBuffer_ in one call, then swab them if necessary
+  SourceDestBufferImpl* sbuf = sourceBuffer_.get();
   if (precision_ == FloatPrecision::E57_SINGLE)
   {
     /// Form the starting address for next available location in outBuffer
     float* outp = reinterpret_cast<float*>(&outBuffer_[outBufferEnd_]);
 
-    /// Copy floats from sourceBuffer_ to outBuffer_
-    for (unsigned i = 0; i < recordCount; i++)
-    {
-      outp[i] = sourceBuffer_->getNextFloat();
-#ifdef E57_MAX_VERBOSE
-      cout << "encoding float: " << outp[i] << endl;
+    (sbuf->*loadFloats_)(outp, recordCount);
+#ifdef E57_BIGENDIAN
+    for (size_t i = 0; i < recordCount; i++)
+      SWAB(&outp[i]);
 #endif
-      SWAB(&outp[i]); /// swab if necessary
-    }
   }
   else
   { /// E57_DOUBLE precision
     /// Form the starting address for next available location in outBuffer
     double* outp = reinterpret_cast<double*>(&outBuffer_[outBufferEnd_]);
 
-    /// Copy doubles from sourceBuffer_ to outBuffer_
-    for (unsigned i = 0; i < recordCount; i++)
-    {
-      outp[i] = sourceBuffer_->getNextDouble();
-#ifdef E57_MAX_VERBOSE
-      cout << "encoding double: " << outp[i] << endl;
+    (sbuf->*loadDoubles_)(outp, recordCount);
+#ifdef E57_BIGENDIAN
+    for (size_t i = 0; i < recordCount; i++)
+      SWAB(&outp[i]);
 #endif
-      SWAB(&outp[i]); /// swab if necessary
-    }
   }
 
   /// Update end of outBuffer
@@ -6650,6 +9021,24 @@ float BitpackFloatEncoder::bitsPerRecord()
   return ((precision_ == FloatPrecision::E57_SINGLE) ? 32.0F : 64.0F);
 }
 
+uint64_t BitpackFloatEncoder::outputRecordNumber()
+{
+  /// Floats are never split across bytes already read and bytes to come
+  return (outputByteCount_ / ((precision_ == FloatPrecision::E57_SINGLE) ? sizeof(float) : sizeof(double)));
+}
+
+bool BitpackFloatEncoder::outputAvailableAfter(size_t recordCount, size_t& byteCount)
+{
+  size_t typeSize = (precision_ == FloatPrecision::E57_SINGLE) ? sizeof(float) : sizeof(double);
+
+  /// Same limit as processRecords()
+  if (recordCount > (outBuffer_.size() - outBufferEndAfterShiftDown()) / typeSize)
+    return (false);
+
+  byteCount = outputAvailable() + recordCount * typeSize;
+  return (true);
+}
+
 #ifdef E57_DEBUG
 void BitpackFloatEncoder::dump(int indent, std::ostream& os)
 {
@@ -6665,7 +9054,7 @@ void BitpackFloatEncoder::dump(int indent, std::ostream& os)
 
 BitpackStringEncoder::BitpackStringEncoder(unsigned bytestreamNumber, SourceDestBuffer& sbuf, unsigned outputMaxSize)
 : BitpackEncoder(bytestreamNumber, sbuf, outputMaxSize, 1), totalBytesProcessed_(0), isStringActive_(false), prefixComplete_(false), currentString_(),
-  currentCharPosition_(0)
+  currentCharPosition_(0), recordsBeforeOutput_(0)
 {}
 
 uint64_t BitpackStringEncoder::processRecords(size_t recordCount)
@@ -6744,24 +9133,25 @@ uint64_t BitpackStringEncoder::processRecords(size_t recordCount)
       /// Copy as much string as will fit in outBuffer
       size_t bytesToProcess = min(currentString_.length() - currentCharPosition_, bytesFree);
 
-      for (size_t i = 0; i < bytesToProcess; i++)
-        *outp++ = currentString_[currentCharPosition_ + i];
+      memcpy(outp, currentString_.data() + currentCharPosition_, bytesToProcess);
+      outp += bytesToProcess;
 
       currentCharPosition_ += bytesToProcess;
       totalBytesProcessed_ += bytesToProcess;
       bytesFree -= bytesToProcess;
 
-      /// Check if finished string
+      /// Check if finished string, remember where it ended for outputRecordNumber()
       if (currentCharPosition_ == currentString_.length())
       {
         isStringActive_ = false;
         recordsProcessed++;
+        recordEnds_.push_back(outputByteCount_ + static_cast<uint64_t>(outp - outBuffer_.data()) - outBufferFirst_);
       }
     }
     if (!isStringActive_ && recordsProcessed < recordCount)
     {
-      /// Get next string from sourceBuffer
-      currentString_       = sourceBuffer_->getNextString();
+      /// Get next string from sourceBuffer, without copying it
+      currentString_       = sourceBuffer_->getNextStringView();
       isStringActive_      = true;
       prefixComplete_      = false;
       currentCharPosition_ = 0;
@@ -6780,6 +9170,23 @@ uint64_t BitpackStringEncoder::processRecords(size_t recordCount)
   return (currentRecordIndex_);
 }
 
+uint64_t BitpackStringEncoder::outputRecordNumber()
+{
+  /// Strings have variable length, so count the strings that end before the next byte to be read
+  while (!recordEnds_.empty() && recordEnds_.front() <= outputByteCount_)
+  {
+    recordEnds_.pop_front();
+    recordsBeforeOutput_++;
+  }
+  return (recordsBeforeOutput_);
+}
+
+bool BitpackStringEncoder::outputAvailableAfter(size_t /*recordCount*/, size_t& /*byteCount*/)
+{
+  /// Output size depends on the string lengths
+  return (false);
+}
+
 bool BitpackStringEncoder::registerFlushToOutput()
 {
   /// Since have no registers in encoder, return success
@@ -7004,6 +9411,10 @@ size_t BitpackDecoder::inputProcess(const char* source, const size_t availableBy
     size_t firstWord       = inBufferFirstBit_ / bitsPerWord_;
     size_t firstNaturalBit = firstWord * bitsPerWord_;
     size_t endBit          = inBufferEndByte_ * 8;
+
+    /// After a seekRecord(), the first bit may be past the end of the input received so far.
+    if (endBit < inBufferFirstBit_)
+      return (availableByteCount - bytesUnsaved);
 #ifdef E57_MAX_VERBOSE
     cout << "  feeding aligned decoder " << endBit - inBufferFirstBit_ << " bits." << endl;
 #endif
@@ -7036,6 +9447,20 @@ void BitpackDecoder::stateReset()
   inBufferEndByte_  = 0;
 }
 
+uint64_t BitpackDecoder::seekRecord(uint64_t recordNumber)
+{
+  /// Records are packed back to back with a fixed number of bits, so can calculate the bit where recordNumber starts.
+  /// Input has to be fed from the natural word boundary containing that bit, so remember how many bits to skip in first word.
+  uint64_t bitOffset = recordNumber * bitsPerRecord();
+  uint64_t firstWord = bitOffset / bitsPerWord_;
+
+  stateReset();
+  inBufferFirstBit_   = static_cast<size_t>(bitOffset - firstWord * bitsPerWord_);
+  currentRecordIndex_ = recordNumber;
+
+  return (firstWord * bytesPerWord_);
+}
+
 void BitpackDecoder::inBufferShiftDown()
 {
   /// Move uneaten data down to beginning of inBuffer_.
@@ -7084,7 +9509,22 @@ void BitpackDecoder::dump(int indent, std::ostream& os)
 
 BitpackFloatDecoder::BitpackFloatDecoder(unsigned bytestreamNumber, SourceDestBuffer& dbuf, FloatPrecision precision, uint64_t maxRecordCount)
 : BitpackDecoder(bytestreamNumber, dbuf, (precision == FloatPrecision::E57_SINGLE) ? sizeof(float) : sizeof(double), maxRecordCount), precision_(precision)
-{}
+{
+  selectStoreKernel();
+}
+
+void BitpackFloatDecoder::destBufferSetNew(vector<SourceDestBuffer>& dbufs)
+{
+  BitpackDecoder::destBufferSetNew(dbufs);
+  selectStoreKernel();
+}
+
+void BitpackFloatDecoder::selectStoreKernel()
+{
+  /// Only the kernel matching precision_ is ever called
+  storeFloats_  = destBuffer_->storeFloatsKernel<float>();
+  storeDoubles_ = destBuffer_->storeFloatsKernel<double>();
+}
 
 size_t BitpackFloatDecoder::inputProcessAligned(const char* inbuf, const size_t firstBit, const size_t endBit)
 {
@@ -7128,40 +9568,41 @@ size_t BitpackFloatDecoder::inputProcessAligned(const char* inbuf, const size_t
   cout << "  n:" << n << endl; //???
 #endif
 
+  SourceDestBufferImpl* dbuf = destBuffer_.get();
+#ifdef E57_BIGENDIAN
+  /// Swab a block at a time into a local copy, then store the block
+  constexpr size_t blockSize = 256;
   if (precision_ == FloatPrecision::E57_SINGLE)
   {
-    /// Form the starting address for first data location in inBuffer
-    const float* inp = reinterpret_cast<const float*>(inbuf);
-
-    /// Copy floats from inbuf to destBuffer_
-    for (unsigned i = 0; i < n; i++)
+    float block[blockSize];
+    for (size_t i = 0; i < n; i += blockSize)
     {
-      float value = *inp;
-      SWAB(&value); /// swab if necessary
-#ifdef E57_MAX_VERBOSE
-      cout << "  got float value=" << value << endl;
-#endif
-      destBuffer_->setNextFloat(value);
-      inp++;
+      size_t blockCount = min(blockSize, n - i);
+      memcpy(block, inbuf + i * sizeof(float), blockCount * sizeof(float));
+      for (size_t j = 0; j < blockCount; j++)
+        SWAB(&block[j]);
+      (dbuf->*storeFloats_)(block, blockCount);
     }
   }
   else
-  { /// E57_DOUBLE precision
-    /// Form the starting address for first data location in inBuffer
-    const double* inp = reinterpret_cast<const double*>(inbuf);
-
-    /// Copy doubles from inbuf to destBuffer_
-    for (unsigned i = 0; i < n; i++)
+  {
+    double block[blockSize];
+    for (size_t i = 0; i < n; i += blockSize)
     {
-      double value = *inp;
-      SWAB(&value); /// swab if necessary
-#ifdef E57_MAX_VERBOSE
-      cout << "  got double value=" << value << endl;
-#endif
-      destBuffer_->setNextDouble(value);
-      inp++;
+      size_t blockCount = min(blockSize, n - i);
+      memcpy(block, inbuf + i * sizeof(double), blockCount * sizeof(double));
+      for (size_t j = 0; j < blockCount; j++)
+        SWAB(&block[j]);
+      (dbuf->*storeDoubles_)(block, blockCount);
     }
   }
+#else
+  /// Values in inbuf are already in memory order, store them all in one call
+  if (precision_ == FloatPrecision::E57_SINGLE)
+    (dbuf->*storeFloats_)(reinterpret_cast<const float*>(inbuf), n);
+  else
+    (dbuf->*storeDoubles_)(reinterpret_cast<const double*>(inbuf), n);
+#endif
 
   /// Update counts of records processed
   currentRecordIndex_ += n;
@@ -7184,8 +9625,8 @@ void BitpackFloatDecoder::dump(int indent, std::ostream& os)
 //================================================================
 
 BitpackStringDecoder::BitpackStringDecoder(unsigned bytestreamNumber, SourceDestBuffer& dbuf, uint64_t maxRecordCount)
-: BitpackDecoder(bytestreamNumber, dbuf, sizeof(char), maxRecordCount), readingPrefix_(true), prefixLength_(1), nBytesPrefixRead_(0), stringLength_(0),
-  currentString_(""), nBytesStringRead_(0)
+: BitpackDecoder(bytestreamNumber, dbuf, sizeof(char), maxRecordCount), discardCount_(0), readingPrefix_(true), prefixLength_(1), nBytesPrefixRead_(0), stringLength_(0),
+  stringDest_(nullptr), waitingForRoom_(false), nBytesStringRead_(0), maxStringLength_(E57_UINT64_MAX), byteOffset_(0), recordByteOffset_(0)
 {
   memset(prefixBytes_, 0, sizeof(prefixBytes_));
 }
@@ -7208,8 +9649,9 @@ size_t BitpackStringDecoder::inputProcessAligned(const char* inbuf, const size_t
   size_t nBytesAvailable = (endBit - firstBit) >> 3;
   size_t nBytesRead      = 0;
 
-  /// Loop until we've finished all the records, or ran out of input currently available
-  while (currentRecordIndex_ < maxRecordCount_ && nBytesRead < nBytesAvailable)
+  /// Loop until we've finished all the records, filled destBuffer, or ran out of input currently available
+  while (currentRecordIndex_ < maxRecordCount_ && nBytesRead < nBytesAvailable
+         && (discardCount_ > 0 || destBuffer_->nextIndex() < destBuffer_->capacity()))
   {
 #ifdef E57_MAX_VERBOSE
     cout << "read string loop1: readingPrefix=" << readingPrefix_ << " prefixLength=" << prefixLength_ << " nBytesPrefixRead=" << nBytesPrefixRead_
@@ -7223,6 +9665,7 @@ size_t BitpackStringDecoder::inputProcessAligned(const char* inbuf, const size_t
         /// If first byte of prefix, test the least significant bit to see how long prefix is
         if (nBytesPrefixRead_ == 0)
         {
+          recordByteOffset_ = byteOffset_ + nBytesRead;
           if (*inbuf & 0x01)
             prefixLength_ = 8; // 8 byte prefix, length upto 2^63-1
           else
@@ -7257,12 +9700,19 @@ size_t BitpackStringDecoder::inputProcessAligned(const char* inbuf, const size_t
                           + (static_cast<uint64_t>(prefixBytes_[4]) << (4 * 8 - 1)) + (static_cast<uint64_t>(prefixBytes_[5]) << (5 * 8 - 1))
                           + (static_cast<uint64_t>(prefixBytes_[6]) << (6 * 8 - 1)) + (static_cast<uint64_t>(prefixBytes_[7]) << (7 * 8 - 1));
         }
-        /// Get ready to read string contents
+        if (stringLength_ > maxStringLength_)
+        {
+          throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "stringLength=" + toString(stringLength_) + " maxStringLength=" + toString(maxStringLength_)
+                                                          + " recordIndex=" + toString(currentRecordIndex_));
+        }
+
+        /// Get ready to read string contents straight into the dest buffer, unless still skipping to the record given to seekRecord()
         readingPrefix_ = false;
         prefixLength_  = 1;
         memset(prefixBytes_, 0, sizeof(prefixBytes_));
         nBytesPrefixRead_ = 0;
-        currentString_    = "";
+        stringDest_       = nullptr;
+        waitingForRoom_   = (discardCount_ == 0);
         nBytesStringRead_ = 0;
       }
 #ifdef E57_MAX_VERBOSE
@@ -7274,6 +9724,17 @@ size_t BitpackStringDecoder::inputProcessAligned(const char* inbuf, const size_t
     /// If currently reading string contents, keep doing it until have complete string
     if (!readingPrefix_)
     {
+      /// Claim room for the chars in the dest buffer.  If its char array is full, stop until the next read empties it.
+      if (waitingForRoom_)
+      {
+        if (!destBuffer_->hasRoomForString(stringLength_))
+          break;
+        storedByteOffsets_.resize(destBuffer_->nextIndex());
+        storedByteOffsets_.push_back(recordByteOffset_);
+        stringDest_     = destBuffer_->beginNextString(stringLength_);
+        waitingForRoom_ = false;
+      }
+
       /// Calc how many bytes we need to complete current string
       uint64_t nBytesNeeded = stringLength_ - nBytesStringRead_;
 
@@ -7283,7 +9744,8 @@ size_t BitpackStringDecoder::inputProcessAligned(const char* inbuf, const size_t
         nBytesProcess = static_cast<unsigned>(nBytesNeeded);
 
       /// Append to current string and update counts
-      currentString_ += ustring(inbuf, nBytesProcess);
+      if (stringDest_ != nullptr)
+        memcpy(stringDest_ + nBytesStringRead_, inbuf, nBytesProcess);
       inbuf += nBytesProcess;
       nBytesRead += nBytesProcess;
       nBytesStringRead_ += nBytesProcess;
@@ -7291,8 +9753,11 @@ size_t BitpackStringDecoder::inputProcessAligned(const char* inbuf, const size_t
       /// Check if completed reading the string contents
       if (nBytesStringRead_ == stringLength_)
       {
-        /// Save accumulated string to dest buffer
-        destBuffer_->setNextString(currentString_);
+        /// Finish string in dest buffer, unless still skipping to the record given to seekRecord()
+        if (discardCount_ > 0)
+          discardCount_--;
+        else
+          destBuffer_->endNextString();
         currentRecordIndex_++;
 
         /// Get ready to read next prefix
@@ -7301,16 +9766,58 @@ size_t BitpackStringDecoder::inputProcessAligned(const char* inbuf, const size_t
         memset(prefixBytes_, 0, sizeof(prefixBytes_));
         nBytesPrefixRead_ = 0;
         stringLength_     = 0;
-        currentString_    = "";
+        stringDest_       = nullptr;
         nBytesStringRead_ = 0;
       }
     }
   }
 
   /// Returned number of bits processed  (always a multiple of alignment size).
+  byteOffset_ += nBytesRead;
   return (nBytesRead * 8);
 }
 
+void BitpackStringDecoder::stateReset()
+{
+  BitpackDecoder::stateReset();
+  discardCount_  = 0;
+  readingPrefix_ = true;
+  prefixLength_  = 1;
+  memset(prefixBytes_, 0, sizeof(prefixBytes_));
+  nBytesPrefixRead_ = 0;
+  stringLength_     = 0;
+  stringDest_       = nullptr;
+  waitingForRoom_   = false;
+  nBytesStringRead_ = 0;
+  byteOffset_       = 0;
+  recordByteOffset_ = 0;
+}
+
+uint64_t BitpackStringDecoder::seekRecordAt(uint64_t recordNumber, uint64_t byteOffset)
+{
+  /// Strings are byte aligned, so can start over at any record whose byte offset is known
+  stateReset();
+  currentRecordIndex_ = recordNumber;
+  byteOffset_         = byteOffset;
+  return (byteOffset);
+}
+
+uint64_t BitpackStringDecoder::seekRecord(uint64_t recordNumber)
+{
+  /// Strings have variable length, so the only way to find where a record starts is to decode all the records before it.
+  /// If recordNumber is ahead, can keep going from current input position, otherwise have to start over at beginning of bytestream.
+  if (recordNumber >= currentRecordIndex_)
+  {
+    discardCount_ = recordNumber - currentRecordIndex_;
+    return (E57_UINT64_MAX);
+  }
+
+  stateReset();
+  currentRecordIndex_ = 0;
+  discardCount_       = recordNumber;
+  return (0);
+}
+
 #ifdef E57_DEBUG
 void BitpackStringDecoder::dump(int indent, std::ostream& os)
 {
@@ -7322,14 +9829,12 @@ void BitpackStringDecoder::dump(int indent, std::ostream& os)
      << static_cast<unsigned>(prefixBytes_[5]) << " " << static_cast<unsigned>(prefixBytes_[6]) << " " << static_cast<unsigned>(prefixBytes_[7]) << endl;
   os << space(indent) << "nBytesPrefixRead:   " << nBytesPrefixRead_ << endl;
   os << space(indent) << "stringLength:       " << stringLength_ << endl;
-  os << space(indent)
-     << "currentString:      "
-        ""
-     << currentString_
-     << ""
-        ""
-     << endl;
+  os << space(indent) << "stringDest:         " << static_cast<const void*>(stringDest_) << endl;
+  os << space(indent) << "waitingForRoom:     " << waitingForRoom_ << endl;
   os << space(indent) << "nBytesStringRead:   " << nBytesStringRead_ << endl;
+  os << space(indent) << "maxStringLength:    " << maxStringLength_ << endl;
+  os << space(indent) << "byteOffset:         " << byteOffset_ << endl;
+  os << space(indent) << "recordByteOffset:   " << recordByteOffset_ << endl;
 }
 #endif
 
@@ -7345,13 +9850,15 @@ ConstantIntegerDecoder::ConstantIntegerDecoder(bool isScaledInteger, unsigned by
   minimum_            = minimum;
   scale_              = scale;
   offset_             = offset;
+  storeIntegers_      = destBuffer_->storeIntegersKernel<uint8_t>(isScaledInteger_);
 }
 
 void ConstantIntegerDecoder::destBufferSetNew(vector<SourceDestBuffer>& dbufs)
 {
   if (dbufs.size() != 1)
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "dbufsSize=" + toString(dbufs.size()));
-  destBuffer_ = dbufs.at(0).impl();
+  destBuffer_    = dbufs.at(0).impl();
+  storeIntegers_ = destBuffer_->storeIntegersKernel<uint8_t>(isScaledInteger_);
 }
 
 size_t ConstantIntegerDecoder::inputProcess(const char* /*source*/, const size_t /*availableByteCount*/)
@@ -7364,22 +9871,24 @@ size_t ConstantIntegerDecoder::inputProcess(const char* /*source*/, const size_t
   if (static_cast<uint64_t>(count) > remainingRecordCount)
     count = static_cast<unsigned>(remainingRecordCount);
 
-  if (isScaledInteger_)
-  {
-    for (unsigned i = 0; i < count; i++)
-      destBuffer_->setNextInt64(minimum_, scale_, offset_);
-  }
-  else
-  {
-    for (unsigned i = 0; i < count; i++)
-      destBuffer_->setNextInt64(minimum_);
-  }
+  /// Every record is minimum_, so store blocks of zero raw values with the kernel, which adds minimum_ back
+  static const uint8_t  zeros[256] = {};
+  SourceDestBufferImpl* dbuf       = destBuffer_.get();
+  for (size_t i = 0; i < count; i += sizeof(zeros))
+    (dbuf->*storeIntegers_)(zeros, min(sizeof(zeros), count - i), minimum_, scale_, offset_);
   currentRecordIndex_ += count;
   return (count);
 }
 
-void ConstantIntegerDecoder::stateReset() {}
-
+void ConstantIntegerDecoder::stateReset() {}
+
+uint64_t ConstantIntegerDecoder::seekRecord(uint64_t recordNumber)
+{
+  /// Don't use any input, so can start anywhere.
+  currentRecordIndex_ = recordNumber;
+  return (0);
+}
+
 #ifdef E57_DEBUG
 void ConstantIntegerDecoder::dump(int indent, std::ostream& os)
 {
@@ -7420,22 +9929,47 @@ PacketLock::~PacketLock()
   }
 }
 
-PacketReadCache::PacketReadCache(CheckedFile* cFile, unsigned packetCount) : lockCount_(0), useCount_(0), cFile_(cFile), entries_(packetCount)
+PacketReadCache::PacketReadCache(CheckedFile* cFile, unsigned packetCount, unsigned prefetchCount)
+: lockCount_(0),
+  hitCount_(0),
+  missCount_(0),
+  cFile_(cFile),
+  prefetchCount_(prefetchCount),
+  prefetchPending_(false),
+  prefetchStopped_(false),
+  workerBusy_(false),
+  stopWorker_(false),
+  loadingCount_(0),
+  prefetchLead_(0),
+  prefetchKeep_(0),
+  prefetchEnd_(0)
 {
   if (packetCount == 0)
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "packetCount=" + toString(packetCount));
 
-  /// Allocate requested number of maximum sized data packets buffers for holding data read from file
-  for (unsigned i = 0; i < entries_.size(); i++)
-  {
-    entries_.at(i).logicalOffset_ = 0;
-    entries_.at(i).buffer_        = new char[E57_DATA_PACKET_MAX];
-    entries_.at(i).lastUsed_      = 0;
-  }
+  /// The worker reads without the file cursor, so both threads can read at once
+  if (prefetchCount_ > 0 && !cFile_->canReadConcurrently())
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "prefetchCount=" + toString(prefetchCount_));
+
+  grow(packetCount);
+
+  if (prefetchCount_ > 0)
+    worker_ = std::thread(&PacketReadCache::prefetchWorker, this);
 }
 
 PacketReadCache::~PacketReadCache()
 {
+  /// Stop worker before freeing the buffers it may be reading into
+  if (worker_.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stopWorker_ = true;
+    }
+    prefetchRequest_.notify_one();
+    worker_.join();
+  }
+
   /// Free allocated packet buffers
   for (unsigned i = 0; i < entries_.size(); i++)
   {
@@ -7444,125 +9978,317 @@ PacketReadCache::~PacketReadCache()
   }
 }
 
+void PacketReadCache::grow(unsigned packetCount)
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  /// Entries are indexed by position, so the cache can't grow while one is handed out.
+  if (lockCount_ > 0)
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "lockCount=" + toString(lockCount_));
+
+  /// Nor while the worker is reading into one
+  entryLoaded_.wait(guard, [this] { return loadingCount_ == 0; });
+
+  /// Allocate maximum sized data packet buffers for the new entries.
+  /// Empty entries go at the old end of the LRU list, so they are used before any packet is evicted.
+  entries_.reserve(packetCount);
+  while (entries_.size() < packetCount)
+  {
+    CacheEntry entry;
+    entry.logicalOffset_ = 0;
+    entry.buffer_        = new char[E57_DATA_PACKET_MAX];
+    entry.lruPosition_   = lru_.insert(lru_.end(), static_cast<unsigned>(entries_.size()));
+    entry.loading_       = false;
+    entry.lockCount_     = 0;
+    entries_.push_back(entry);
+  }
+}
+
 std::unique_ptr<PacketLock> PacketReadCache::lock(uint64_t packetLogicalOffset, char*& pkt)
 {
 #ifdef E57_MAX_VERBOSE
   cout << "PacketReadCache::lock() called, packetLogicalOffset=" << packetLogicalOffset << endl;
 #endif
+  std::unique_lock<std::mutex> guard(mutex_);
 
-  /// Only allow one locked packet at a time.
-  if (lockCount_ > 0)
-    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "lockCount=" + toString(lockCount_));
+  /// Several packets can be locked at once, and a packet can be locked again while locked.  The caller must leave an entry free for a new packet.
 
   /// Offset can't be 0
   if (packetLogicalOffset == 0)
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "packetLogicalOffset=" + toString(packetLogicalOffset));
 
-  /// Linear scan for matching packet offset in cache
-  for (unsigned i = 0; i < entries_.size(); i++)
+  unsigned entry;
+  while (true)
   {
-    if (packetLogicalOffset == entries_[i].logicalOffset_)
+    std::unordered_map<uint64_t, unsigned>::const_iterator found = entryIndex_.find(packetLogicalOffset);
+    if (found != entryIndex_.end())
     {
+      /// If the worker is reading the packet, wait for it.  The entry is dropped if the worker's read fails, so look again afterwards.
+      if (entries_[found->second].loading_)
+      {
+        entryLoaded_.wait(guard);
+        continue;
+      }
+
       /// Found a match, so don't have to read anything
+      entry = found->second;
+      hitCount_++;
 #ifdef E57_MAX_VERBOSE
-      cout << "  Found matching cache entry, index=" << i << endl;
+      cout << "  Found matching cache entry, index=" << entry << endl;
 #endif
-      /// Mark entry with current useCount (keeps track of age of entry).
-      entries_[i].lastUsed_ = ++useCount_;
+      break;
+    }
 
-      /// Publish buffer address to caller
-      pkt = entries_[i].buffer_;
+    /// Reuse the least recently used (LRU) packet buffer, if the worker is reading into all of them, wait.
+    entry = victim(E57_UINT64_MAX);
+    if (entry == entries_.size())
+    {
+      if (loadingCount_ == 0)
+        throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "lockCount=" + toString(lockCount_) + " packetCount=" + toString(entries_.size()));
+      entryLoaded_.wait(guard);
+      continue;
+    }
+    missCount_++;
+#ifdef E57_MAX_VERBOSE
+    cout << "  Oldest entry=" << entry << endl;
+#endif
 
-      /// Create lock so we are sure that we will be unlocked when use is finished.
-      std::unique_ptr<PacketLock> plock(new PacketLock(this, i));
+    /// Claim entry for the packet, so the worker doesn't read it too
+    if (entries_[entry].logicalOffset_ != 0)
+      entryIndex_.erase(entries_[entry].logicalOffset_);
+    entries_[entry].logicalOffset_   = packetLogicalOffset;
+    entries_[entry].loading_         = true;
+    entryIndex_[packetLogicalOffset] = entry;
+    loadingCount_++;
 
-      /// Increment cache lock just before return
-      lockCount_++;
-      return (plock);
+    /// Read without holding mutex, so worker can keep going
+    guard.unlock();
+    try
+    {
+      readPacket(entries_[entry].buffer_, packetLogicalOffset, pageBuffer_);
     }
-  }
-  /// Get here if didn't find a match already in cache.
-
-  /// Find least recently used (LRU) packet buffer
-  unsigned oldestEntry = 0;
-  unsigned oldestUsed  = entries_.at(0).lastUsed_;
-  for (unsigned i = 0; i < entries_.size(); i++)
-  {
-    if (entries_[i].lastUsed_ < oldestUsed)
+    catch (...)
     {
-      oldestEntry = i;
-      oldestUsed  = entries_[i].lastUsed_;
+      guard.lock();
+      entryIndex_.erase(packetLogicalOffset);
+      entries_[entry].logicalOffset_ = 0;
+      entries_[entry].loading_       = false;
+      loadingCount_--;
+      guard.unlock();
+      entryLoaded_.notify_all();
+      throw; // rethrow
     }
+    guard.lock();
+    entries_[entry].loading_ = false;
+    loadingCount_--;
+    entryLoaded_.notify_all();
+    break;
   }
-#ifdef E57_MAX_VERBOSE
-  cout << "  Oldest entry=" << oldestEntry << " lastUsed=" << oldestUsed << endl;
-#endif
 
-  readPacket(oldestEntry, packetLogicalOffset);
+  /// Mark entry as most recently used.
+  lru_.splice(lru_.begin(), lru_, entries_[entry].lruPosition_);
+  entries_[entry].lockCount_++;
 
   /// Publish buffer address to caller
-  pkt = entries_[oldestEntry].buffer_;
+  pkt = entries_[entry].buffer_;
 
-  /// Create lock so we are sure we will be unlocked when use is finished.
-  std::unique_ptr<PacketLock> plock(new PacketLock(this, oldestEntry));
+  /// Create lock so we are sure that we will be unlocked when use is finished.
+  std::unique_ptr<PacketLock> plock(new PacketLock(this, entry));
 
   /// Increment cache lock just before return
   lockCount_++;
   return (plock);
 }
 
+unsigned PacketReadCache::victim(uint64_t keepLogicalOffset)
+{
+  /// Find least recently used entry that is free to be replaced, return entries_.size() if there is none.
+  /// Entries holding packets at or after keepLogicalOffset are still wanted, so aren't replaced either.
+  for (std::list<unsigned>::reverse_iterator it = lru_.rbegin(); it != lru_.rend(); ++it)
+  {
+    const CacheEntry& e = entries_[*it];
+    if (!e.loading_ && e.lockCount_ == 0 && (e.logicalOffset_ == 0 || e.logicalOffset_ < keepLogicalOffset))
+      return (*it);
+  }
+  return (static_cast<unsigned>(entries_.size()));
+}
+
 void PacketReadCache::markDiscarable(uint64_t packetLogicalOffset)
 {
+  std::lock_guard<std::mutex> guard(mutex_);
+
   /// The packet is probably not going to be used again, so mark it as really old.
+  std::unordered_map<uint64_t, unsigned>::const_iterator found = entryIndex_.find(packetLogicalOffset);
+  if (found != entryIndex_.end())
+    lru_.splice(lru_.end(), lru_, entries_[found->second].lruPosition_);
+}
+
+void PacketReadCache::unlock(unsigned lockedEntry)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (entries_.at(lockedEntry).lockCount_ == 0)
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "lockCount=" + toString(lockCount_) + " entry=" + toString(lockedEntry));
+
+  entries_[lockedEntry].lockCount_--;
+  lockCount_--;
+}
+
+void PacketReadCache::prefetch(uint64_t leadLogicalOffset, uint64_t keepLogicalOffset, uint64_t endLogicalOffset)
+{
+  if (!worker_.joinable())
+    return;
 
-  /// Linear scan for matching packet offset in cache
-  for (unsigned i = 0; i < entries_.size(); i++)
   {
-    if (packetLogicalOffset == entries_[i].logicalOffset_)
-    {
-      entries_[i].lastUsed_ = 0;
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (leadLogicalOffset == prefetchLead_ && keepLogicalOffset == prefetchKeep_ && endLogicalOffset == prefetchEnd_)
       return;
-    }
+    prefetchLead_    = leadLogicalOffset;
+    prefetchKeep_    = keepLogicalOffset;
+    prefetchEnd_     = endLogicalOffset;
+    prefetchPending_ = true;
   }
+  prefetchRequest_.notify_one();
 }
 
-void PacketReadCache::unlock(unsigned /*lockedEntry*/)
+void PacketReadCache::stopPrefetch()
 {
-  //??? why lockedEntry not used?
+  /// Abandon any read-ahead in progress and wait for worker to go idle, so the file isn't touched until the next request.
+  if (!worker_.joinable())
+    return;
 
-  if (lockCount_ != 1)
-    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "lockCount=" + toString(lockCount_));
+  std::unique_lock<std::mutex> guard(mutex_);
+  prefetchPending_ = false;
+  prefetchStopped_ = true;
+  entryLoaded_.wait(guard, [this] { return !workerBusy_; });
+  prefetchStopped_ = false;
+}
 
-  lockCount_--;
+void PacketReadCache::prefetchWorker()
+{
+  /// Read the prefetchCount_ data packets following the lead packet into the cache, then wait for the lead to move.
+  /// Errors are not reported here, the entry is just dropped so that lock() reads it again and gets the exception.
+  std::unique_lock<std::mutex> guard(mutex_);
+  while (true)
+  {
+    prefetchRequest_.wait(guard, [this] { return stopWorker_ || prefetchPending_; });
+    if (stopWorker_)
+      return;
+    prefetchPending_ = false;
+    workerBusy_      = true;
+
+    uint64_t offset    = prefetchLead_;
+    unsigned remaining = prefetchCount_;
+    while (offset < prefetchEnd_ && !stopWorker_ && !prefetchPending_ && !prefetchStopped_)
+    {
+      std::unordered_map<uint64_t, unsigned>::const_iterator found = entryIndex_.find(offset);
+      if (found != entryIndex_.end() && entries_[found->second].loading_)
+      {
+        /// Being read by lock(), wait for it
+        entryLoaded_.wait(guard);
+        continue;
+      }
+
+      unsigned entry;
+      if (found != entryIndex_.end())
+        entry = found->second;
+      else
+      {
+        /// Only replace packets the channels have finished with, never the ones they are still reading or the ones ahead of them.
+        entry = victim(prefetchKeep_);
+        if (entry == entries_.size())
+          break;
+
+        if (entries_[entry].logicalOffset_ != 0)
+          entryIndex_.erase(entries_[entry].logicalOffset_);
+        entries_[entry].logicalOffset_ = offset;
+        entries_[entry].loading_       = true;
+        entryIndex_[offset]            = entry;
+        loadingCount_++;
+
+        guard.unlock();
+        bool ok = true;
+        try
+        {
+          readPacket(entries_[entry].buffer_, offset, workerPageBuffer_);
+        }
+        catch (...)
+        {
+          ok = false;
+        }
+        guard.lock();
+        entries_[entry].loading_ = false;
+        loadingCount_--;
+        if (!ok)
+        {
+          entryIndex_.erase(offset);
+          entries_[entry].logicalOffset_ = 0;
+          lru_.splice(lru_.end(), lru_, entries_[entry].lruPosition_);
+          entryLoaded_.notify_all();
+          break;
+        }
+
+        /// Just read, so most recently used
+        lru_.splice(lru_.begin(), lru_, entries_[entry].lruPosition_);
+        entryLoaded_.notify_all();
+      }
+
+      /// The lead packet itself doesn't count, only the ones after it
+      const EmptyPacketHeader* header = reinterpret_cast<const EmptyPacketHeader*>(entries_[entry].buffer_);
+      if (offset != prefetchLead_ && header->packetType == E57_DATA_PACKET && --remaining == 0)
+        break;
+      offset += header->packetLogicalLengthMinus1 + 1;
+    }
+
+    workerBusy_ = false;
+    entryLoaded_.notify_all();
+  }
+}
+
+void PacketReadCache::read(uint64_t logicalOffset, char* buf, size_t nRead)
+{
+  /// pageBuffer_ belongs to the thread calling lock(), the worker has its own
+  readBytes(logicalOffset, buf, nRead, pageBuffer_);
+}
+
+void PacketReadCache::readBytes(uint64_t logicalOffset, char* buf, size_t nRead, std::vector<char>& pageBuffer)
+{
+  /// Don't use the file cursor if the file allows otherwise, the worker or other readers may be reading the file at the same time
+  if (cFile_->canReadConcurrently())
+    cFile_->readAt(logicalOffset, buf, nRead, pageBuffer);
+  else
+  {
+    cFile_->seek(logicalOffset, CheckedFile::logical);
+    cFile_->read(buf, nRead);
+  }
 }
 
-void PacketReadCache::readPacket(unsigned oldestEntry, uint64_t packetLogicalOffset)
+void PacketReadCache::readPacket(char* buffer, uint64_t packetLogicalOffset, std::vector<char>& pageBuffer)
 {
 #ifdef E57_MAX_VERBOSE
-  cout << "PacketReadCache::readPacket() called, oldestEntry=" << oldestEntry << " packetLogicalOffset=" << packetLogicalOffset << endl;
+  cout << "PacketReadCache::readPacket() called, packetLogicalOffset=" << packetLogicalOffset << endl;
 #endif
 
   /// Read header of packet first to get length.  Use EmptyPacketHeader since it has the common fields to all packets.
   EmptyPacketHeader header;
-  cFile_->seek(packetLogicalOffset, CheckedFile::logical);
-  cFile_->read(reinterpret_cast<char*>(&header), sizeof(header));
+  readBytes(packetLogicalOffset, buffer, sizeof(header), pageBuffer);
+  memcpy(&header, buffer, sizeof(header));
   header.swab();
   /// Can't verify packet header here, because it is not really an EmptyPacketHeader.
   unsigned packetLength = header.packetLogicalLengthMinus1 + 1;
 
   /// Be paranoid about packetLength before read
-  if (packetLength > E57_DATA_PACKET_MAX)
+  if (packetLength > E57_DATA_PACKET_MAX || packetLength < sizeof(header))
     throw E57_EXCEPTION2(E57_ERROR_BAD_CV_PACKET, "packetLength=" + toString(packetLength));
 
-  /// Now read in whole packet into preallocated buffer_.  Note buffer is
-  cFile_->seek(packetLogicalOffset, CheckedFile::logical);
-  cFile_->read(entries_.at(oldestEntry).buffer_, packetLength);
+  /// Now read in rest of packet into preallocated buffer.
+  readBytes(packetLogicalOffset + sizeof(header), buffer + sizeof(header), packetLength - sizeof(header), pageBuffer);
 
   /// Swab if necessary, then verify that packet is good.
   switch (header.packetType)
   {
   case E57_DATA_PACKET: {
-    DataPacket* dpkt = reinterpret_cast<DataPacket*>(entries_.at(oldestEntry).buffer_);
+    DataPacket* dpkt = reinterpret_cast<DataPacket*>(buffer);
 #ifdef E57_BIGENDIAN
     dpkt->swab(false);
 #endif
@@ -7574,7 +10300,7 @@ void PacketReadCache::readPacket(unsigned oldestEntry, uint64_t packetLogicalOff
   }
   break;
   case E57_INDEX_PACKET: {
-    IndexPacket* ipkt = reinterpret_cast<IndexPacket*>(entries_.at(oldestEntry).buffer_);
+    IndexPacket* ipkt = reinterpret_cast<IndexPacket*>(buffer);
 #ifdef E57_BIGENDIAN
     ipkt->swab(false);
 #endif
@@ -7586,7 +10312,7 @@ void PacketReadCache::readPacket(unsigned oldestEntry, uint64_t packetLogicalOff
   }
   break;
   case E57_EMPTY_PACKET: {
-    EmptyPacketHeader* hp = reinterpret_cast<EmptyPacketHeader*>(entries_.at(oldestEntry).buffer_);
+    EmptyPacketHeader* hp = reinterpret_cast<EmptyPacketHeader*>(buffer);
     hp->swab();
     hp->verify(packetLength);
 #ifdef E57_MAX_VERBOSE
@@ -7598,25 +10324,21 @@ void PacketReadCache::readPacket(unsigned oldestEntry, uint64_t packetLogicalOff
   default:
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "packetType=" + toString(header.packetType));
   }
-
-  entries_[oldestEntry].logicalOffset_ = packetLogicalOffset;
-
-  /// Mark entry with current useCount (keeps track of age of entry).
-  /// This is a cache, so a small hiccup when useCount_ overflows won't hurt.
-  entries_[oldestEntry].lastUsed_ = ++useCount_;
 }
 
 #ifdef E57_DEBUG
 void PacketReadCache::dump(int indent, std::ostream& os)
 {
-  os << space(indent) << "lockCount: " << lockCount_ << endl;
-  os << space(indent) << "useCount:  " << useCount_ << endl;
-  os << space(indent) << "entries:" << endl;
-  for (unsigned i = 0; i < entries_.size(); i++)
+  os << space(indent) << "lockCount:     " << lockCount_ << endl;
+  os << space(indent) << "prefetchCount: " << prefetchCount_ << endl;
+  os << space(indent) << "hitCount:      " << hitCount_ << endl;
+  os << space(indent) << "missCount:     " << missCount_ << endl;
+  os << space(indent) << "entries (most recently used first):" << endl;
+  for (std::list<unsigned>::const_iterator it = lru_.begin(); it != lru_.end(); ++it)
   {
+    unsigned i = *it;
     os << space(indent) << "entry[" << i << "]:" << endl;
     os << space(indent + 4) << "logicalOffset:  " << entries_[i].logicalOffset_ << endl;
-    os << space(indent + 4) << "lastUsed:        " << entries_[i].lastUsed_ << endl;
     if (entries_[i].logicalOffset_ != 0)
     {
       os << space(indent + 4) << "packet:" << endl;
@@ -7647,6 +10369,118 @@ void PacketReadCache::dump(int indent, std::ostream& os)
 
 //================================================================
 
+WorkerPool::WorkerPool(unsigned threadCount)
+: task_(nullptr), taskCount_(0), nextTask_(0), unfinished_(0), errorIndex_(0), stopWorkers_(false)
+{
+  try
+  {
+    for (unsigned i = 1; i < threadCount; i++)
+      workers_.emplace_back(&WorkerPool::worker, this);
+  }
+  catch (...)
+  {
+    /// Couldn't start them all, stop the ones that did start
+    stopWorkers();
+    throw;
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  stopWorkers();
+}
+
+void WorkerPool::stopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopWorkers_ = true;
+  }
+  batchPosted_.notify_all();
+  for (size_t i = 0; i < workers_.size(); i++)
+  {
+    if (workers_[i].joinable())
+      workers_[i].join();
+  }
+  workers_.clear();
+}
+
+void WorkerPool::run(size_t taskCount, const std::function<void(size_t)>& task)
+{
+  /// Nothing to share out, so just run the tasks here, stopping at the first exception like a plain loop
+  if (workers_.empty() || taskCount < 2)
+  {
+    for (size_t i = 0; i < taskCount; i++)
+      task(i);
+    return;
+  }
+
+  std::unique_lock<std::mutex> guard(mutex_);
+  task_       = &task;
+  taskCount_  = taskCount;
+  nextTask_   = 0;
+  unfinished_ = taskCount;
+  errorIndex_ = taskCount;
+  error_      = nullptr;
+  batchPosted_.notify_all();
+
+  /// Work on the batch too, then wait for the tasks the workers picked up
+  runTasks(guard);
+  batchDone_.wait(guard, [this] { return unfinished_ == 0; });
+  task_ = nullptr;
+
+  if (error_)
+  {
+    std::exception_ptr error = error_;
+    error_                   = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void WorkerPool::runTasks(std::unique_lock<std::mutex>& guard)
+{
+  /// Called with mutex_ locked, which is released while each task runs
+  while (task_ != nullptr && nextTask_ < taskCount_)
+  {
+    const std::function<void(size_t)>* task  = task_;
+    size_t                             index = nextTask_++;
+
+    guard.unlock();
+    std::exception_ptr error;
+    try
+    {
+      (*task)(index);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+    guard.lock();
+
+    if (error && index < errorIndex_)
+    {
+      error_      = error;
+      errorIndex_ = index;
+    }
+    if (--unfinished_ == 0)
+      batchDone_.notify_all();
+  }
+}
+
+void WorkerPool::worker()
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  while (true)
+  {
+    batchPosted_.wait(guard, [this] { return stopWorkers_ || (task_ != nullptr && nextTask_ < taskCount_); });
+    if (stopWorkers_)
+      return;
+    runTasks(guard);
+  }
+}
+
+//================================================================
+
 DecodeChannel::DecodeChannel(SourceDestBuffer dbuf_arg, std::shared_ptr<Decoder> decoder_arg, unsigned bytestreamNumber_arg, uint64_t maxRecordCount_arg)
 : dbuf(dbuf_arg), decoder(decoder_arg), bytestreamNumber(bytestreamNumber_arg)
 {
@@ -7665,6 +10499,10 @@ bool DecodeChannel::isOutputBlocked()
   if (decoder->totalRecordsCompleted() >= maxRecordCount)
     return (true);
 
+  /// If the decoder can't store its next record until the next read, we are blocked
+  if (decoder->isOutputBlocked())
+    return (true);
+
   /// If we have filled the dest buffer, we are blocked
   return (dbuf.impl()->nextIndex() == dbuf.impl()->capacity());
 }
@@ -7716,6 +10554,14 @@ BitpackIntegerEncoder<RegisterT>::BitpackIntegerEncoder(bool isScaledInteger, un
   sourceBitMask_    = (bitsPerRecord_ == 64) ? ~0 : (1ULL << bitsPerRecord_) - 1;
   registerBitsUsed_ = 0;
   register_         = 0;
+  loadIntegers_     = sourceBuffer_->loadIntegersKernel<UnpackedT>(isScaledInteger_);
+}
+
+template <typename RegisterT>
+void BitpackIntegerEncoder<RegisterT>::sourceBufferSetNew(std::vector<SourceDestBuffer>& sbufs)
+{
+  BitpackEncoder::sourceBufferSetNew(sbufs);
+  loadIntegers_ = sourceBuffer_->loadIntegersKernel<UnpackedT>(isScaledInteger_);
 }
 
 template <typename RegisterT>
@@ -7754,96 +10600,47 @@ uint64_t BitpackIntegerEncoder<RegisterT>::processRecords(size_t recordCount)
 #endif
 
   /// Form the starting address for next available location in outBuffer
-  RegisterT* outp           = reinterpret_cast<RegisterT*>(&outBuffer_[outBufferEnd_]);
-  unsigned   outTransferred = 0;
-
-  /// Copy bits from sourceBuffer_ to outBuffer_
-  for (unsigned i = 0; i < recordCount; i++)
-  {
-    int64_t rawValue;
-
-    /// The parameter isScaledInteger_ determines which version of getNextInt64 gets called
-    if (isScaledInteger_)
-      rawValue = sourceBuffer_->getNextInt64(scale_, offset_);
-    else
-      rawValue = sourceBuffer_->getNextInt64();
-
-    /// Enforce min/max specification on value
-    if (rawValue < minimum_ || maximum_ < rawValue)
-    {
-      throw E57_EXCEPTION2(E57_ERROR_VALUE_OUT_OF_BOUNDS,
-                           "rawValue=" + toString(rawValue) + " minimum=" + toString(minimum_) + " maximum=" + toString(maximum_));
-    }
+  char*  outp           = &outBuffer_[outBufferEnd_];
+  size_t outTransferred = 0;
 
-    uint64_t uValue = static_cast<uint64_t>(rawValue - minimum_);
+  /// The stream is little endian whatever the register size, so the register and the bits used in it are the pending word of utils::pack_bits(),
+  /// which stores 64 bit words.  The capacity calculation above limits the output to whole registers, and the last incomplete 64 bit word is kept pending.
+  uint64_t pending     = register_;
+  unsigned pendingBits = registerBitsUsed_;
 
-#ifdef E57_MAX_VERBOSE
-    cout << "encoding integer rawValue=" << binaryString(rawValue) << " = " << hexString(rawValue) << endl;
-    cout << "                 uValue  =" << binaryString(uValue) << " = " << hexString(uValue) << endl;
-#endif
-#ifdef E57_DEBUG
-    /// Double check that no bits outside of the mask are set
-    if (uValue & ~static_cast<uint64_t>(sourceBitMask_))
-      throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "uValue=" + toString(uValue));
-#endif
-    /// Mask off upper bits (just in case)
-    uValue &= static_cast<uint64_t>(sourceBitMask_);
+  /// Load and pack blocks of records, small enough to stay in cache
+  constexpr size_t blockSize = 256;
+  UnpackedT        raw[blockSize];
+  for (size_t i = 0; i < recordCount; i += blockSize)
+  {
+    const size_t blockCount = min(blockSize, recordCount - i);
+    (sourceBuffer_.get()->*loadIntegers_)(raw, blockCount, minimum_, maximum_, scale_, offset_);
+    outTransferred += 8 * utils::pack_bits(raw, blockCount, bitsPerRecord_, pending, pendingBits, outp + outTransferred);
+  }
 
-    /// See if uValue bits will fit in register
-    unsigned newRegisterBitsUsed = registerBitsUsed_ + bitsPerRecord_;
-#ifdef E57_MAX_VERBOSE
-    cout << "  registerBitsUsed=" << registerBitsUsed_ << "  newRegisterBitsUsed=" << newRegisterBitsUsed << endl;
-#endif
-    if (newRegisterBitsUsed > 8 * sizeof(RegisterT))
+  /// Transfer the whole registers in the pending word, keep the rest in the register
+  if constexpr (sizeof(RegisterT) < sizeof(uint64_t))
+  {
+    while (pendingBits >= 8 * sizeof(RegisterT))
     {
-      /// Have more than one registers worth, fill register, transfer, then fill some more
-      register_ |= static_cast<RegisterT>(uValue) << registerBitsUsed_;
-#ifdef E57_DEBUG
-      /// Before transfer, double check address within bounds
-      if (outTransferred >= transferMax)
-      {
-        throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "outTransferred=" + toString(outTransferred) + " transferMax" + toString(transferMax));
-      }
-#endif
-      outp[outTransferred] = register_;
-      SWAB(&outp[outTransferred]); /// swab if neccesary
-      outTransferred++;
-
-      register_         = static_cast<RegisterT>(uValue) >> (8 * sizeof(RegisterT) - registerBitsUsed_);
-      registerBitsUsed_ = newRegisterBitsUsed - 8 * sizeof(RegisterT);
+      RegisterT value = static_cast<RegisterT>(pending);
+      SWAB(&value); /// swab if necessary
+      memcpy(outp + outTransferred, &value, sizeof(RegisterT));
+      outTransferred += sizeof(RegisterT);
+      pending >>= 8 * sizeof(RegisterT);
+      pendingBits -= 8 * sizeof(RegisterT);
     }
-    else if (newRegisterBitsUsed == 8 * sizeof(RegisterT))
-    {
-      /// Input will exactly fill register, insert value, then transfer
-      register_ |= static_cast<RegisterT>(uValue) << registerBitsUsed_;
+  }
+  register_         = static_cast<RegisterT>(pending);
+  registerBitsUsed_ = pendingBits;
 #ifdef E57_DEBUG
-      /// Before transfer, double check address within bounds
-      if (outTransferred >= transferMax)
-      {
-        throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "outTransferred=" + toString(outTransferred) + " transferMax" + toString(transferMax));
-      }
-#endif
-      outp[outTransferred] = register_;
-      SWAB(&outp[outTransferred]); /// swab if necessary
-      outTransferred++;
-
-      register_         = 0;
-      registerBitsUsed_ = 0;
-    }
-    else
-    {
-      /// There is extra room in register, insert value, but don't do transfer yet
-      register_ |= static_cast<RegisterT>(uValue) << registerBitsUsed_;
-      registerBitsUsed_ = newRegisterBitsUsed;
-    }
-#ifdef E57_MAX_VERBOSE
-    cout << "  After " << outTransferred << " transfers and " << i + 1 << " records, encoder:" << endl;
-    dump(4);
+  /// Double check the transfers stayed within bounds
+  if (outTransferred > transferMax * sizeof(RegisterT))
+    throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "outTransferred=" + toString(outTransferred) + " transferMax" + toString(transferMax));
 #endif
-  }
 
   /// Update tail of output buffer
-  outBufferEnd_ += outTransferred * sizeof(RegisterT);
+  outBufferEnd_ += outTransferred;
 #ifdef E57_DEBUG
   /// Double check end is ok
   if (outBufferEnd_ > outBuffer_.size())
@@ -7890,6 +10687,27 @@ float BitpackIntegerEncoder<RegisterT>::bitsPerRecord()
   return (static_cast<float>(bitsPerRecord_));
 }
 
+template <typename RegisterT>
+uint64_t BitpackIntegerEncoder<RegisterT>::outputRecordNumber()
+{
+  /// Records are packed back to back, so the record holding the next bit is easy to calculate
+  return ((8 * outputByteCount_) / bitsPerRecord_);
+}
+
+template <typename RegisterT>
+bool BitpackIntegerEncoder<RegisterT>::outputAvailableAfter(size_t recordCount, size_t& byteCount)
+{
+  /// Same limit as processRecords()
+  size_t outputWordCapacity = (outBuffer_.size() - outBufferEndAfterShiftDown()) / sizeof(RegisterT);
+  size_t maxOutputRecords   = (outputWordCapacity * 8 * sizeof(RegisterT) + 8 * sizeof(RegisterT) - registerBitsUsed_ - 1) / bitsPerRecord_;
+  if (recordCount > maxOutputRecords)
+    return (false);
+
+  /// Only whole registers are output
+  byteCount = outputAvailable() + (registerBitsUsed_ + static_cast<uint64_t>(recordCount) * bitsPerRecord_) / (8 * sizeof(RegisterT)) * sizeof(RegisterT);
+  return (true);
+}
+
 #ifdef E57_DEBUG
 template <typename RegisterT>
 void BitpackIntegerEncoder<RegisterT>::dump(int indent, std::ostream& os)
@@ -7909,9 +10727,12 @@ void BitpackIntegerEncoder<RegisterT>::dump(int indent, std::ostream& os)
 
 //================================================================
 
-ConstantIntegerEncoder::ConstantIntegerEncoder(unsigned bytestreamNumber, SourceDestBuffer& sbuf, int64_t minimum)
-: Encoder(bytestreamNumber), sourceBuffer_(sbuf.impl()), currentRecordIndex_(0), minimum_(minimum)
-{}
+ConstantIntegerEncoder::ConstantIntegerEncoder(bool isScaledInteger, unsigned bytestreamNumber, SourceDestBuffer& sbuf, int64_t minimum, double scale, double offset)
+: Encoder(bytestreamNumber), sourceBuffer_(sbuf.impl()), currentRecordIndex_(0), isScaledInteger_(isScaledInteger), minimum_(minimum), scale_(scale),
+  offset_(offset)
+{
+  loadIntegers_ = sourceBuffer_->loadIntegersKernel<uint8_t>(isScaledInteger_);
+}
 
 uint64_t ConstantIntegerEncoder::processRecords(size_t recordCount)
 {
@@ -7920,13 +10741,11 @@ uint64_t ConstantIntegerEncoder::processRecords(size_t recordCount)
   dump(4);
 #endif
 
-  /// Check that all source values are == minimum_
-  for (unsigned i = 0; i < recordCount; i++)
-  {
-    int64_t nextInt64 = sourceBuffer_->getNextInt64();
-    if (nextInt64 != minimum_)
-      throw E57_EXCEPTION2(E57_ERROR_VALUE_OUT_OF_BOUNDS, "nextInt64=" + toString(nextInt64) + " minimum=" + toString(minimum_));
-  }
+  /// Check that all source values are == minimum_, by loading blocks of them with minimum_ as the bounds.  Nothing is stored, so the raw values are dropped.
+  uint8_t               raw[256];
+  SourceDestBufferImpl* sbuf = sourceBuffer_.get();
+  for (size_t i = 0; i < recordCount; i += sizeof(raw))
+    (sbuf->*loadIntegers_)(raw, min(sizeof(raw), recordCount - i), minimum_, minimum_, scale_, offset_);
 
   /// Update counts of records processed
   currentRecordIndex_ += recordCount;
@@ -7950,6 +10769,12 @@ float ConstantIntegerEncoder::bitsPerRecord()
   return (0.0);
 }
 
+uint64_t ConstantIntegerEncoder::outputRecordNumber()
+{
+  /// We don't produce any output, so don't restrict where records start
+  return (E57_UINT64_MAX);
+}
+
 bool ConstantIntegerEncoder::registerFlushToOutput()
 {
   return (true);
@@ -7970,6 +10795,13 @@ void ConstantIntegerEncoder::outputRead(char* /*dest*/, const size_t byteCount)
 
 void ConstantIntegerEncoder::outputClear() {}
 
+bool ConstantIntegerEncoder::outputAvailableAfter(size_t /*recordCount*/, size_t& byteCount)
+{
+  /// We don't produce any output
+  byteCount = 0;
+  return (true);
+}
+
 void ConstantIntegerEncoder::sourceBufferSetNew(std::vector<SourceDestBuffer>& sbufs)
 {
   /// Verify that this encoder only has single input buffer
@@ -7977,6 +10809,7 @@ void ConstantIntegerEncoder::sourceBufferSetNew(std::vector<SourceDestBuffer>& s
     throw E57_EXCEPTION2(E57_ERROR_INTERNAL, "sbufsSize=" + toString(sbufs.size()));
 
   sourceBuffer_ = sbufs.at(0).impl();
+  loadIntegers_ = sourceBuffer_->loadIntegersKernel<uint8_t>(isScaledInteger_);
 }
 
 size_t ConstantIntegerEncoder::outputGetMaxSize()
@@ -7995,7 +10828,10 @@ void ConstantIntegerEncoder::dump(int indent, std::ostream& os)
 {
   Encoder::dump(indent, os);
   os << space(indent) << "currentRecordIndex:  " << currentRecordIndex_ << endl;
+  os << space(indent) << "isScaledInteger:     " << isScaledInteger_ << endl;
   os << space(indent) << "minimum:             " << minimum_ << endl;
+  os << space(indent) << "scale:               " << scale_ << endl;
+  os << space(indent) << "offset:              " << offset_ << endl;
   os << space(indent) << "sourceBuffer:" << endl;
   sourceBuffer_->dump(indent + 4, os);
 }
@@ -8018,6 +10854,14 @@ BitpackIntegerDecoder<RegisterT>::BitpackIntegerDecoder(bool isScaledInteger, un
   offset_          = offset;
   bitsPerRecord_   = imf->bitsNeeded(minimum_, maximum_);
   destBitMask_     = (bitsPerRecord_ == 64) ? ~0 : (1ULL << bitsPerRecord_) - 1;
+  storeIntegers_   = destBuffer_->storeIntegersKernel<UnpackedT>(isScaledInteger_);
+}
+
+template <typename RegisterT>
+void BitpackIntegerDecoder<RegisterT>::destBufferSetNew(vector<SourceDestBuffer>& dbufs)
+{
+  BitpackDecoder::destBufferSetNew(dbufs);
+  storeIntegers_ = destBuffer_->storeIntegersKernel<UnpackedT>(isScaledInteger_);
 }
 
 template <typename RegisterT>
@@ -8060,77 +10904,29 @@ size_t BitpackIntegerDecoder<RegisterT>::inputProcessAligned(const char* inbuf,
   cout << "  recordCount=" << recordCount << endl; //???
 #endif
 
-  const RegisterT* inp          = reinterpret_cast<const RegisterT*>(inbuf);
-  unsigned         wordPosition = 0; /// The index in inbuf of the word we are currently working on.
-
-  ///  For example on little endian machine:
-  ///  Assume: registerT=uint32_t, bitOffset=20, destBitMask=0x00007fff (for a 15 bit value).
-  ///  inp[wordPosition]                    LLLLLLLL LLLLXXXX XXXXXXXX XXXXXXXX   Note LSB of value is at bit20
-  ///  inp(wordPosition+1]                  XXXXXXXX XXXXXXXX XXXXXXXX XXXXXHHH   H=high bits of value, X=uninteresting bits
-  ///  low = inp[i] >> bitOffset            00000000 00000000 0000LLLL LLLLLLLL   L=low bits of value, X=uninteresting bits
-  ///  high = inp[i+1] << (32-bitOffset)    XXXXXXXX XXXXXXXX XHHH0000 00000000
-  ///  w = high | low                       XXXXXXXX XXXXXXXX XHHHLLLL LLLLLLLL
-  ///  destBitmask                          00000000 00000000 01111111 11111111
-  ///  w & mask                             00000000 00000000 0HHHLLLL LLLLLLLL
+  ///  Records are packed back to back starting at firstBit, least significant bit first, in little endian words.
+  ///  That is the same as a little endian stream of bytes, so records are extracted a block at a time by utils::unpack_bits(),
+  ///  which masks off the uninteresting bits and only touches the bytes that hold the records.
+  ///  endBit is on a byte boundary (inBuffer_ is filled a byte at a time), so nothing at or after endBit is read.
+  const size_t inbufSize = (endBit + 7) / 8;
+  size_t       bitOffset = firstBit;
 
-  size_t bitOffset = firstBit;
+  /// Unpack a block of records into raw, then hand the whole block to the store kernel selected for destBuffer_.
+  constexpr size_t      blockSize = 256;
+  UnpackedT             raw[blockSize];
+  SourceDestBufferImpl* dbuf = destBuffer_.get();
 
-  for (size_t i = 0; i < recordCount; i++)
+  for (size_t blockStart = 0; blockStart < recordCount; blockStart += blockSize)
   {
-    /// Get lower word (contains at least the LSbit of the value),
-    RegisterT low = inp[wordPosition];
-    SWAB(&low); // swab if necessary
-
-    /// Get upper word (may or may not contain interesting bits),
-    RegisterT high = inp[wordPosition + 1];
-    SWAB(&high); // swab if necessary
-
-    RegisterT w;
-    if (bitOffset > 0)
-    {
-      /// Shift high to just above the lower bits, shift low LSBit to bit0, OR together.
-      /// Note shifts are logical (not arithmetic) because using unsigned variables.
-      w = (high << (8 * sizeof(RegisterT) - bitOffset)) | (low >> bitOffset);
-    }
-    else
-    {
-      /// The left shift (used above) is not defined if shift is >= size of word
-      w = low;
-    }
-#ifdef E57_MAX_VERBOSE
-    cout << "  bitOffset: " << bitOffset << endl;
-    cout << "  low: " << binaryString(low) << endl;
-    cout << "  high:" << binaryString(high) << endl;
-    cout << "  w:   " << binaryString(w) << endl;
-#endif
-
-    /// Mask off uninteresting bits
-    w &= destBitMask_;
+    size_t blockCount = min(blockSize, recordCount - blockStart);
 
-    /// Add minimum_ to value to get back what writer originally sent
-    int64_t value = minimum_ + static_cast<uint64_t>(w);
+    utils::unpack_bits(inbuf, inbufSize, bitOffset, bitsPerRecord_, blockCount, raw);
+    bitOffset += blockCount * bitsPerRecord_;
 
+    /// Store the block in next available positions in the user's dest buffer, minimum_ is added back by the store kernel
+    (dbuf->*storeIntegers_)(raw, blockCount, minimum_, scale_, offset_);
 #ifdef E57_MAX_VERBOSE
-    cout << "  Storing value=" << value << endl;
-#endif
-
-    /// The parameter isScaledInteger_ determines which version of setNextInt64 gets called
-    if (isScaledInteger_)
-      destBuffer_->setNextInt64(value, scale_, offset_);
-    else
-      destBuffer_->setNextInt64(value);
-
-    /// Store the result in next available position in the user's dest buffer
-
-    /// Calc next bit alignment and which word it starts in
-    bitOffset += bitsPerRecord_;
-    if (bitOffset >= 8 * sizeof(RegisterT))
-    {
-      bitOffset -= 8 * sizeof(RegisterT);
-      wordPosition++;
-    }
-#ifdef E57_MAX_VERBOSE
-    cout << "  Processed " << i + 1 << " records, wordPosition=" << wordPosition << " decoder:" << endl;
+    cout << "  Processed " << blockStart + blockCount << " records, bitOffset=" << bitOffset << " decoder:" << endl;
     dump(4);
 #endif
   }
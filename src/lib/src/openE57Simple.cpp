@@ -796,6 +796,7 @@ DEALINGS IN THE SOFTWARE.
 #  error "no supported OS platform defined"
 #endif
 
+#include <new>
 #include <openE57/impl/openE57SimpleImpl.h>
 #include <openE57/openE57Simple.h>
 
@@ -987,6 +988,54 @@ void Data3D::Reset(void)
 }
 ////////////////////////////////////////////////////////////////////
 //
+//	e57::Data3DPointsData
+//
+Data3DPointsData::Data3DPointsData(void) : block_(nullptr)
+{
+  Reset();
+}
+
+Data3DPointsData::~Data3DPointsData(void)
+{
+  Reset();
+}
+
+void Data3DPointsData::Reset(void)
+{
+  if (block_ != nullptr)
+    ::operator delete(block_, std::align_val_t(alignment));
+  block_ = nullptr;
+
+  pointCount = 0;
+
+  cartesianX            = nullptr;
+  cartesianY            = nullptr;
+  cartesianZ            = nullptr;
+  cartesianInvalidState = nullptr;
+
+  intensity          = nullptr;
+  isIntensityInvalid = nullptr;
+
+  colorRed       = nullptr;
+  colorGreen     = nullptr;
+  colorBlue      = nullptr;
+  isColorInvalid = nullptr;
+
+  sphericalRange        = nullptr;
+  sphericalAzimuth      = nullptr;
+  sphericalElevation    = nullptr;
+  sphericalInvalidState = nullptr;
+
+  rowIndex    = nullptr;
+  columnIndex = nullptr;
+  returnIndex = nullptr;
+  returnCount = nullptr;
+
+  timeStamp          = nullptr;
+  isTimeStampInvalid = nullptr;
+}
+////////////////////////////////////////////////////////////////////
+//
 //	e57::Image2D
 //
 Image2D::Image2D(void)
@@ -1198,6 +1247,21 @@ CompressedVectorReader Reader ::SetUpData3DPointsData(
                                       rowIndex, columnIndex, returnIndex, returnCount, timeStamp, isTimeStampInvalid, pointDataExtension);
 }
 
+int64_t Reader ::GetData3DPointsDataSize(int32_t dataIndex // data block index given by the NewData3D
+) const
+{
+  return impl_->GetData3DPointsDataSize(dataIndex);
+}
+
+bool Reader ::ReadData3DPoints(int32_t           dataIndex,  // data block index given by the NewData3D
+                               Data3DPointsData& pointsData, // receives the arrays of point data
+                               void*             block,      // memory to lay the arrays out in, or nullptr to allocate it
+                               int64_t           blockSize   // size of block in bytes
+) const
+{
+  return impl_->ReadData3DPoints(dataIndex, pointsData, block, blockSize);
+}
+
 ////////////////////////////////////////////////////////////////////
 //
 //	e57::Writer
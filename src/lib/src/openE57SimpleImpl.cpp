@@ -66,8 +66,10 @@
 
 #include <openE57/impl/openE57SimpleImpl.h>
 #include <openE57/impl/time_conversion.h>
+#include <new>
 #include <random>
 #include <sstream>
+#include <type_traits>
 
 using namespace e57;
 using namespace std;
@@ -1579,6 +1581,140 @@ CompressedVectorReader ReaderImpl ::SetUpData3DPointsData(
   return reader;
 }
 
+/// Calls bind(name, array, scaled) for each standard field in the prototype, in prototype order, with the Data3DPointsData array that holds it
+template <typename Bind> static void forEachData3DPointsField(StructureNode& proto, Data3DPointsData& pointsData, Bind bind)
+{
+  int64_t protoCount = proto.childCount();
+
+  for (int64_t protoIndex = 0; protoIndex < protoCount; protoIndex++)
+  {
+    Node    node   = proto.get(protoIndex);
+    ustring name   = node.elementName();
+    bool    scaled = node.type() == NodeType::E57_SCALED_INTEGER ? true : false;
+
+    if (name.compare("cartesianX") == 0)
+      bind(name, pointsData.cartesianX, scaled);
+    else if (name.compare("cartesianY") == 0)
+      bind(name, pointsData.cartesianY, scaled);
+    else if (name.compare("cartesianZ") == 0)
+      bind(name, pointsData.cartesianZ, scaled);
+    else if (name.compare("cartesianInvalidState") == 0)
+      bind(name, pointsData.cartesianInvalidState, false);
+
+    else if (name.compare("sphericalRange") == 0)
+      bind(name, pointsData.sphericalRange, scaled);
+    else if (name.compare("sphericalAzimuth") == 0)
+      bind(name, pointsData.sphericalAzimuth, scaled);
+    else if (name.compare("sphericalElevation") == 0)
+      bind(name, pointsData.sphericalElevation, scaled);
+    else if (name.compare("sphericalInvalidState") == 0)
+      bind(name, pointsData.sphericalInvalidState, false);
+
+    else if (name.compare("rowIndex") == 0)
+      bind(name, pointsData.rowIndex, false);
+    else if (name.compare("columnIndex") == 0)
+      bind(name, pointsData.columnIndex, false);
+    else if (name.compare("returnIndex") == 0)
+      bind(name, pointsData.returnIndex, false);
+    else if (name.compare("returnCount") == 0)
+      bind(name, pointsData.returnCount, false);
+
+    else if (name.compare("timeStamp") == 0)
+      bind(name, pointsData.timeStamp, scaled);
+    else if (name.compare("isTimeStampInvalid") == 0)
+      bind(name, pointsData.isTimeStampInvalid, false);
+
+    else if (name.compare("intensity") == 0)
+      bind(name, pointsData.intensity, scaled);
+    else if (name.compare("isIntensityInvalid") == 0)
+      bind(name, pointsData.isIntensityInvalid, false);
+
+    else if (name.compare("colorRed") == 0)
+      bind(name, pointsData.colorRed, scaled);
+    else if (name.compare("colorGreen") == 0)
+      bind(name, pointsData.colorGreen, scaled);
+    else if (name.compare("colorBlue") == 0)
+      bind(name, pointsData.colorBlue, scaled);
+    else if (name.compare("isColorInvalid") == 0)
+      bind(name, pointsData.isColorInvalid, false);
+  }
+}
+
+/// Returns the bytes an array of count elements of elementSize takes in a Data3DPointsData block, which keeps the next array aligned
+static uint64_t data3DPointsArraySize(int64_t count, size_t elementSize)
+{
+  const uint64_t mask = Data3DPointsData::alignment - 1;
+  return ((static_cast<uint64_t>(count) * elementSize + mask) & ~mask);
+}
+
+//! This function returns the size of the block ReadData3DPoints() needs to hold all the points of a Data3D
+int64_t ReaderImpl ::GetData3DPointsDataSize(int32_t dataIndex //!< data block index given by the NewData3D
+)
+{
+  if (!IsOpen() || (dataIndex < 0) || (dataIndex >= data3D_.childCount()))
+    return -1;
+
+  StructureNode        scan(data3D_.get(dataIndex));
+  CompressedVectorNode points(scan.get("points"));
+  StructureNode        proto(points.prototype());
+  int64_t              pointCount = points.childCount();
+
+  /// Leave room to align the first array, in case the block isn't aligned
+  uint64_t         blockSize = Data3DPointsData::alignment - 1;
+  Data3DPointsData layout;
+  forEachData3DPointsField(proto, layout, [&](const ustring&, auto*& array, bool) { blockSize += data3DPointsArraySize(pointCount, sizeof(*array)); });
+
+  return static_cast<int64_t>(blockSize);
+}
+
+//! This function reads all the points of a Data3D in a single call
+bool ReaderImpl ::ReadData3DPoints(int32_t           dataIndex,  //!< data block index given by the NewData3D
+                                   Data3DPointsData& pointsData, //!< receives the arrays of point data
+                                   void*             block,      //!< memory to lay the arrays out in, or nullptr to allocate it
+                                   int64_t           blockSize   //!< size of block in bytes
+)
+{
+  pointsData.Reset();
+
+  int64_t neededSize = GetData3DPointsDataSize(dataIndex);
+  if (neededSize < 0)
+    return false;
+  if ((block != nullptr) && (blockSize < neededSize))
+    return false;
+
+  StructureNode        scan(data3D_.get(dataIndex));
+  CompressedVectorNode points(scan.get("points"));
+  StructureNode        proto(points.prototype());
+  int64_t              pointCount = points.childCount();
+
+  /// An empty Data3D has no arrays, since zero capacity buffers can't be read into
+  if (pointCount == 0)
+    return true;
+
+  /// Our own block is allocated aligned, so doesn't need the room to align the first array
+  if (block == nullptr)
+  {
+    block             = ::operator new(static_cast<size_t>(neededSize) - (Data3DPointsData::alignment - 1), std::align_val_t(Data3DPointsData::alignment));
+    pointsData.block_ = block;
+  }
+
+  /// Lay the arrays out one after the other, then read all the points into them at once
+  const uintptr_t          mask   = Data3DPointsData::alignment - 1;
+  char*                    cursor = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(block) + mask) & ~mask);
+  vector<SourceDestBuffer> destBuffers;
+  forEachData3DPointsField(proto, pointsData, [&](const ustring& name, auto*& array, bool scaled) {
+    array = reinterpret_cast<std::remove_reference_t<decltype(array)>>(cursor);
+    cursor += data3DPointsArraySize(pointCount, sizeof(*array));
+    destBuffers.push_back(SourceDestBuffer(imf_, name, array, static_cast<size_t>(pointCount), true, scaled));
+  });
+  pointsData.pointCount = pointCount;
+
+  if (!destBuffers.empty())
+    points.readParallel(destBuffers, 0, pointCount);
+
+  return true;
+}
+
 // #define TEST_EXTENSIONS
 ////////////////////////////////////////////////////////////////////
 //
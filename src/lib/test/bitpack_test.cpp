@@ -0,0 +1,277 @@
+/*
+ * bitpack_test.cpp - Tests for the bitpacked bytestream packer and unpacker
+ *
+ * Copyright (c) 2024 openE57 Contributors
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <doctest/doctest.h>
+#include <openE57/impl/bitpack.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace e57;
+
+namespace
+{
+  std::vector<std::uint64_t> pseudoRandomValues(std::size_t count, unsigned bits, std::uint64_t seed)
+  {
+    const std::uint64_t        mask = (bits >= 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+    std::vector<std::uint64_t> values(count);
+    for (auto& v : values)
+    {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      v    = (seed ^ (seed >> 29)) & mask;
+    }
+    /// Make sure all ones and all zeros are covered
+    if (count > 1)
+    {
+      values[0] = mask;
+      values[1] = 0;
+    }
+    return values;
+  }
+
+  /// Reference packer, one bit at a time, into exactly the bytes needed
+  std::vector<std::uint8_t> pack(const std::vector<std::uint64_t>& values, std::size_t firstBit, unsigned bits)
+  {
+    std::vector<std::uint8_t> bytes((firstBit + values.size() * bits + 7) / 8, 0xA5);
+    std::size_t               bit = firstBit;
+    for (std::uint64_t v : values)
+    {
+      for (unsigned i = 0; i < bits; i++, bit++)
+      {
+        const std::uint8_t b = static_cast<std::uint8_t>(1u << (bit % 8));
+        if ((v >> i) & 1)
+          bytes[bit / 8] |= b;
+        else
+          bytes[bit / 8] &= static_cast<std::uint8_t>(~b);
+      }
+    }
+    return bytes;
+  }
+
+  const utils::BitpackEngine allEngines[] = {utils::BitpackEngine::Scalar, utils::BitpackEngine::Sse41, utils::BitpackEngine::Avx2,
+                                             utils::BitpackEngine::Neon};
+
+  /// Appends the stream left by pack_bits(): the completed words, then the used bits of the pending word
+  std::vector<std::uint8_t> packedStream(const std::vector<std::uint8_t>& words, std::uint64_t pending, unsigned pendingBits)
+  {
+    std::vector<std::uint8_t> bytes(words);
+    for (unsigned i = 0; i < (pendingBits + 7) / 8; i++)
+      bytes.push_back(static_cast<std::uint8_t>(pending >> (8 * i)));
+    return bytes;
+  }
+
+  /// Clears the bits of the last byte after totalBits, the reference packer leaves them as they were
+  std::vector<std::uint8_t> trimmed(std::vector<std::uint8_t> bytes, std::size_t totalBits)
+  {
+    bytes.resize((totalBits + 7) / 8);
+    if (totalBits % 8)
+      bytes.back() &= static_cast<std::uint8_t>((1u << (totalBits % 8)) - 1);
+    return bytes;
+  }
+} // namespace
+
+TEST_SUITE("Bitpack Tests")
+{
+  TEST_CASE("Scalar engine is always supported and dispatch selects a supported engine")
+  {
+    REQUIRE(utils::bitpack_engine_supported(utils::BitpackEngine::Scalar));
+    REQUIRE(utils::bitpack_engine_supported(utils::bitpack_engine()));
+  }
+
+  TEST_CASE("All engines round trip every width")
+  {
+    /// Counts cover tails shorter than one vector iteration, and runs where the last values are too close to the end for a vector load
+    const std::size_t counts[] = {1, 7, 8, 9, 31, 100, 257};
+
+    for (unsigned bits = 1; bits <= 64; bits++)
+    {
+      for (std::size_t count : counts)
+      {
+        for (std::size_t firstBit : {0u, 1u, 5u, 7u, 8u, 13u, 63u})
+        {
+          const std::vector<std::uint64_t> values = pseudoRandomValues(count, bits, bits * 1000 + count + firstBit);
+          const std::vector<std::uint8_t>  bytes  = pack(values, firstBit, bits);
+
+          for (utils::BitpackEngine engine : allEngines)
+          {
+            INFO("engine=" << static_cast<int>(engine) << " bits=" << bits << " count=" << count << " firstBit=" << firstBit);
+
+            std::vector<std::uint64_t> out64(count);
+            utils::unpack_bits(bytes.data(), bytes.size(), firstBit, bits, count, out64.data(), engine);
+            REQUIRE(out64 == values);
+
+            if (bits <= 32)
+            {
+              std::vector<std::uint32_t> out32(count);
+              utils::unpack_bits(bytes.data(), bytes.size(), firstBit, bits, count, out32.data(), engine);
+              for (std::size_t k = 0; k < count; k++)
+              {
+                const std::uint64_t got = out32[k];
+                REQUIRE_EQ(values[k], got);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  TEST_CASE("Default dispatch matches the scalar engine")
+  {
+    for (unsigned bits : {1u, 12u, 18u, 24u, 25u, 26u, 32u, 48u, 57u, 64u})
+    {
+      const std::vector<std::uint64_t> values = pseudoRandomValues(4096, bits, bits);
+      const std::vector<std::uint8_t>  bytes  = pack(values, 3, bits);
+
+      std::vector<std::uint64_t> expected(values.size());
+      std::vector<std::uint64_t> got(values.size());
+      utils::unpack_bits(bytes.data(), bytes.size(), 3, bits, values.size(), expected.data(), utils::BitpackEngine::Scalar);
+      utils::unpack_bits(bytes.data(), bytes.size(), 3, bits, values.size(), got.data());
+      REQUIRE(got == expected);
+      REQUIRE(got == values);
+    }
+  }
+
+  TEST_CASE("All engines pack every width like the reference packer")
+  {
+    const std::size_t counts[] = {1, 7, 8, 9, 31, 100, 257};
+
+    for (unsigned bits = 1; bits <= 64; bits++)
+    {
+      for (std::size_t count : counts)
+      {
+        for (unsigned pendingBits : {0u, 1u, 7u, 32u, 63u})
+        {
+          /// The stream continues after pendingBits bits already in the pending word, which the reference packer sees as the first value
+          const std::uint64_t              pending   = pseudoRandomValues(1, pendingBits, bits + count)[0];
+          const std::vector<std::uint64_t> values    = pseudoRandomValues(count, bits, bits * 1000 + count + pendingBits);
+          const std::size_t                totalBits = pendingBits + count * bits;
+
+          std::vector<std::uint8_t> expected = pack(values, pendingBits, bits);
+          for (unsigned i = 0; i < pendingBits; i++)
+          {
+            const std::uint8_t b = static_cast<std::uint8_t>(1u << (i % 8));
+            expected[i / 8]      = ((pending >> i) & 1) ? (expected[i / 8] | b) : (expected[i / 8] & static_cast<std::uint8_t>(~b));
+          }
+          expected = trimmed(expected, totalBits);
+
+          /// Two calls, to check that the pending word carries over
+          const std::size_t split = count / 3;
+
+          for (utils::BitpackEngine engine : allEngines)
+          {
+            INFO("engine=" << static_cast<int>(engine) << " bits=" << bits << " count=" << count << " pendingBits=" << pendingBits);
+
+            std::vector<std::uint8_t> words(totalBits / 64 * 8);
+            std::uint64_t             pending64     = pending;
+            unsigned                  pendingBits64 = pendingBits;
+            std::size_t               written       = utils::pack_bits(values.data(), split, bits, pending64, pendingBits64, words.data());
+            written += utils::pack_bits(values.data() + split, count - split, bits, pending64, pendingBits64, words.data() + 8 * written);
+            REQUIRE_EQ(written, totalBits / 64);
+            REQUIRE(trimmed(packedStream(words, pending64, pendingBits64), totalBits) == expected);
+
+            if (bits <= 32)
+            {
+              const std::vector<std::uint32_t> values32(values.begin(), values.end());
+              std::uint64_t                    pending32     = pending;
+              unsigned                         pendingBits32 = pendingBits;
+              std::fill(words.begin(), words.end(), 0);
+              written = utils::pack_bits(values32.data(), split, bits, pending32, pendingBits32, words.data(), engine);
+              written += utils::pack_bits(values32.data() + split, count - split, bits, pending32, pendingBits32, words.data() + 8 * written, engine);
+              REQUIRE_EQ(written, totalBits / 64);
+              REQUIRE(trimmed(packedStream(words, pending32, pendingBits32), totalBits) == expected);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  TEST_CASE("All engines quantize like the scalar expression")
+  {
+    struct Field
+    {
+      double       scale;
+      double       offset;
+      std::int64_t minimum;
+      std::int64_t maximum;
+    };
+    /// The last two have the widest range allowed, the last one far from zero
+    const Field fields[] = {{0.001, 0.0, -1000000, 1000000},
+                            {1.0, -3.0, 0, 255},
+                            {0.0001, 12.5, -4000000000LL, 294967295LL},
+                            {0.5, 0.25, -1099511627776LL, -1099511627776LL + 4294967295LL}};
+
+    for (const Field& field : fields)
+    {
+      /// Real values spread over the field range, including exact halves that round up and both ends of the range
+      const std::size_t   count = 103;
+      std::vector<double> values(count);
+      for (std::size_t k = 0; k < count; k++)
+      {
+        const double raw = static_cast<double>(field.minimum) + static_cast<double>(field.maximum - field.minimum) * k / (count - 1);
+        values[k]        = (raw + ((k % 4 == 1) ? 0.5 : (k % 4 == 2) ? 0.3 : 0.0)) * field.scale + field.offset;
+      }
+
+      std::vector<std::uint32_t> expected(count);
+      for (std::size_t k = 0; k < count; k++)
+      {
+        std::int64_t raw = static_cast<std::int64_t>(floor((values[k] - field.offset) / field.scale + 0.5));
+        raw              = (raw < field.minimum) ? field.minimum : (field.maximum < raw) ? field.maximum : raw;
+        expected[k]      = static_cast<std::uint32_t>(raw - field.minimum);
+      }
+
+      for (utils::BitpackEngine engine : allEngines)
+      {
+        INFO("engine=" << static_cast<int>(engine) << " scale=" << field.scale << " minimum=" << field.minimum);
+
+        std::vector<std::uint32_t> out(count);
+        const bool                 ok = utils::quantize(values.data(), count, field.scale, field.offset, field.minimum, field.maximum, out.data(), engine);
+        REQUIRE(ok);
+        REQUIRE(out == expected);
+
+        /// Any value out of range, or NaN, fails the whole span, wherever it is
+        for (std::size_t bad : {std::size_t(0), std::size_t(5), count - 1})
+        {
+          for (double badValue : {(static_cast<double>(field.maximum) + 1.0) * field.scale + field.offset,
+                                  (static_cast<double>(field.minimum) - 1.0) * field.scale + field.offset, std::nan("")})
+          {
+            std::vector<double> badValues(values);
+            badValues[bad] = badValue;
+            const bool badOk = utils::quantize(badValues.data(), count, field.scale, field.offset, field.minimum, field.maximum, out.data(), engine);
+            REQUIRE_FALSE(badOk);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,197 @@
+/*
+ * checked_file_test.cpp - Tests for the paged, checksummed file layer
+ *
+ * Copyright (c) 2024 openE57 Contributors
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include "test_utils.h"
+#include <openE57/impl/openE57Impl.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+using namespace e57;
+using e57::test::TempFile;
+
+namespace
+{
+  std::vector<char> patternBytes(std::size_t size, std::uint32_t seed)
+  {
+    std::vector<char> bytes(size);
+    for (auto& b : bytes)
+    {
+      seed = seed * 1664525u + 1013904223u;
+      b    = static_cast<char>(seed >> 24);
+    }
+    return (bytes);
+  }
+
+  /// Size of the file on disk, which doesn't count pages still held in the write cache
+  std::uint64_t diskSize(const TempFile& file)
+  {
+    return (std::filesystem::file_size(file.string()));
+  }
+
+  /// Reopen the file read only, which verifies the checksum of every page read, and return its first size logical bytes.
+  /// The length of a file opened for reading is always whole pages.
+  std::vector<char> readBack(const TempFile& file, std::size_t size)
+  {
+    CheckedFile cf(file.string(), CheckedFile::readOnly);
+    REQUIRE_EQ(cf.length(CheckedFile::physical) / CheckedFile::physicalPageSize * CheckedFile::logicalPageSize, cf.length(CheckedFile::logical));
+    REQUIRE(cf.length(CheckedFile::logical) >= size);
+    std::vector<char> bytes(size);
+    cf.read(bytes.data(), bytes.size());
+    cf.close();
+    return (bytes);
+  }
+} // namespace
+
+TEST_SUITE("CheckedFile Tests")
+{
+  TEST_CASE("Dirty pages count towards the length and read back before they are flushed")
+  {
+    TempFile          tempFile;
+    const std::size_t size  = 2 * CheckedFile::logicalPageSize + 500;
+    std::vector<char> bytes = patternBytes(size, 1);
+
+    CheckedFile cf(tempFile.string(), CheckedFile::writeCreate);
+    cf.write(bytes.data(), size);
+    REQUIRE_EQ(0U, diskSize(tempFile));
+    REQUIRE_EQ(size, cf.length(CheckedFile::logical));
+    REQUIRE_EQ(3 * CheckedFile::physicalPageSize, cf.length(CheckedFile::physical));
+    REQUIRE_EQ(size, cf.position(CheckedFile::logical));
+
+    /// Read across a page boundary from the cache only
+    std::vector<char> middle(1000);
+    cf.seek(CheckedFile::logicalPageSize - 300);
+    cf.read(middle.data(), middle.size());
+    REQUIRE(std::equal(middle.begin(), middle.end(), bytes.begin() + CheckedFile::logicalPageSize - 300));
+
+    cf.close();
+    REQUIRE_EQ(3 * CheckedFile::physicalPageSize, diskSize(tempFile));
+    REQUIRE(readBack(tempFile, bytes.size()) == bytes);
+  }
+
+  TEST_CASE("Filling the write cache flushes every page but the partially filled tail")
+  {
+    TempFile          tempFile;
+    const std::size_t full  = CheckedFile::writeCachePages * CheckedFile::logicalPageSize;
+    std::vector<char> bytes = patternBytes(full + 500, 2);
+
+    CheckedFile cf(tempFile.string(), CheckedFile::writeCreate);
+    cf.write(bytes.data(), bytes.size());
+
+    /// Everything up to the tail page is on disk with its checksums, the tail is still cached
+    REQUIRE_EQ(CheckedFile::writeCachePages * CheckedFile::physicalPageSize, diskSize(tempFile));
+    REQUIRE_EQ((CheckedFile::writeCachePages + 1) * CheckedFile::physicalPageSize, cf.length(CheckedFile::physical));
+
+    /// Read back over the flushed pages and the cached tail
+    std::vector<char> tail(1000);
+    cf.seek(full - 500);
+    cf.read(tail.data(), tail.size());
+    REQUIRE(std::equal(tail.begin(), tail.end(), bytes.begin() + full - 500));
+
+    /// Appending completes the cached tail page rather than rereading it from disk
+    std::vector<char> more = patternBytes(CheckedFile::logicalPageSize, 3);
+    cf.seek(bytes.size());
+    cf.write(more.data(), more.size());
+    bytes.insert(bytes.end(), more.begin(), more.end());
+    cf.close();
+
+    REQUIRE_EQ((CheckedFile::writeCachePages + 2) * CheckedFile::physicalPageSize, diskSize(tempFile));
+    REQUIRE(readBack(tempFile, bytes.size()) == bytes);
+  }
+
+  TEST_CASE("Overwriting flushed pages rereads them and rewrites their checksums")
+  {
+    TempFile          tempFile;
+    std::vector<char> bytes = patternBytes(3 * CheckedFile::logicalPageSize, 4);
+
+    CheckedFile cf(tempFile.string(), CheckedFile::writeCreate);
+    cf.write(bytes.data(), bytes.size());
+    cf.flush();
+    REQUIRE_EQ(3 * CheckedFile::physicalPageSize, diskSize(tempFile));
+
+    /// Like the header rewritten at close, plus a write straddling the first two pages
+    std::vector<char> header = patternBytes(48, 5);
+    cf.seek(0);
+    cf.write(header.data(), header.size());
+    std::copy(header.begin(), header.end(), bytes.begin());
+
+    std::vector<char> straddle = patternBytes(200, 6);
+    cf.seek(CheckedFile::logicalPageSize - 100);
+    cf.write(straddle.data(), straddle.size());
+    std::copy(straddle.begin(), straddle.end(), bytes.begin() + CheckedFile::logicalPageSize - 100);
+
+    /// Overwrites don't change the length, and the untouched bytes of the pages survive
+    REQUIRE_EQ(bytes.size(), cf.length(CheckedFile::logical));
+    std::vector<char> current(bytes.size());
+    cf.seek(0);
+    cf.read(current.data(), current.size());
+    REQUIRE(current == bytes);
+
+    cf.close();
+    REQUIRE_EQ(3 * CheckedFile::physicalPageSize, diskSize(tempFile));
+    REQUIRE(readBack(tempFile, bytes.size()) == bytes);
+  }
+
+  TEST_CASE("Extending past cached pages appends zeros after them")
+  {
+    TempFile          tempFile;
+    std::vector<char> bytes = patternBytes(100, 7);
+
+    CheckedFile cf(tempFile.string(), CheckedFile::writeCreate);
+    cf.write(bytes.data(), bytes.size());
+    cf.extend(5 * CheckedFile::logicalPageSize);
+    REQUIRE_EQ(0U, diskSize(tempFile));
+    REQUIRE_EQ(5 * CheckedFile::logicalPageSize, cf.length(CheckedFile::logical));
+    REQUIRE_EQ(5 * CheckedFile::physicalPageSize, cf.length(CheckedFile::physical));
+    REQUIRE_EQ(5 * CheckedFile::logicalPageSize, cf.position(CheckedFile::logical));
+
+    bytes.resize(5 * CheckedFile::logicalPageSize, 0);
+    std::vector<char> current(bytes.size());
+    cf.seek(0);
+    cf.read(current.data(), current.size());
+    REQUIRE(current == bytes);
+
+    /// Extending again once the pages are on disk
+    cf.flush();
+    cf.extend(6 * CheckedFile::logicalPageSize + 10);
+    bytes.resize(6 * CheckedFile::logicalPageSize + 10, 0);
+    REQUIRE_EQ(bytes.size(), cf.length(CheckedFile::logical));
+
+    /// Shrinking isn't allowed
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_INTERNAL, [&]() { cf.extend(10); }));
+
+    cf.close();
+    REQUIRE_EQ(7 * CheckedFile::physicalPageSize, diskSize(tempFile));
+
+    REQUIRE(readBack(tempFile, bytes.size()) == bytes);
+  }
+}
@@ -29,8 +29,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
 #include "test_utils.h"
+#include <openE57/impl/openE57Impl.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
+#include <thread>
 
 using namespace e57;
 using e57::test::TempFile;
@@ -463,7 +472,7 @@ TEST_SUITE("CompressedVectorReader Tests")
     }
   }
 
-  TEST_CASE("CompressedVectorReader seek throws not-implemented")
+  TEST_CASE("CompressedVectorReader seek to start and end")
   {
     TempFile tempFile;
 
@@ -508,7 +517,25 @@ TEST_SUITE("CompressedVectorReader Tests")
       buffers.push_back(SourceDestBuffer(imf, "value", readData, 5, true, true));
 
       CompressedVectorReader reader = cv.reader(buffers);
-      REQUIRE_THROWS_AS(reader.seek(0), E57Exception);
+      REQUIRE_EQ(N, reader.read());
+
+      reader.seek(0);
+      std::fill(readData, readData + 5, 0);
+      REQUIRE_EQ(N, reader.read());
+      for (size_t i = 0; i < N; ++i)
+      {
+        REQUIRE_EQ(writeData[i], readData[i]);
+      }
+
+      reader.seek(3);
+      REQUIRE_EQ(2, reader.read());
+      REQUIRE_EQ(writeData[3], readData[0]);
+      REQUIRE_EQ(writeData[4], readData[1]);
+
+      /// One past the end is allowed, further is not
+      reader.seek(N);
+      REQUIRE_EQ(0, reader.read());
+      REQUIRE_THROWS_AS(reader.seek(N + 1), E57Exception);
 
       reader.close();
       imf.close();
@@ -844,32 +871,43 @@ TEST_SUITE("CompressedVector Edge Cases")
     }
   }
 
-  TEST_CASE("CompressedVector seek throws not-implemented")
+  TEST_CASE("CompressedVector decodes into every memory representation")
   {
     TempFile tempFile;
 
-    const size_t         N = 10;
-    std::vector<int64_t> writeData(N);
+    /// More records than one decode block, values of "i" leave int8 range for the first time at record 228
+    const size_t         N = 1000;
+    std::vector<int64_t> iData(N);
+    std::vector<int64_t> sData(N);
+    std::vector<double>  dData(N);
+
     for (size_t i = 0; i < N; ++i)
     {
-      writeData[i] = static_cast<int64_t>(i);
+      iData[i] = static_cast<int64_t>(i % 300) - 100;
+      sData[i] = static_cast<int64_t>(i * 37) - 20000;
+      dData[i] = static_cast<double>(i) * 0.75 - 300.0;
     }
 
     {
       ImageFile     imf(tempFile.c_str(), "w");
       StructureNode root = imf.root();
       root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
-      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000203}"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-000000000210}"));
 
       StructureNode proto(imf);
-      proto.set("value", IntegerNode(imf, 0, 0, 200));
+      proto.set("i", IntegerNode(imf, 0, -1000, 1000));
+      proto.set("s", ScaledIntegerNode(imf, 0, -100000, 100000, 0.01, 1.0));
+      proto.set("d", FloatNode(imf, 0.0, E57_DOUBLE));
+
+      VectorNode codecs(imf, true);
 
-      VectorNode           codecs(imf, true);
       CompressedVectorNode cv(imf, proto, codecs);
       root.set("data", cv);
 
       std::vector<SourceDestBuffer> buffers;
-      buffers.push_back(SourceDestBuffer(imf, "value", writeData.data(), N, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "i", iData.data(), N, true, false));
+      buffers.push_back(SourceDestBuffer(imf, "s", sData.data(), N, true, false));
+      buffers.push_back(SourceDestBuffer(imf, "d", dData.data(), N, true, false));
 
       CompressedVectorWriter writer = cv.writer(buffers);
       writer.write(N);
@@ -878,20 +916,2493 @@ TEST_SUITE("CompressedVector Edge Cases")
       imf.close();
     }
 
+    ImageFile            imf(tempFile.c_str(), "r");
+    CompressedVectorNode cv(imf.root().get("data"));
+
+    /// Contiguous narrowing, widening to real, scaled and unscaled
     {
-      ImageFile     imf(tempFile.c_str(), "r");
+      std::vector<int16_t> i16(N);
+      std::vector<double>  iReal(N);
+      std::vector<double>  sScaled(N);
+      std::vector<int32_t> sRounded(N);
+      std::vector<float>   dNarrow(N);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "i", i16.data(), N, false, false));
+      buffers.push_back(SourceDestBuffer(imf, "s", sScaled.data(), N, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "d", dNarrow.data(), N, false, false));
+
+      CompressedVectorReader reader = cv.reader(buffers);
+      unsigned               count  = reader.read();
+      reader.close();
+      REQUIRE_EQ(N, count);
+
+      std::vector<SourceDestBuffer> buffers2;
+      buffers2.push_back(SourceDestBuffer(imf, "i", iReal.data(), N, true, false));
+      buffers2.push_back(SourceDestBuffer(imf, "s", sRounded.data(), N, true, true));
+
+      CompressedVectorReader reader2 = cv.reader(buffers2);
+      unsigned               count2  = reader2.read();
+      reader2.close();
+      REQUIRE_EQ(N, count2);
+
+      for (size_t i = 0; i < N; ++i)
+      {
+        REQUIRE_EQ(iData[i], static_cast<int64_t>(i16[i]));
+        REQUIRE_EQ(static_cast<double>(iData[i]), iReal[i]);
+        REQUIRE(std::abs(sScaled[i] - (sData[i] * 0.01 + 1.0)) < 1e-9);
+        int32_t rounded = static_cast<int32_t>(std::floor(sData[i] * 0.01 + 1.0 + 0.5));
+        REQUIRE_EQ(rounded, sRounded[i]);
+        REQUIRE_EQ(static_cast<float>(dData[i]), dNarrow[i]);
+      }
+    }
+
+    /// Strided destinations, raw value of a scaled integer, real to integer and bool
+    {
+      struct Point
+      {
+        int32_t i;
+        int64_t s;
+        int32_t d;
+        bool    b;
+      };
+      std::vector<Point> points(N);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "i", &points[0].i, N, false, false, sizeof(Point)));
+      buffers.push_back(SourceDestBuffer(imf, "s", &points[0].s, N, false, false, sizeof(Point)));
+      buffers.push_back(SourceDestBuffer(imf, "d", &points[0].d, N, true, false, sizeof(Point)));
+
+      CompressedVectorReader reader = cv.reader(buffers);
+      unsigned               count  = reader.read();
+      reader.close();
+      REQUIRE_EQ(N, count);
+
+      std::vector<SourceDestBuffer> buffers2;
+      buffers2.push_back(SourceDestBuffer(imf, "i", &points[0].b, N, false, false, sizeof(Point)));
+
+      CompressedVectorReader reader2 = cv.reader(buffers2);
+      unsigned               count2  = reader2.read();
+      reader2.close();
+      REQUIRE_EQ(N, count2);
+
+      for (size_t i = 0; i < N; ++i)
+      {
+        REQUIRE_EQ(iData[i], static_cast<int64_t>(points[i].i));
+        REQUIRE_EQ(sData[i], points[i].s);
+        REQUIRE_EQ(static_cast<int32_t>(dData[i]), points[i].d);
+        bool expected = (iData[i] == 0);
+        REQUIRE_EQ(expected, points[i].b);
+      }
+    }
+
+    /// Out of range value is reported, and every record before it has been stored
+    {
+      std::vector<int8_t> i8(N, 0);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "i", i8.data(), N, false, false));
+
+      CompressedVectorReader reader    = cv.reader(buffers);
+      int                    errorCode = 0;
+      try
+      {
+        reader.read();
+      }
+      catch (E57Exception& ex)
+      {
+        errorCode = ex.errorCode();
+      }
+      REQUIRE_EQ(static_cast<int>(E57_ERROR_VALUE_NOT_REPRESENTABLE), errorCode);
+
+      for (size_t i = 0; i < 228; ++i)
+      {
+        REQUIRE_EQ(iData[i], static_cast<int64_t>(i8[i]));
+      }
+      reader.close();
+    }
+
+    /// Real fields require conversion to be stored in an integer buffer
+    {
+      std::vector<int32_t> d32(N);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "d", d32.data(), N, false, false));
+
+      CompressedVectorReader reader    = cv.reader(buffers);
+      int                    errorCode = 0;
+      try
+      {
+        reader.read();
+      }
+      catch (E57Exception& ex)
+      {
+        errorCode = ex.errorCode();
+      }
+      REQUIRE_EQ(static_cast<int>(E57_ERROR_CONVERSION_REQUIRED), errorCode);
+      reader.close();
+    }
+
+    imf.close();
+  }
+
+  TEST_CASE("CompressedVector round trips every integer width")
+  {
+    TempFile tempFile;
+
+    /// One field per width, so each bitpack decoder register size and every unpack width is exercised
+    const size_t                      N = 700;
+    std::vector<std::vector<int64_t>> writeData(64, std::vector<int64_t>(N));
+
+    uint64_t seed = 57;
+    for (unsigned bits = 1; bits <= 64; ++bits)
+    {
+      const int64_t  minimum = (bits == 64) ? E57_INT64_MIN : -(int64_t(1) << (bits - 1));
+      const uint64_t mask    = (bits == 64) ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+      for (size_t i = 0; i < N; ++i)
+      {
+        seed                   = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        writeData[bits - 1][i] = static_cast<int64_t>(static_cast<uint64_t>(minimum) + ((seed ^ (seed >> 31)) & mask));
+      }
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
       StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-000000000211}"));
 
-      CompressedVectorNode cv(root.get("data"));
+      StructureNode proto(imf);
+      for (unsigned bits = 1; bits <= 64; ++bits)
+      {
+        const int64_t minimum = (bits == 64) ? E57_INT64_MIN : -(int64_t(1) << (bits - 1));
+        const int64_t maximum = (bits == 64) ? E57_INT64_MAX : (int64_t(1) << (bits - 1)) - 1;
+        proto.set("w" + std::to_string(bits), IntegerNode(imf, 0, minimum, maximum));
+      }
+
+      VectorNode codecs(imf, true);
+
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
 
-      int64_t                       readData[5] = {0};
       std::vector<SourceDestBuffer> buffers;
-      buffers.push_back(SourceDestBuffer(imf, "value", readData, 5, true, true));
+      for (unsigned bits = 1; bits <= 64; ++bits)
+        buffers.push_back(SourceDestBuffer(imf, "w" + std::to_string(bits), writeData[bits - 1].data(), N, true, false));
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+
+      imf.close();
+    }
+
+    {
+      ImageFile            imf(tempFile.c_str(), "r");
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      std::vector<std::vector<int64_t>> readData(64, std::vector<int64_t>(N));
+      std::vector<SourceDestBuffer>     buffers;
+      for (unsigned bits = 1; bits <= 64; ++bits)
+        buffers.push_back(SourceDestBuffer(imf, "w" + std::to_string(bits), readData[bits - 1].data(), N, true, false));
+
+      CompressedVectorReader reader = cv.reader(buffers);
+      unsigned               count  = reader.read();
+      reader.close();
+
+      REQUIRE_EQ(N, count);
+      for (unsigned bits = 1; bits <= 64; ++bits)
+      {
+        INFO("bits=" << bits);
+        REQUIRE(readData[bits - 1] == writeData[bits - 1]);
+      }
+
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVector encodes from every memory representation")
+  {
+    TempFile tempFile;
+
+    /// More records than one encode block, written from contiguous doubles (the vectorized path), strided floats and converted integers
+    const size_t N = 1000;
+    struct Point
+    {
+      float   s;
+      int16_t i;
+    };
+    std::vector<double>  sDoubles(N);
+    std::vector<Point>   points(N);
+    std::vector<double>  iDoubles(N);
+    std::vector<int64_t> sExpected(N);
+    std::vector<int64_t> iExpected(N);
+
+    for (size_t i = 0; i < N; ++i)
+    {
+      sDoubles[i]  = static_cast<double>(i) * 1.37 - 600.0 + ((i % 3 == 0) ? 0.005 : 0.0);
+      points[i].s  = static_cast<float>(sDoubles[i]);
+      points[i].i  = static_cast<int16_t>(static_cast<int>(i % 2000) - 1000);
+      iDoubles[i]  = static_cast<double>(i) * 1.5 - 700.25;
+      sExpected[i] = static_cast<int64_t>(std::floor((sDoubles[i] - 1.0) / 0.01 + 0.5));
+      iExpected[i] = static_cast<int64_t>(iDoubles[i]);
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-000000000212}"));
+
+      StructureNode proto(imf);
+      proto.set("s", ScaledIntegerNode(imf, 0, -100000, 100000, 0.01, 1.0));
+      proto.set("i", IntegerNode(imf, 0, -1000, 1000));
+
+      for (const char* name : {"contiguous", "strided", "outOfBounds", "notANumber", "unconverted"})
+      {
+        VectorNode codecs(imf, true);
+        root.set(name, CompressedVectorNode(imf, proto, codecs));
+      }
+
+      {
+        CompressedVectorNode          cv(root.get("contiguous"));
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "s", sDoubles.data(), N, true, true));
+        buffers.push_back(SourceDestBuffer(imf, "i", iDoubles.data(), N, true, false));
+        CompressedVectorWriter writer = cv.writer(buffers);
+        writer.write(N);
+        writer.close();
+      }
+
+      {
+        CompressedVectorNode          cv(root.get("strided"));
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "s", &points[0].s, N, true, true, sizeof(Point)));
+        buffers.push_back(SourceDestBuffer(imf, "i", &points[0].i, N, true, false, sizeof(Point)));
+        CompressedVectorWriter writer = cv.writer(buffers);
+        writer.write(N);
+        writer.close();
+      }
+
+      /// A single bad value anywhere fails the write, with the same error as a record by record encoder
+      struct Failure
+      {
+        const char* name;
+        double      value;
+        int         errorCode;
+      };
+      const Failure failures[] = {{"outOfBounds", 1001.02, E57_ERROR_VALUE_OUT_OF_BOUNDS},
+                                  {"notANumber", std::nan(""), E57_ERROR_VALUE_OUT_OF_BOUNDS},
+                                  {"unconverted", 0.0, E57_ERROR_CONVERSION_REQUIRED}};
+      for (const Failure& failure : failures)
+      {
+        INFO("cv=" << failure.name);
+        std::vector<double> bad(sDoubles);
+        bad[517] = failure.value;
+
+        CompressedVectorNode          cv(root.get(failure.name));
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "s", bad.data(), N, true, true));
+        buffers.push_back(SourceDestBuffer(imf, "i", iDoubles.data(), N, failure.errorCode != E57_ERROR_CONVERSION_REQUIRED, false));
+        CompressedVectorWriter writer    = cv.writer(buffers);
+        int                    errorCode = 0;
+        try
+        {
+          writer.write(N);
+        }
+        catch (E57Exception& ex)
+        {
+          errorCode = ex.errorCode();
+        }
+        REQUIRE_EQ(failure.errorCode, errorCode);
+      }
+
+      imf.close();
+    }
+
+    {
+      ImageFile imf(tempFile.c_str(), "r");
+      for (const char* name : {"contiguous", "strided"})
+      {
+        INFO("cv=" << name);
+        CompressedVectorNode cv(imf.root().get(name));
+
+        std::vector<int64_t>          sRaw(N);
+        std::vector<int64_t>          iRaw(N);
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "s", sRaw.data(), N, true, false));
+        buffers.push_back(SourceDestBuffer(imf, "i", iRaw.data(), N, true, false));
+
+        CompressedVectorReader reader = cv.reader(buffers);
+        unsigned               count  = reader.read();
+        reader.close();
+        REQUIRE_EQ(N, count);
+
+        for (size_t i = 0; i < N; ++i)
+        {
+          INFO("record=" << i);
+          const int64_t s = (name[0] == 'c') ? sExpected[i] : static_cast<int64_t>(std::floor((points[i].s - 1.0) / 0.01 + 0.5));
+          const int64_t v = (name[0] == 'c') ? iExpected[i] : points[i].i;
+          REQUIRE_EQ(s, sRaw[i]);
+          REQUIRE_EQ(v, iRaw[i]);
+        }
+      }
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVector encodes float fields from every memory representation")
+  {
+    TempFile tempFile;
+
+    /// More records than one encode block, written from contiguous floats/doubles (copied or widened in bulk), strided structs and integers
+    const size_t N = 1000;
+    struct Point
+    {
+      double  d;
+      float   s;
+      int32_t i;
+    };
+    std::vector<float>   floats(N);
+    std::vector<double>  doubles(N);
+    std::vector<Point>   points(N);
+    std::vector<int32_t> ints(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+      floats[i]   = static_cast<float>(i) * 0.37f - 100.0f;
+      doubles[i]  = static_cast<double>(i) * 1e-7 + 1.0 / 3.0;
+      points[i].d = doubles[i] * 3.0;
+      points[i].s = floats[i] * 2.0f;
+      points[i].i = static_cast<int32_t>(i) - 500;
+      ints[i]     = static_cast<int32_t>(i * 977) - 400000;
+    }
+
+    struct Source
+    {
+      const char* name;
+      std::function<SourceDestBuffer(ImageFile&, const char*)> buffer;
+      std::function<double(size_t)>                            value;
+    };
+    const Source sources[] = {
+        {"floats", [&](ImageFile& imf, const char* field) { return SourceDestBuffer(imf, field, floats.data(), N, true); },
+         [&](size_t i) { return static_cast<double>(floats[i]); }},
+        {"doubles", [&](ImageFile& imf, const char* field) { return SourceDestBuffer(imf, field, doubles.data(), N, true); },
+         [&](size_t i) { return doubles[i]; }},
+        {"stridedDoubles", [&](ImageFile& imf, const char* field) { return SourceDestBuffer(imf, field, &points[0].d, N, true, false, sizeof(Point)); },
+         [&](size_t i) { return points[i].d; }},
+        {"stridedFloats", [&](ImageFile& imf, const char* field) { return SourceDestBuffer(imf, field, &points[0].s, N, true, false, sizeof(Point)); },
+         [&](size_t i) { return static_cast<double>(points[i].s); }},
+        {"ints", [&](ImageFile& imf, const char* field) { return SourceDestBuffer(imf, field, ints.data(), N, true); },
+         [&](size_t i) { return static_cast<double>(ints[i]); }},
+        {"stridedInts", [&](ImageFile& imf, const char* field) { return SourceDestBuffer(imf, field, &points[0].i, N, true, false, sizeof(Point)); },
+         [&](size_t i) { return static_cast<double>(points[i].i); }},
+    };
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-000000000219}"));
+
+      StructureNode proto(imf);
+      proto.set("single", FloatNode(imf, 0.0, E57_SINGLE));
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+
+      for (const Source& source : sources)
+      {
+        VectorNode           codecs(imf, true);
+        CompressedVectorNode cv(imf, proto, codecs);
+        root.set(source.name, cv);
+
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(source.buffer(imf, "single"));
+        buffers.push_back(source.buffer(imf, "double"));
+        CompressedVectorWriter writer = cv.writer(buffers);
+        writer.write(N);
+        writer.close();
+      }
+
+      /// A double too large for a single precision field, or an integer without conversion, fails with the record by record error
+      struct Failure
+      {
+        const char* name;
+        double      value;
+        bool        doConversion;
+        int         errorCode;
+      };
+      const Failure failures[] = {{"infinity", std::numeric_limits<double>::infinity(), true, E57_ERROR_REAL64_TOO_LARGE},
+                                  {"unconverted", 0.0, false, E57_ERROR_CONVERSION_REQUIRED}};
+      for (const Failure& failure : failures)
+      {
+        INFO("cv=" << failure.name);
+        std::vector<double> bad(doubles);
+        bad[517] = failure.value;
+
+        VectorNode           codecs(imf, true);
+        CompressedVectorNode cv(imf, proto, codecs);
+        root.set(failure.name, cv);
+
+        std::vector<SourceDestBuffer> buffers;
+        if (failure.doConversion)
+          buffers.push_back(SourceDestBuffer(imf, "single", bad.data(), N, true));
+        else
+          buffers.push_back(SourceDestBuffer(imf, "single", ints.data(), N, false));
+        buffers.push_back(SourceDestBuffer(imf, "double", doubles.data(), N, true));
+        CompressedVectorWriter writer    = cv.writer(buffers);
+        int                    errorCode = 0;
+        try
+        {
+          writer.write(N);
+        }
+        catch (E57Exception& ex)
+        {
+          errorCode = ex.errorCode();
+        }
+        REQUIRE_EQ(failure.errorCode, errorCode);
+      }
+
+      imf.close();
+    }
+
+    {
+      ImageFile imf(tempFile.c_str(), "r");
+      for (const Source& source : sources)
+      {
+        INFO("cv=" << source.name);
+        CompressedVectorNode cv(imf.root().get(source.name));
+
+        std::vector<float>            single(N);
+        std::vector<double>           dbl(N);
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "single", single.data(), N));
+        buffers.push_back(SourceDestBuffer(imf, "double", dbl.data(), N));
+
+        CompressedVectorReader reader = cv.reader(buffers);
+        unsigned               count  = reader.read();
+        reader.close();
+        REQUIRE_EQ(N, count);
+
+        for (size_t i = 0; i < N; ++i)
+        {
+          INFO("record=" << i);
+          REQUIRE_EQ(static_cast<float>(source.value(i)), single[i]);
+          REQUIRE_EQ(source.value(i), dbl[i]);
+        }
+      }
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVector constant fields in every memory representation")
+  {
+    TempFile tempFile;
+
+    /// Fields with minimum == maximum take no bits in the file, but are still checked on write and stored on read a block at a time
+    const size_t         N = 1000;
+    std::vector<int16_t> ints(N, -3);
+    std::vector<double>  scaled(N, 2.5); /// raw -3 with scale 0.5 and offset 4
+    std::vector<float>   floats(N, -3.0f);
+    std::vector<int32_t> index(N);
+    for (size_t i = 0; i < N; ++i)
+      index[i] = static_cast<int32_t>(i);
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000221}"));
+
+      StructureNode proto(imf);
+      proto.set("int", IntegerNode(imf, -3, -3, -3));
+      proto.set("scaled", ScaledIntegerNode(imf, -3, -3, -3, 0.5, 4.0));
+      proto.set("float", IntegerNode(imf, -3, -3, -3));
+      proto.set("index", IntegerNode(imf, 0, 0, N));
+
+      for (const char* name : {"data", "notConstant", "notConstantScaled"})
+      {
+        VectorNode codecs(imf, true);
+        root.set(name, CompressedVectorNode(imf, proto, codecs));
+      }
+
+      {
+        CompressedVectorNode          cv(root.get("data"));
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "int", ints.data(), N));
+        buffers.push_back(SourceDestBuffer(imf, "scaled", scaled.data(), N, true, true));
+        buffers.push_back(SourceDestBuffer(imf, "float", floats.data(), N, true));
+        buffers.push_back(SourceDestBuffer(imf, "index", index.data(), N));
+        CompressedVectorWriter writer = cv.writer(buffers);
+        writer.write(N);
+        writer.close();
+      }
+
+      /// A different value anywhere fails the write
+      for (const char* name : {"notConstant", "notConstantScaled"})
+      {
+        INFO("cv=" << name);
+        std::vector<int16_t> badInts(ints);
+        std::vector<double>  badScaled(scaled);
+        if (name[11] == 'S')
+          badScaled[700] = 3.0;
+        else
+          badInts[700] = -2;
+
+        CompressedVectorNode          cv(root.get(name));
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "int", badInts.data(), N));
+        buffers.push_back(SourceDestBuffer(imf, "scaled", badScaled.data(), N, true, true));
+        buffers.push_back(SourceDestBuffer(imf, "float", floats.data(), N, true));
+        buffers.push_back(SourceDestBuffer(imf, "index", index.data(), N));
+        CompressedVectorWriter writer = cv.writer(buffers);
+        REQUIRE(e57::test::throwsErrorCode(E57_ERROR_VALUE_OUT_OF_BOUNDS, [&]() { writer.write(N); }));
+      }
+
+      imf.close();
+    }
+
+    {
+      ImageFile            imf(tempFile.c_str(), "r");
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      std::vector<int8_t>           readInts(N);
+      std::vector<double>           readScaled(N);
+      std::vector<int64_t>          readRaw(N);
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", readInts.data(), N));
+      buffers.push_back(SourceDestBuffer(imf, "scaled", readScaled.data(), N, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "float", readRaw.data(), N));
+      buffers.push_back(SourceDestBuffer(imf, "index", index.data(), N));
 
       CompressedVectorReader reader = cv.reader(buffers);
-      REQUIRE_THROWS_AS(reader.seek(0), E57Exception);
+      REQUIRE_EQ(N, reader.read());
+      reader.close();
 
+      std::vector<float>            readFloats(N);
+      std::vector<int64_t>          readScaledRaw(N);
+      std::vector<double>           readDoubles(N);
+      std::vector<SourceDestBuffer> others;
+      others.push_back(SourceDestBuffer(imf, "int", readFloats.data(), N, true));
+      others.push_back(SourceDestBuffer(imf, "scaled", readScaledRaw.data(), N));
+      others.push_back(SourceDestBuffer(imf, "float", readDoubles.data(), N, true));
+      others.push_back(SourceDestBuffer(imf, "index", index.data(), N));
+      reader = cv.reader(others);
+      REQUIRE_EQ(N, reader.read());
       reader.close();
+
+      for (size_t i = 0; i < N; ++i)
+      {
+        INFO("record=" << i);
+        REQUIRE_EQ(-3, readInts[i]);
+        REQUIRE_EQ(2.5, readScaled[i]);
+        REQUIRE_EQ(-3, readRaw[i]);
+        REQUIRE_EQ(-3.0f, readFloats[i]);
+        REQUIRE_EQ(-3, readScaledRaw[i]);
+        REQUIRE_EQ(-3.0, readDoubles[i]);
+      }
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVector seek across packets")
+  {
+    TempFile tempFile;
+
+    /// Enough records for many data packets, with fields that drift apart in the packets at different rates
+    const size_t         N = 100000;
+    std::vector<int64_t> writeInt(N);
+    std::vector<double>  writeScaled(N);
+    std::vector<double>  writeDouble(N);
+    std::vector<ustring> writeString(N);
+    std::vector<int64_t> writeConstant(N, 7);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeInt[i]    = static_cast<int64_t>((i * 7919) % 1000003);
+      writeScaled[i] = static_cast<double>(static_cast<int64_t>(i % 4001) - 2000) * 0.01;
+      writeDouble[i] = static_cast<double>(i) * 0.5;
+      writeString[i] = "point" + std::to_string(i * (i % 5));
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000203}"));
+
+      StructureNode proto(imf);
+      proto.set("int", IntegerNode(imf, 0, 0, 1000002));
+      proto.set("scaled", ScaledIntegerNode(imf, 0, -2000, 2000, 0.01, 0.0));
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+      proto.set("string", StringNode(imf, ""));
+      proto.set("constant", IntegerNode(imf, 7, 7, 7));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", writeInt.data(), N, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "scaled", writeScaled.data(), N, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", writeDouble.data(), N, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &writeString));
+      buffers.push_back(SourceDestBuffer(imf, "constant", writeConstant.data(), N, true, true));
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+
+      imf.close();
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "r");
+      StructureNode root = imf.root();
+
+      CompressedVectorNode cv(root.get("data"));
+
+      const size_t         M = 1000;
+      std::vector<int64_t> readInt(M);
+      std::vector<double>  readScaled(M);
+      std::vector<double>  readDouble(M);
+      std::vector<ustring> readString(M);
+      std::vector<int64_t> readConstant(M);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), M, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "scaled", readScaled.data(), M, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", readDouble.data(), M, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &readString));
+      buffers.push_back(SourceDestBuffer(imf, "constant", readConstant.data(), M, true, true));
+
+      CompressedVectorReader reader = cv.reader(buffers);
+
+      const size_t starts[] = {12345, 99500, 50000, 3, 0, 99999, 77777, 78777, 1, N};
+      for (size_t start : starts)
+      {
+        reader.seek(static_cast<int64_t>(start));
+        unsigned count    = reader.read();
+        size_t   expected = std::min(M, N - start);
+        REQUIRE_EQ(expected, count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+          REQUIRE_EQ(writeInt[start + i], readInt[i]);
+          REQUIRE(std::abs(writeScaled[start + i] - readScaled[i]) < 1e-9);
+          REQUIRE_EQ(writeDouble[start + i], readDouble[i]);
+          REQUIRE_EQ(writeString[start + i], readString[i]);
+          REQUIRE_EQ(7, readConstant[i]);
+        }
+      }
+
+      reader.close();
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVector seek with strings spanning packets")
+  {
+    TempFile tempFile;
+
+    /// Strings longer than a packet, so consecutive index entries share a chunk record number
+    const size_t         N = 40;
+    std::vector<int64_t> writeInt(N);
+    std::vector<ustring> writeString(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeInt[i]    = static_cast<int64_t>(i);
+      writeString[i] = std::string((i % 3 == 0) ? 100000 + i : i, static_cast<char>('a' + i % 26));
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000204}"));
+
+      StructureNode proto(imf);
+      proto.set("int", IntegerNode(imf, 0, 0, 1000));
+      proto.set("string", StringNode(imf, ""));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", writeInt.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &writeString));
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+
+      imf.close();
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "r");
+      StructureNode root = imf.root();
+
+      CompressedVectorNode cv(root.get("data"));
+
+      const size_t         M = 4;
+      std::vector<int64_t> readInt(M);
+      std::vector<ustring> readString(M);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), M, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &readString));
+
+      CompressedVectorReader reader = cv.reader(buffers);
+
+      const size_t starts[] = {30, 1, 3, 37, 0, 22};
+      for (size_t start : starts)
+      {
+        reader.seek(static_cast<int64_t>(start));
+        unsigned count    = reader.read();
+        size_t   expected = std::min(M, N - start);
+        REQUIRE_EQ(expected, count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+          REQUIRE_EQ(writeInt[start + i], readInt[i]);
+          REQUIRE_EQ(writeString[start + i], readString[i]);
+        }
+      }
+
+      reader.close();
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVector strings in a char array")
+  {
+    TempFile tempFile;
+
+    /// Empty, short, long prefix and packet spanning strings, packed in a caller char array
+    const size_t          N = 3000;
+    std::vector<int64_t>  writeInt(N);
+    std::vector<ustring>  expected(N);
+    std::string           writeChars;
+    std::vector<uint64_t> writeOffsets(N + 1);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeInt[i]     = static_cast<int64_t>(i);
+      expected[i]     = std::string((i % 500 == 7) ? 70000 : (i % 7) * 37, static_cast<char>('a' + i % 26));
+      writeOffsets[i] = writeChars.size();
+      writeChars += expected[i];
+    }
+    writeOffsets[N] = writeChars.size();
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000220}"));
+
+      StructureNode proto(imf);
+      proto.set("int", IntegerNode(imf, 0, 0, N));
+      proto.set("string", StringNode(imf, ""));
+
+      for (const char* name : {"data", "badOffsets"})
+      {
+        VectorNode codecs(imf, true);
+        root.set(name, CompressedVectorNode(imf, proto, codecs));
+      }
+
+      {
+        CompressedVectorNode          cv(root.get("data"));
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "int", writeInt.data(), N, true));
+        buffers.push_back(SourceDestBuffer(imf, "string", &writeChars[0], writeChars.size(), writeOffsets.data(), N));
+        CompressedVectorWriter writer = cv.writer(buffers);
+        writer.write(N);
+        writer.close();
+      }
+
+      /// A string that runs past the end of the char array fails the write
+      {
+        std::vector<uint64_t> badOffsets(writeOffsets);
+        badOffsets[1235] = writeChars.size() + 1;
+
+        CompressedVectorNode          cv(root.get("badOffsets"));
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "int", writeInt.data(), N, true));
+        buffers.push_back(SourceDestBuffer(imf, "string", &writeChars[0], writeChars.size(), badOffsets.data(), N));
+        CompressedVectorWriter writer = cv.writer(buffers);
+        REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_BUFFER, [&]() { writer.write(N); }));
+      }
+
+      imf.close();
+    }
+
+    {
+      ImageFile            imf(tempFile.c_str(), "r");
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      /// Read in blocks, each packed from the start of the char array again
+      const size_t          M = 700;
+      std::vector<int64_t>  readInt(M);
+      std::vector<char>     readChars(M * 70000);
+      std::vector<uint64_t> readOffsets(M + 1, E57_UINT64_MAX);
+      {
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), M, true));
+        buffers.push_back(SourceDestBuffer(imf, "string", readChars.data(), readChars.size(), readOffsets.data(), M));
+        CompressedVectorReader reader = cv.reader(buffers);
+
+        size_t   total = 0;
+        unsigned count = 0;
+        while ((count = reader.read()) > 0)
+        {
+          REQUIRE_EQ(0U, readOffsets[0]);
+          for (size_t i = 0; i < count; ++i)
+          {
+            INFO("record=" << total + i);
+            REQUIRE_EQ(writeInt[total + i], readInt[i]);
+            REQUIRE_EQ(expected[total + i], std::string(readChars.data() + readOffsets[i], readOffsets[i + 1] - readOffsets[i]));
+          }
+          total += count;
+        }
+        REQUIRE_EQ(N, total);
+
+        /// Seeking skips the strings before the record without storing them
+        reader.seek(1234);
+        REQUIRE_EQ(M, reader.read());
+        for (size_t i = 0; i < M; ++i)
+          REQUIRE_EQ(expected[1234 + i], std::string(readChars.data() + readOffsets[i], readOffsets[i + 1] - readOffsets[i]));
+        reader.close();
+      }
+
+      /// A full char array stops the read short, and the next read resumes with the string that didn't fit
+      {
+        std::vector<char>             smallChars(1000);
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), M, true));
+        buffers.push_back(SourceDestBuffer(imf, "string", smallChars.data(), smallChars.size(), readOffsets.data(), M));
+        CompressedVectorReader reader = cv.reader(buffers);
+
+        size_t total       = 0;
+        size_t longStrings = 0;
+        while (total < N)
+        {
+          INFO("total=" << total);
+          const char* chars = smallChars.data();
+          unsigned    count = 0;
+          try
+          {
+            count = reader.read();
+          }
+          catch (const E57Exception& ex)
+          {
+            /// Only a string longer than the whole array fails the read, and a larger array picks up from it
+            REQUIRE_EQ(E57_ERROR_BAD_BUFFER, ex.errorCode());
+            REQUIRE(expected[total].size() > smallChars.size());
+            buffers[1].rebase(readChars.data(), readChars.size(), readOffsets.data(), M);
+            chars = readChars.data();
+            count = reader.read();
+            ++longStrings;
+          }
+          REQUIRE(count > 0);
+          for (size_t i = 0; i < count; ++i)
+          {
+            INFO("record=" << total + i);
+            REQUIRE_EQ(writeInt[total + i], readInt[i]);
+            REQUIRE_EQ(expected[total + i], std::string(chars + readOffsets[i], readOffsets[i + 1] - readOffsets[i]));
+          }
+          total += count;
+
+          /// A short read means the next string didn't fit behind the ones read
+          if (chars == smallChars.data() && count < M && total < N)
+            REQUIRE(readOffsets[count] + expected[total].size() > smallChars.size());
+          if (chars != smallChars.data())
+            buffers[1].rebase(smallChars.data(), smallChars.size(), readOffsets.data(), M);
+        }
+        REQUIRE_EQ(N, total);
+        REQUIRE_EQ(0U, reader.read());
+        REQUIRE(longStrings > 0);
+        reader.close();
+      }
+
+      /// Ranges read in parallel are packed in record order
+      {
+        std::vector<int64_t>          allInt(N);
+        std::vector<char>             allChars(writeChars.size());
+        std::vector<uint64_t>         allOffsets(N + 1);
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "int", allInt.data(), N, true));
+        buffers.push_back(SourceDestBuffer(imf, "string", allChars.data(), allChars.size(), allOffsets.data(), N));
+        cv.readParallel(buffers, 0, N, 3);
+        REQUIRE(writeOffsets == allOffsets);
+        REQUIRE(std::equal(allChars.begin(), allChars.end(), writeChars.begin()));
+        REQUIRE(writeInt == allInt);
+      }
+
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVector string columns in char arrays that fill up at different records")
+  {
+    TempFile tempFile;
+
+    /// Labels and GUIDs of different lengths, so each column's char array fills up at its own records
+    const size_t N          = 40000;
+    auto         labelAt    = [](size_t i) { return std::string(1 + (i * 7919) % 23, static_cast<char>('a' + i % 26)); };
+    auto         guidAt     = [](size_t i) { return "{" + std::to_string(i * 2654435761U) + "}"; };
+    const size_t labelChars = 4000;
+    const size_t guidChars  = 3000;
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000227}"));
+
+      StructureNode proto(imf);
+      proto.set("index", IntegerNode(imf, 0, 0, N));
+      proto.set("label", StringNode(imf, ""));
+      proto.set("guid", StringNode(imf, ""));
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<int32_t> index(N);
+      std::vector<ustring> labels(N);
+      std::vector<ustring> guids(N);
+      for (size_t i = 0; i < N; ++i)
+      {
+        index[i]  = static_cast<int32_t>(i);
+        labels[i] = labelAt(i);
+        guids[i]  = guidAt(i);
+      }
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "index", index.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "label", &labels));
+      buffers.push_back(SourceDestBuffer(imf, "guid", &guids));
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+      imf.close();
+    }
+
+    ImageFile            imf(tempFile.c_str(), "r");
+    CompressedVectorNode cv(imf.root().get("data"));
+
+    /// Read everything with arrays large enough for the whole vector, and with small ones, counting the packets read from the file
+    auto readAll = [&](size_t capacity, size_t labelCapacity, size_t guidCapacity, size_t& reads) {
+      std::vector<int32_t>          index(capacity);
+      std::vector<char>             labelArray(labelCapacity);
+      std::vector<uint64_t>         labelOffsets(capacity + 1);
+      std::vector<char>             guidArray(guidCapacity);
+      std::vector<uint64_t>         guidOffsets(capacity + 1);
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "index", index.data(), capacity, true));
+      buffers.push_back(SourceDestBuffer(imf, "label", labelArray.data(), labelArray.size(), labelOffsets.data(), capacity));
+      buffers.push_back(SourceDestBuffer(imf, "guid", guidArray.data(), guidArray.size(), guidOffsets.data(), capacity));
+      CompressedVectorReader reader = cv.reader(buffers);
+
+      size_t   total = 0;
+      unsigned count = 0;
+      reads          = 0;
+      while ((count = reader.read()) > 0)
+      {
+        for (size_t i = 0; i < count; ++i)
+        {
+          INFO("record=" << total + i);
+          REQUIRE_EQ(static_cast<int32_t>(total + i), index[i]);
+          REQUIRE_EQ(labelAt(total + i), std::string(labelArray.data() + labelOffsets[i], labelOffsets[i + 1] - labelOffsets[i]));
+          REQUIRE_EQ(guidAt(total + i), std::string(guidArray.data() + guidOffsets[i], guidOffsets[i + 1] - guidOffsets[i]));
+        }
+        total += count;
+        reads++;
+      }
+      REQUIRE_EQ(N, total);
+
+      uint64_t missCount = reader.cacheMissCount();
+      reader.close();
+      return (missCount);
+    };
+
+    size_t   wholeReads  = 0;
+    size_t   shortReads  = 0;
+    uint64_t wholeMisses = readAll(N, N * 24, N * 24, wholeReads);
+    uint64_t shortMisses = readAll(1000, labelChars, guidChars, shortReads);
+    CHECK_EQ(1U, wholeReads);
+    CHECK(shortReads > N / 1000);
+
+    /// Channels sent back to the record another column stopped at resume from where they stored it, rather than decoding from the first record again
+    INFO("wholeMisses=" << wholeMisses << " shortMisses=" << shortMisses << " shortReads=" << shortReads);
+    CHECK(shortMisses <= 2 * wholeMisses);
+
+    imf.close();
+  }
+
+  TEST_CASE("CompressedVector string lengths past the end of the section fail the read")
+  {
+    TempFile          tempFile;
+    const std::string value(200, 'Q');
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000226}"));
+
+      StructureNode proto(imf);
+      proto.set("string", StringNode(imf, ""));
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<ustring>          strings(1, value);
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "string", &strings));
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(1);
+      writer.close();
+      imf.close();
+    }
+
+    /// Replace the long length prefix of the string, which holds the length shifted left by one with the low bit set, by one of 2^62 bytes
+    {
+      CheckedFile       cf(tempFile.string(), CheckedFile::writeExisting);
+      std::vector<char> bytes(static_cast<size_t>(cf.length(CheckedFile::logical)));
+      cf.read(bytes.data(), bytes.size());
+
+      std::string prefix(8, '\0');
+      uint64_t    field = (static_cast<uint64_t>(value.size()) << 1) | 1;
+      for (size_t i = 0; i < 8; ++i)
+        prefix[i] = static_cast<char>(field >> (8 * i));
+      const std::string needle = prefix + value.substr(0, 16);
+      auto              found  = std::search(bytes.begin(), bytes.end(), needle.begin(), needle.end());
+      REQUIRE(found != bytes.end());
+
+      field = (static_cast<uint64_t>(1) << 63) | 1;
+      for (size_t i = 0; i < 8; ++i)
+        prefix[i] = static_cast<char>(field >> (8 * i));
+      cf.seek(static_cast<uint64_t>(found - bytes.begin()));
+      cf.write(prefix.data(), prefix.size());
+      cf.close();
+    }
+
+    /// The length is checked before any string is allocated for it
+    ImageFile                     imf(tempFile.c_str(), "r");
+    CompressedVectorNode          cv(imf.root().get("data"));
+    std::vector<ustring>          strings(1);
+    std::vector<SourceDestBuffer> buffers;
+    buffers.push_back(SourceDestBuffer(imf, "string", &strings));
+    CompressedVectorReader reader = cv.reader(buffers);
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_CV_PACKET, [&]() { reader.read(); }));
+    reader.close();
+    imf.close();
+  }
+
+  TEST_CASE("SourceDestBuffer rebase between transfers")
+  {
+    TempFile tempFile;
+
+    /// Stream through rings of batch arrays, rebasing the bound buffers instead of binding new ones
+    const size_t B = 1000;
+    const size_t R = 3;
+    const size_t N = 10 * B + 123;
+
+    auto expectedValue  = [](size_t i) { return static_cast<double>(i) * 0.25 - 50.0; };
+    auto expectedString = [](size_t i) { return std::string(i % 11, static_cast<char>('a' + i % 26)); };
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000222}"));
+
+      StructureNode proto(imf);
+      proto.set("index", IntegerNode(imf, 0, 0, N));
+      proto.set("value", FloatNode(imf, 0.0, E57_DOUBLE));
+      proto.set("string", StringNode(imf, ""));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<int32_t> ringIndex[R];
+      std::vector<double>  ringValue[R];
+      std::vector<ustring> ringString[R];
+      for (size_t r = 0; r < R; ++r)
+      {
+        ringIndex[r].resize(B);
+        ringValue[r].resize(B);
+        ringString[r].resize(B);
+      }
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "index", ringIndex[0].data(), B));
+      buffers.push_back(SourceDestBuffer(imf, "value", ringValue[0].data(), B));
+      buffers.push_back(SourceDestBuffer(imf, "string", &ringString[0]));
+      CompressedVectorWriter writer = cv.writer(buffers);
+
+      /// Only the first half is rebased, the second half binds new buffers over the ring arrays, which must reach the encoders too
+      for (size_t first = 0, batch = 0; first < N; first += B, ++batch)
+      {
+        const size_t r     = batch % R;
+        const size_t count = std::min(B, N - first);
+        for (size_t i = 0; i < count; ++i)
+        {
+          ringIndex[r][i]  = static_cast<int32_t>(first + i);
+          ringValue[r][i]  = expectedValue(first + i);
+          ringString[r][i] = expectedString(first + i);
+        }
+
+        if (first < N / 2)
+        {
+          buffers[0].rebase(ringIndex[r].data(), B);
+          buffers[1].rebase(ringValue[r].data(), B);
+          buffers[2].rebase(&ringString[r]);
+          writer.write(count);
+        }
+        else
+        {
+          std::vector<SourceDestBuffer> rebound;
+          rebound.push_back(SourceDestBuffer(imf, "index", ringIndex[r].data(), B));
+          rebound.push_back(SourceDestBuffer(imf, "value", ringValue[r].data(), B));
+          rebound.push_back(SourceDestBuffer(imf, "string", &ringString[r]));
+          buffers = rebound;
+          writer.write(buffers, count);
+        }
+      }
+
+      /// The representation can't change, and a write can't be larger than any of the buffers
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BUFFERS_NOT_COMPATIBLE, [&]() { buffers[0].rebase(ringValue[0].data(), B); }));
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_BUFFER, [&]() { buffers[0].rebase(static_cast<int32_t*>(nullptr), B); }));
+      buffers[1].rebase(ringValue[0].data(), B / 2);
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_API_ARGUMENT, [&]() { writer.write(B); }));
+
+      writer.close();
+      REQUIRE_EQ(static_cast<int64_t>(N), cv.childCount());
+      imf.close();
+    }
+
+    {
+      ImageFile            imf(tempFile.c_str(), "r");
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      std::vector<int64_t>  ringIndex[R];
+      std::vector<float>    ringValue[R];
+      std::vector<char>     ringChars[R];
+      std::vector<uint64_t> ringOffsets[R];
+      for (size_t r = 0; r < R; ++r)
+      {
+        ringIndex[r].resize(B);
+        ringValue[r].resize(B);
+        ringChars[r].resize(B * 10);
+        ringOffsets[r].resize(B + 1);
+      }
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "index", ringIndex[0].data(), B));
+      buffers.push_back(SourceDestBuffer(imf, "value", ringValue[0].data(), B));
+      buffers.push_back(SourceDestBuffer(imf, "string", ringChars[0].data(), ringChars[0].size(), ringOffsets[0].data(), B));
+      CompressedVectorReader reader = cv.reader(buffers);
+
+      size_t total = 0;
+      for (size_t batch = 0;; ++batch)
+      {
+        const size_t r = batch % R;
+        buffers[0].rebase(ringIndex[r].data(), B);
+        buffers[1].rebase(ringValue[r].data(), B);
+        buffers[2].rebase(ringChars[r].data(), ringChars[r].size(), ringOffsets[r].data(), B);
+
+        unsigned count = reader.read();
+        if (count == 0)
+          break;
+        for (size_t i = 0; i < count; ++i)
+        {
+          INFO("record=" << total + i);
+          REQUIRE_EQ(static_cast<int64_t>(total + i), ringIndex[r][i]);
+          REQUIRE_EQ(static_cast<float>(expectedValue(total + i)), ringValue[r][i]);
+          REQUIRE_EQ(expectedString(total + i), std::string(ringChars[r].data() + ringOffsets[r][i], ringOffsets[r][i + 1] - ringOffsets[r][i]));
+        }
+        total += count;
+      }
+      REQUIRE_EQ(N, total);
+
+      /// A vector of strings can't replace a char array, and every buffer of a read must hold the same number of records
+      std::vector<ustring> strings(B);
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BUFFERS_NOT_COMPATIBLE, [&]() { buffers[2].rebase(&strings); }));
+      buffers[0].rebase(ringIndex[0].data(), B / 2);
+      reader.seek(0);
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BUFFER_SIZE_MISMATCH, [&]() { reader.read(); }));
+
+      /// Smaller batches are fine once they all agree
+      buffers[1].rebase(ringValue[0].data(), B / 2);
+      buffers[2].rebase(ringChars[0].data(), ringChars[0].size(), ringOffsets[0].data(), B / 2);
+      REQUIRE_EQ(B / 2, reader.read());
+      REQUIRE_EQ(static_cast<int64_t>(B / 2 - 1), ringIndex[0][B / 2 - 1]);
+
+      reader.close();
+      imf.close();
+    }
+  }
+
+  TEST_CASE("SourceDestBufferLayout transfers arrays of structs")
+  {
+    TempFile tempFile;
+
+    struct Point
+    {
+      double  x, y, z;
+      float   intensity;
+      uint8_t red, green, blue;
+    };
+
+    SourceDestBufferLayout layout(sizeof(Point));
+    layout.add("cartesianX", offsetof(Point, x), E57_REAL64, true, true);
+    layout.add("cartesianY", offsetof(Point, y), E57_REAL64, true, true);
+    layout.add("cartesianZ", offsetof(Point, z), E57_REAL64, true, true);
+    layout.add("intensity", offsetof(Point, intensity), E57_REAL32);
+    layout.add("colorRed", offsetof(Point, red), E57_UINT8);
+    layout.add("colorGreen", offsetof(Point, green), E57_UINT8);
+    layout.add("colorBlue", offsetof(Point, blue), E57_UINT8);
+    REQUIRE_EQ(sizeof(Point), layout.structSize());
+    REQUIRE_EQ(7U, layout.fieldCount());
+
+    /// Members must lie inside the struct, and can't be strings
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_API_ARGUMENT, [&]() { layout.add("x", sizeof(Point) - 4, E57_REAL64); }));
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_API_ARGUMENT, [&]() { layout.add("x", 0, E57_USTRING); }));
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_API_ARGUMENT, [&]() { SourceDestBufferLayout(0); }));
+    REQUIRE_EQ(7U, layout.fieldCount());
+
+    const size_t       N = 5000;
+    const size_t       B = 1024;
+    std::vector<Point> expected(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+      expected[i].x         = static_cast<double>(i) * 0.0137 - 30.0;
+      expected[i].y         = static_cast<double>(i % 97) * -0.5;
+      expected[i].z         = 1.0 + static_cast<double>(i) * 1e-3;
+      expected[i].intensity = static_cast<float>(i % 1000) / 1000.0f;
+      expected[i].red       = static_cast<uint8_t>(i);
+      expected[i].green     = static_cast<uint8_t>(i * 3);
+      expected[i].blue      = static_cast<uint8_t>(i * 7);
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000223}"));
+
+      StructureNode proto(imf);
+      proto.set("cartesianX", ScaledIntegerNode(imf, 0, -1000000, 1000000, 0.001, 0.0));
+      proto.set("cartesianY", ScaledIntegerNode(imf, 0, -1000000, 1000000, 0.001, 0.0));
+      proto.set("cartesianZ", ScaledIntegerNode(imf, 0, -1000000, 1000000, 0.001, 0.0));
+      proto.set("intensity", FloatNode(imf, 0.0, E57_SINGLE));
+      proto.set("colorRed", IntegerNode(imf, 0, 0, 255));
+      proto.set("colorGreen", IntegerNode(imf, 0, 0, 255));
+      proto.set("colorBlue", IntegerNode(imf, 0, 0, 255));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("points", cv);
+
+      /// Alternate between two batches of structs
+      std::vector<Point>            batches[2] = {std::vector<Point>(B), std::vector<Point>(B)};
+      std::vector<SourceDestBuffer> buffers    = layout.bind(imf, batches[0].data(), B);
+      CompressedVectorWriter        writer     = cv.writer(buffers);
+      for (size_t first = 0, k = 0; first < N; first += B, k ^= 1)
+      {
+        const size_t count = std::min(B, N - first);
+        std::copy(expected.begin() + first, expected.begin() + first + count, batches[k].begin());
+        layout.rebase(buffers, batches[k].data(), B);
+        writer.write(count);
+      }
+      writer.close();
+
+      /// Only buffers bound with the same layout can be rebased
+      std::vector<SourceDestBuffer> others(buffers.begin(), buffers.begin() + 3);
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BUFFERS_NOT_COMPATIBLE, [&]() { layout.rebase(others, batches[0].data(), B); }));
+      SourceDestBufferLayout empty(sizeof(Point));
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_API_ARGUMENT, [&]() { empty.bind(imf, batches[0].data(), B); }));
+
+      imf.close();
+    }
+
+    {
+      ImageFile            imf(tempFile.c_str(), "r");
+      CompressedVectorNode cv(imf.root().get("points"));
+
+      std::vector<Point>            points(N);
+      std::vector<int64_t>          rawX(N);
+      std::vector<SourceDestBuffer> buffers = layout.bind(imf, points.data(), N);
+      CompressedVectorReader        reader  = cv.reader(buffers);
+      REQUIRE_EQ(N, reader.read());
+      reader.close();
+
+      std::vector<SourceDestBuffer> raw;
+      raw.push_back(SourceDestBuffer(imf, "cartesianX", rawX.data(), N));
+      reader = cv.reader(raw);
+      REQUIRE_EQ(N, reader.read());
+      reader.close();
+
+      for (size_t i = 0; i < N; ++i)
+      {
+        INFO("record=" << i);
+        REQUIRE_EQ(static_cast<int64_t>(std::floor(expected[i].x / 0.001 + 0.5)), rawX[i]);
+        REQUIRE(std::fabs(expected[i].x - points[i].x) <= 0.0005 + 1e-9);
+        REQUIRE(std::fabs(expected[i].y - points[i].y) <= 0.0005 + 1e-9);
+        REQUIRE(std::fabs(expected[i].z - points[i].z) <= 0.0005 + 1e-9);
+        REQUIRE_EQ(expected[i].intensity, points[i].intensity);
+        REQUIRE_EQ(expected[i].red, points[i].red);
+        REQUIRE_EQ(expected[i].green, points[i].green);
+        REQUIRE_EQ(expected[i].blue, points[i].blue);
+      }
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVectorReader packet cache sizing")
+  {
+    TempFile tempFile;
+
+    /// Many fields of very different widths, so the bytestreams drift apart across packets
+    const size_t         N      = 200000;
+    const unsigned       FIELDS = 12;
+    std::vector<int64_t> writeData(N);
+    for (size_t i = 0; i < N; ++i)
+      writeData[i] = static_cast<int64_t>((i * 2654435761u) % 1000000);
+
+    auto fieldName = [](unsigned f) { return "f" + std::to_string(f); };
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000205}"));
+
+      StructureNode proto(imf);
+      for (unsigned f = 0; f < FIELDS; ++f)
+      {
+        if (f % 3 == 0)
+          proto.set(fieldName(f), FloatNode(imf, 0.0, E57_DOUBLE));
+        else
+          proto.set(fieldName(f), IntegerNode(imf, 0, 0, (f % 3 == 1) ? 1 : 999999));
+      }
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<std::vector<double>>  floats(FIELDS);
+      std::vector<std::vector<int64_t>> ints(FIELDS);
+      std::vector<SourceDestBuffer>     buffers;
+      for (unsigned f = 0; f < FIELDS; ++f)
+      {
+        if (f % 3 == 0)
+        {
+          floats[f].assign(writeData.begin(), writeData.end());
+          buffers.push_back(SourceDestBuffer(imf, fieldName(f), floats[f].data(), N, true));
+        }
+        else
+        {
+          ints[f].resize(N);
+          for (size_t i = 0; i < N; ++i)
+            ints[f][i] = (f % 3 == 1) ? writeData[i] & 1 : writeData[i];
+          buffers.push_back(SourceDestBuffer(imf, fieldName(f), ints[f].data(), N, true));
+        }
+      }
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+
+      imf.close();
+    }
+
+    ImageFile            imf(tempFile.c_str(), "r");
+    StructureNode        root = imf.root();
+    CompressedVectorNode cv(root.get("data"));
+
+    const size_t                      M = 3000;
+    std::vector<std::vector<int64_t>> readData(FIELDS, std::vector<int64_t>(M));
+    std::vector<SourceDestBuffer>     buffers;
+    for (unsigned f = 0; f < FIELDS; ++f)
+      buffers.push_back(SourceDestBuffer(imf, fieldName(f), readData[f].data(), M, true));
+
+    /// Read whole vector with given cache size, return number of packets read from file
+    auto readAll = [&](unsigned cachePacketCount, unsigned& finalPacketCount) {
+      CompressedVectorReader reader = cv.reader(buffers, cachePacketCount);
+      if (cachePacketCount != 0)
+        REQUIRE_EQ(cachePacketCount, reader.cachePacketCount());
+
+      size_t   total = 0;
+      unsigned count;
+      while ((count = reader.read()) > 0)
+      {
+        for (unsigned f = 0; f < FIELDS; ++f)
+        {
+          for (unsigned i = 0; i < count; ++i)
+          {
+            int64_t expected = (f % 3 == 1) ? writeData[total + i] & 1 : writeData[total + i];
+            REQUIRE_EQ(expected, readData[f][i]);
+          }
+        }
+        total += count;
+      }
+      REQUIRE_EQ(N, total);
+
+      finalPacketCount     = reader.cachePacketCount();
+      uint64_t missCount   = reader.cacheMissCount();
+      uint64_t accessCount = reader.cacheHitCount() + missCount;
+      CHECK(accessCount > missCount);
+      reader.close();
+      return missCount;
+    };
+
+    unsigned packetCount;
+    uint64_t singleMisses = readAll(1, packetCount);
+    uint64_t largeMisses  = readAll(64, packetCount);
+    uint64_t autoMisses   = readAll(0, packetCount);
+
+    /// A large cache reads each packet once, the automatically sized cache should do the same with fewer buffers
+    CHECK(largeMisses < singleMisses);
+    CHECK_EQ(largeMisses, autoMisses);
+    CHECK(packetCount <= FIELDS + 1);
+
+    imf.close();
+  }
+
+  TEST_CASE("CompressedVectorReader with read-ahead")
+  {
+    TempFile tempFile;
+
+    const size_t         N = 150000;
+    std::vector<int64_t> writeInt(N);
+    std::vector<double>  writeDouble(N);
+    std::vector<ustring> writeString(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeInt[i]    = static_cast<int64_t>((i * 7919) % 1000003);
+      writeDouble[i] = static_cast<double>(i) * 0.25;
+      writeString[i] = (i % 7 == 0) ? "s" + std::to_string(i) : "";
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000206}"));
+
+      StructureNode proto(imf);
+      proto.set("int", IntegerNode(imf, 0, 0, 1000002));
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+      proto.set("string", StringNode(imf, ""));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", writeInt.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", writeDouble.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &writeString));
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+
+      imf.close();
+    }
+
+    /// Read whole vector, seeking back once half way, return number of packets read by the decoding thread
+    auto readAll = [&](const char* configuration, unsigned cachePacketCount) {
+      ImageFile            imf(tempFile.c_str(), "r", configuration);
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      const size_t         M = 1111;
+      std::vector<int64_t> readInt(M);
+      std::vector<double>  readDouble(M);
+      std::vector<ustring> readString(M);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), M, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", readDouble.data(), M, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &readString));
+
+      CompressedVectorReader reader = cv.reader(buffers, cachePacketCount);
+
+      size_t   next = 0;
+      bool     seeked = false;
+      unsigned count;
+      while ((count = reader.read()) > 0)
+      {
+        for (unsigned i = 0; i < count; ++i)
+        {
+          REQUIRE_EQ(writeInt[next + i], readInt[i]);
+          REQUIRE_EQ(writeDouble[next + i], readDouble[i]);
+          REQUIRE_EQ(writeString[next + i], readString[i]);
+        }
+        next += count;
+        if (!seeked && next > N / 2)
+        {
+          next = N / 3;
+          reader.seek(static_cast<int64_t>(next));
+          seeked = true;
+        }
+      }
+      REQUIRE_EQ(N, next);
+
+      uint64_t missCount = reader.cacheMissCount();
+      reader.close();
+      imf.close();
+      return missCount;
+    };
+
+    uint64_t plainMisses = readAll("", 0);
+    CHECK(readAll("prefetch=4", 0) <= plainMisses);
+    CHECK(readAll("mmap prefetch=8", 0) <= plainMisses);
+
+    /// Tiny caches leave the worker little room, but must still read correctly
+    readAll("prefetch=4", 1);
+    readAll("prefetch=2", 2);
+  }
+
+  TEST_CASE("CompressedVectorReader reads ahead between read calls")
+  {
+    TempFile tempFile;
+
+    /// One channel, so every data packet is needed exactly once, in order
+    const size_t        N = 100000;
+    std::vector<double> writeDouble(N);
+    for (size_t i = 0; i < N; ++i)
+      writeDouble[i] = static_cast<double>(i) * 0.25;
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000224}"));
+
+      StructureNode proto(imf);
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "double", writeDouble.data(), N));
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+      imf.close();
+    }
+
+    /// Read in calls much smaller than a packet, pausing between them like a caller using the records.
+    /// Return the number of packets the calls had to read themselves.
+    auto readAll = [&](const char* configuration) {
+      ImageFile            imf(tempFile.c_str(), "r", configuration);
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      const size_t        M = 500;
+      std::vector<double> readDouble(M);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "double", readDouble.data(), M));
+      CompressedVectorReader reader = cv.reader(buffers);
+
+      size_t   next = 0;
+      unsigned count;
+      while ((count = reader.read()) > 0)
+      {
+        for (unsigned i = 0; i < count; ++i)
+          REQUIRE_EQ(writeDouble[next + i], readDouble[i]);
+        next += count;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      REQUIRE_EQ(N, next);
+
+      uint64_t missCount = reader.cacheMissCount();
+      reader.close();
+      imf.close();
+      return missCount;
+    };
+
+    /// Without read-ahead every packet is a miss, with it only the first one the reader is opened on
+    uint64_t plainMisses = readAll("");
+    REQUIRE(plainMisses > 4);
+    CHECK_EQ(1U, readAll("prefetch=2"));
+
+    /// An ImageFile closed with the reader still open stops the worker first
+    {
+      ImageFile            imf(tempFile.c_str(), "r", "prefetch=8");
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      std::vector<double>           readDouble(100);
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "double", readDouble.data(), readDouble.size()));
+      CompressedVectorReader reader = cv.reader(buffers);
+      REQUIRE_EQ(100U, reader.read());
+      imf.close();
+    }
+  }
+
+  TEST_CASE("CompressedVectorReader with decoder threads")
+  {
+    TempFile tempFile;
+
+    /// Fields of very different sizes, so the channels drift apart across the packets
+    const size_t         N = 200000;
+    std::vector<int64_t> writeSmall(N);
+    std::vector<int64_t> writeInt(N);
+    std::vector<double>  writeDouble(N);
+    std::vector<float>   writeFloat(N);
+    std::vector<ustring> writeString(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeSmall[i]  = static_cast<int64_t>(i % 3);
+      writeInt[i]    = static_cast<int64_t>((i * 7919) % 1000003);
+      writeDouble[i] = static_cast<double>(i) * 0.25;
+      writeFloat[i]  = static_cast<float>(i) * 0.5f;
+      writeString[i] = (i % 11 == 0) ? std::string(i % 300, static_cast<char>('a' + i % 26)) : "";
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000215}"));
+
+      StructureNode proto(imf);
+      proto.set("small", IntegerNode(imf, 0, 0, 2));
+      proto.set("int", IntegerNode(imf, 0, 0, 1000002));
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+      proto.set("float", FloatNode(imf, 0.0, E57_SINGLE));
+      proto.set("string", StringNode(imf, ""));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "small", writeSmall.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "int", writeInt.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", writeDouble.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "float", writeFloat.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &writeString));
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+
+      imf.close();
+    }
+
+    /// Read whole vector in chunks, seeking back once half way
+    auto readAll = [&](const char* configuration, unsigned cachePacketCount) {
+      ImageFile            imf(tempFile.c_str(), "r", configuration);
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      const size_t         M = 4321;
+      std::vector<int64_t> readSmall(M);
+      std::vector<int64_t> readInt(M);
+      std::vector<double>  readDouble(M);
+      std::vector<float>   readFloat(M);
+      std::vector<ustring> readString(M);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "small", readSmall.data(), M, true));
+      buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), M, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", readDouble.data(), M, true));
+      buffers.push_back(SourceDestBuffer(imf, "float", readFloat.data(), M, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &readString));
+
+      CompressedVectorReader reader = cv.reader(buffers, cachePacketCount);
+
+      size_t   next   = 0;
+      bool     seeked = false;
+      unsigned count;
+      while ((count = reader.read()) > 0)
+      {
+        for (unsigned i = 0; i < count; ++i)
+        {
+          REQUIRE_EQ(writeSmall[next + i], readSmall[i]);
+          REQUIRE_EQ(writeInt[next + i], readInt[i]);
+          REQUIRE_EQ(writeDouble[next + i], readDouble[i]);
+          REQUIRE_EQ(writeFloat[next + i], readFloat[i]);
+          REQUIRE_EQ(writeString[next + i], readString[i]);
+        }
+        next += count;
+        if (!seeked && next > N / 2)
+        {
+          next = N / 5;
+          reader.seek(static_cast<int64_t>(next));
+          seeked = true;
+        }
+      }
+      REQUIRE_EQ(N, next);
+
+      reader.close();
+      imf.close();
+    };
+
+    readAll("", 0);
+    readAll("decoders=4", 0);
+    readAll("decoders=64 prefetch=4", 0);
+    readAll("decoders=2 mmap", 0);
+
+    /// Small caches shrink the window down to a single packet, or leave no room for one at all
+    readAll("decoders=4", 1);
+    readAll("decoders=4", 2);
+    readAll("decoders=4", 3);
+    readAll("decoders=4 prefetch=2", 4);
+  }
+
+  TEST_CASE("CompressedVectorNode readParallel")
+  {
+    TempFile tempFile;
+
+    const size_t         N = 250000;
+    std::vector<int64_t> writeInt(N);
+    std::vector<double>  writeDouble(N);
+    std::vector<ustring> writeString(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeInt[i]    = static_cast<int64_t>((i * 7919) % 1000003);
+      writeDouble[i] = static_cast<double>(i) * 0.125;
+      writeString[i] = (i % 13 == 0) ? std::string(i % 200, static_cast<char>('a' + i % 26)) : "";
+    }
+
+    /// Some strings longer than a packet, so string prefixes and ranges start in the middle of them
+    for (size_t i = 7; i < N; i += 31250)
+      writeString[i] = std::string(100000 + i % 1000, static_cast<char>('A' + i % 26));
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000216}"));
+
+      StructureNode proto(imf);
+      proto.set("int", IntegerNode(imf, 0, 0, 1000002));
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+      proto.set("string", StringNode(imf, ""));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", writeInt.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", writeDouble.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &writeString));
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+
+      /// A file being written can't be read from several threads, so the ranges are read one after another
+      std::vector<int64_t>          readInt(N);
+      std::vector<ustring>          readString(N);
+      std::vector<SourceDestBuffer> readBuffers;
+      readBuffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), N, true));
+      readBuffers.push_back(SourceDestBuffer(imf, "string", &readString));
+      cv.readParallel(readBuffers, 0, N, 3);
+      REQUIRE(readInt == writeInt);
+      REQUIRE(readString == writeString);
+
+      /// Nor can it have more than one reader open
+      {
+        CompressedVectorReader reader = cv.reader(readBuffers);
+        REQUIRE(e57::test::throwsErrorCode(E57_ERROR_TOO_MANY_READERS, [&]() { cv.readParallel(readBuffers, 0, 10, 2); }));
+        REQUIRE(e57::test::throwsErrorCode(E57_ERROR_TOO_MANY_READERS, [&]() { cv.reader(readBuffers); }));
+        reader.close();
+      }
+
+      imf.close();
+    }
+
+    /// Integers and doubles interleaved in one array, so the slices must keep the stride
+    struct Point
+    {
+      double  value;
+      int32_t index;
+    };
+
+    auto readRecords = [&](const char* configuration, size_t first, size_t count, unsigned rangeCount) {
+      ImageFile            imf(tempFile.c_str(), "r", configuration);
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      std::vector<Point>   points(count + 3);
+      std::vector<ustring> strings(count + 3, "unset");
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", &points[0].index, points.size(), true, false, sizeof(Point)));
+      buffers.push_back(SourceDestBuffer(imf, "double", &points[0].value, points.size(), true, false, sizeof(Point)));
+      buffers.push_back(SourceDestBuffer(imf, "string", &strings));
+
+      cv.readParallel(buffers, static_cast<int64_t>(first), static_cast<int64_t>(count), rangeCount);
+      for (size_t i = 0; i < count; ++i)
+      {
+        REQUIRE_EQ(writeInt[first + i], static_cast<int64_t>(points[i].index));
+        REQUIRE_EQ(writeDouble[first + i], points[i].value);
+        REQUIRE_EQ(writeString[first + i], strings[i]);
+      }
+
+      /// Elements past the records read are left alone
+      ustring unset = "unset";
+      REQUIRE_EQ(unset, strings[count]);
+
+      /// The ImageFile can be read as usual afterwards
+      REQUIRE_EQ(0, imf.readerCount());
+      imf.close();
+    };
+
+    readRecords("", 0, N, 0);
+    readRecords("", 0, N, 1);
+    readRecords("", 0, N, 7);
+    readRecords("", 12345, 100000, 4);
+    readRecords("", N - 5, 5, 64);
+    readRecords("", 77, 0, 3);
+    readRecords("decoders=2 prefetch=2", 1, N - 1, 5);
+    readRecords("mmap", 0, N, 3);
+
+    ImageFile            imf(tempFile.c_str(), "r");
+    CompressedVectorNode cv(imf.root().get("data"));
+
+    std::vector<int64_t>          readInt(1000);
+    std::vector<SourceDestBuffer> buffers;
+    buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), readInt.size(), true));
+
+    /// Records must exist and fit in the buffers
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_API_ARGUMENT, [&]() { cv.readParallel(buffers, 0, 1001, 2); }));
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_API_ARGUMENT, [&]() { cv.readParallel(buffers, static_cast<int64_t>(N) - 10, 11, 2); }));
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_API_ARGUMENT, [&]() { cv.readParallel(buffers, -1, 10, 2); }));
+
+    /// A read only file can have other readers open meanwhile, which carry on where they were
+    {
+      std::vector<int64_t>          serialInt(500);
+      std::vector<SourceDestBuffer> serialBuffers;
+      serialBuffers.push_back(SourceDestBuffer(imf, "int", serialInt.data(), serialInt.size(), true));
+
+      CompressedVectorReader reader = cv.reader(serialBuffers);
+      REQUIRE_EQ(500u, reader.read());
+      cv.readParallel(buffers, 0, 1000, 2);
+      REQUIRE_EQ(1, imf.readerCount());
+      REQUIRE_EQ(500u, reader.read());
+      for (size_t i = 0; i < serialInt.size(); ++i)
+        REQUIRE_EQ(writeInt[500 + i], serialInt[i]);
+      reader.close();
+    }
+    for (size_t i = 0; i < readInt.size(); ++i)
+      REQUIRE_EQ(writeInt[i], readInt[i]);
+
+    cv.readParallel(buffers, 0, 1000, 2);
+    for (size_t i = 0; i < readInt.size(); ++i)
+      REQUIRE_EQ(writeInt[i], readInt[i]);
+
+    imf.close();
+  }
+
+  TEST_CASE("CompressedVectorReader readAsync")
+  {
+    TempFile tempFile;
+
+    const size_t         N = 100000;
+    std::vector<int64_t> writeInt(N);
+    std::vector<double>  writeDouble(N);
+    std::vector<ustring> writeString(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeInt[i]    = static_cast<int64_t>((i * 7919) % 1000003);
+      writeDouble[i] = static_cast<double>(i) * 0.25;
+      writeString[i] = (i % 11 == 0) ? std::string(i % 100, static_cast<char>('a' + i % 26)) : "";
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000218}"));
+
+      StructureNode proto(imf);
+      proto.set("int", IntegerNode(imf, 0, 0, 1000002));
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+      proto.set("string", StringNode(imf, ""));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", writeInt.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", writeDouble.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "string", &writeString));
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      writer.write(N);
+      writer.close();
+      imf.close();
+    }
+
+    /// One set of destination buffers, so reads can alternate between them
+    struct BufferSet
+    {
+      std::vector<int64_t>          ints;
+      std::vector<double>           doubles;
+      std::vector<ustring>          strings;
+      std::vector<SourceDestBuffer> buffers;
+
+      BufferSet(ImageFile imf, size_t capacity) : ints(capacity), doubles(capacity), strings(capacity)
+      {
+        buffers.push_back(SourceDestBuffer(imf, "int", ints.data(), capacity, true));
+        buffers.push_back(SourceDestBuffer(imf, "double", doubles.data(), capacity, true));
+        buffers.push_back(SourceDestBuffer(imf, "string", &strings));
+      }
+
+      void check(size_t first, unsigned count, const std::vector<int64_t>& wantInt, const std::vector<double>& wantDouble,
+                 const std::vector<ustring>& wantString) const
+      {
+        for (size_t i = 0; i < count; ++i)
+        {
+          REQUIRE_EQ(wantInt[first + i], ints[i]);
+          REQUIRE_EQ(wantDouble[first + i], doubles[i]);
+          REQUIRE_EQ(wantString[first + i], strings[i]);
+        }
+      }
+    };
+
+    auto readAll = [&](const char* configuration) {
+      ImageFile            imf(tempFile.c_str(), "r", configuration);
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      /// String buffers refer to the vector itself, so the sets stay where they are and reads alternate between them
+      const size_t capacity = 7001;
+      BufferSet    sets[2]  = {BufferSet(imf, capacity), BufferSet(imf, capacity)};
+      BufferSet&   current  = sets[0];
+      BufferSet&   next     = sets[1];
+
+      /// Decode the next block into one set while checking the block just read into the other
+      CompressedVectorReader reader  = cv.reader(sets[0].buffers);
+      std::future<unsigned>  pending = reader.readAsync(sets[0].buffers);
+      size_t                 first   = 0;
+      unsigned               count;
+      for (unsigned k = 0; (count = pending.get()) > 0; k = 1 - k)
+      {
+        pending = reader.readAsync(sets[1 - k].buffers);
+        sets[k].check(first, count, writeInt, writeDouble, writeString);
+        first += count;
+      }
+      REQUIRE_EQ(N, first);
+
+      /// Synchronous reads and seeks wait for a read in progress, and can switch buffers too
+      reader.seek(0);
+      pending = reader.readAsync(next.buffers);
+      reader.seek(50000);
+      REQUIRE_EQ(capacity, pending.get());
+      next.check(0, capacity, writeInt, writeDouble, writeString);
+      REQUIRE_EQ(capacity, reader.read(current.buffers));
+      current.check(50000, capacity, writeInt, writeDouble, writeString);
+
+      /// Buffers are checked before the read is started
+      std::vector<int64_t>          shortInts(10);
+      std::vector<SourceDestBuffer> shortBuffers;
+      shortBuffers.push_back(SourceDestBuffer(imf, "int", shortInts.data(), shortInts.size(), true));
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BUFFERS_NOT_COMPATIBLE, [&]() { reader.readAsync(shortBuffers); }));
+
+      /// Closing waits for a read in progress
+      pending = reader.readAsync(next.buffers);
+      reader.close();
+      REQUIRE_EQ(capacity, pending.get());
+      next.check(50000 + capacity, capacity, writeInt, writeDouble, writeString);
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_READER_NOT_OPEN, [&]() { reader.readAsync(next.buffers); }));
+
+      /// So does destroying a reader that is still reading
+      {
+        CompressedVectorReader other = cv.reader(current.buffers);
+        pending                      = other.readAsync(current.buffers);
+      }
+      REQUIRE_EQ(capacity, pending.get());
+      current.check(0, capacity, writeInt, writeDouble, writeString);
+
+      REQUIRE_EQ(0, imf.readerCount());
+      imf.close();
+    };
+
+    readAll("");
+    readAll("decoders=2 prefetch=2");
+    readAll("mmap");
+  }
+
+  TEST_CASE("CompressedVectorWriter with encoder threads")
+  {
+    TempFile serialFile;
+    TempFile parallelFile;
+
+    const size_t         N = 100000;
+    std::vector<double>  writeScaled(N);
+    std::vector<int32_t> writeInt(N);
+    std::vector<int64_t> writeIndex(N);
+    std::vector<float>   writeFloat(N);
+    std::vector<double>  writeDouble(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeScaled[i] = static_cast<double>(static_cast<int64_t>((i * 7919) % 200001) - 100000) * 0.001;
+      writeInt[i]    = static_cast<int32_t>(i % 4096);
+      writeIndex[i]  = static_cast<int64_t>(i * i % (1LL << 40));
+      writeFloat[i]  = static_cast<float>(i) * 0.5f;
+      writeDouble[i] = static_cast<double>(i) * 1e-3;
+    }
+
+    /// Write the vector in uneven chunks through the same buffers, the last value of "int" replaced by badInt, return the error code of the failed write
+    auto writeFile = [&](const TempFile& file, const char* configuration, int32_t badInt) {
+      ImageFile     imf(file.c_str(), "w", configuration);
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000213}"));
+
+      StructureNode proto(imf);
+      proto.set("scaled", ScaledIntegerNode(imf, 0, -100000, 100000, 0.001, 0.0));
+      proto.set("int", IntegerNode(imf, 0, 0, 4095));
+      proto.set("index", IntegerNode(imf, 0, 0, 1LL << 40));
+      proto.set("float", FloatNode(imf, 0.0, E57_SINGLE));
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      const size_t         C = N / 4;
+      std::vector<double>  scaled(C);
+      std::vector<int32_t> ints(C);
+      std::vector<int64_t> index(C);
+      std::vector<float>   floats(C);
+      std::vector<double>  doubles(C);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "scaled", scaled.data(), C, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "int", ints.data(), C, true));
+      buffers.push_back(SourceDestBuffer(imf, "index", index.data(), C, true));
+      buffers.push_back(SourceDestBuffer(imf, "float", floats.data(), C, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", doubles.data(), C, true));
+
+      /// Writer must be gone before the file is closed, even when the write failed
+      int errorCode = 0;
+      try
+      {
+        CompressedVectorWriter writer   = cv.writer(buffers);
+        const size_t           chunks[] = {C, 17, 1, C - 18, C, C};
+        size_t                 done     = 0;
+        for (size_t chunk : chunks)
+        {
+          std::copy_n(writeScaled.begin() + done, chunk, scaled.begin());
+          std::copy_n(writeInt.begin() + done, chunk, ints.begin());
+          std::copy_n(writeIndex.begin() + done, chunk, index.begin());
+          std::copy_n(writeFloat.begin() + done, chunk, floats.begin());
+          std::copy_n(writeDouble.begin() + done, chunk, doubles.begin());
+          done += chunk;
+          if (done == N)
+            ints[chunk - 1] = badInt;
+          writer.write(chunk);
+        }
+        writer.close();
+      }
+      catch (E57Exception& ex)
+      {
+        errorCode = ex.errorCode();
+      }
+      imf.close();
+      return errorCode;
+    };
+
+    /// Packets are cut at the same records whatever the number of threads
+    REQUIRE_EQ(0, writeFile(serialFile, "", writeInt[N - 1]));
+    REQUIRE_EQ(0, writeFile(parallelFile, "encoders=4", writeInt[N - 1]));
+    std::vector<char> serialBytes   = e57::test::readFileBytes(serialFile);
+    std::vector<char> parallelBytes = e57::test::readFileBytes(parallelFile);
+    REQUIRE(serialBytes == parallelBytes);
+
+    REQUIRE_EQ(0, writeFile(parallelFile, "encoders=64", writeInt[N - 1]));
+    parallelBytes = e57::test::readFileBytes(parallelFile);
+    REQUIRE(serialBytes == parallelBytes);
+
+    {
+      ImageFile            imf(parallelFile.c_str(), "r");
+      CompressedVectorNode cv(imf.root().get("data"));
+
+      std::vector<double>  readScaled(N);
+      std::vector<int32_t> readInt(N);
+      std::vector<int64_t> readIndex(N);
+      std::vector<float>   readFloat(N);
+      std::vector<double>  readDouble(N);
+
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "scaled", readScaled.data(), N, true, true));
+      buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "index", readIndex.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "float", readFloat.data(), N, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", readDouble.data(), N, true));
+
+      CompressedVectorReader reader = cv.reader(buffers);
+      unsigned               count  = reader.read();
+      reader.close();
+      REQUIRE_EQ(N, count);
+
+      for (size_t i = 0; i < N; ++i)
+      {
+        INFO("record=" << i);
+        REQUIRE(std::fabs(writeScaled[i] - readScaled[i]) < 1e-9);
+        REQUIRE_EQ(writeInt[i], readInt[i]);
+        REQUIRE_EQ(writeIndex[i], readIndex[i]);
+        REQUIRE_EQ(writeFloat[i], readFloat[i]);
+        REQUIRE_EQ(writeDouble[i], readDouble[i]);
+      }
+      imf.close();
+    }
+
+    /// An encoder failing on a worker thread is reported by write()
+    REQUIRE_EQ(E57_ERROR_VALUE_OUT_OF_BOUNDS, writeFile(parallelFile, "encoders=4", 4096));
+  }
+
+  TEST_CASE("CompressedVectorWriter with write queue")
+  {
+    TempFile serialFile;
+    TempFile queuedFile;
+
+    const size_t         N = 60000;
+    const size_t         B = 7000;
+    std::vector<int64_t> writeInt(N);
+    std::vector<double>  writeDouble(N);
+    std::vector<uint8_t> writeBlob(100000);
+    for (size_t i = 0; i < N; ++i)
+    {
+      writeInt[i]    = static_cast<int64_t>((i * 7919) % 1000003);
+      writeDouble[i] = static_cast<double>(i) * 0.25;
+    }
+    for (size_t i = 0; i < writeBlob.size(); ++i)
+      writeBlob[i] = static_cast<uint8_t>(i * 13);
+
+    /// Write the vector in batches, reading back a blob written before the vector between two of them, while packets may still be queued
+    auto writeFile = [&](const TempFile& file, const char* configuration) {
+      ImageFile     imf(file.c_str(), "w", configuration);
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000214}"));
+
+      StructureNode proto(imf);
+      proto.set("int", IntegerNode(imf, 0, 0, 1000002));
+      proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+
+      BlobNode blob(imf, writeBlob.size());
+      root.set("blob", blob);
+      blob.write(writeBlob.data(), 0, writeBlob.size());
+
+      VectorNode           codecs(imf, true);
+      CompressedVectorNode cv(imf, proto, codecs);
+      root.set("data", cv);
+
+      std::vector<int64_t>          ints(B);
+      std::vector<double>           doubles(B);
+      std::vector<SourceDestBuffer> buffers;
+      buffers.push_back(SourceDestBuffer(imf, "int", ints.data(), B, true));
+      buffers.push_back(SourceDestBuffer(imf, "double", doubles.data(), B, true));
+
+      CompressedVectorWriter writer = cv.writer(buffers);
+      for (size_t done = 0; done < N; done += B)
+      {
+        size_t count = std::min(B, N - done);
+        std::copy_n(writeInt.begin() + done, count, ints.begin());
+        std::copy_n(writeDouble.begin() + done, count, doubles.begin());
+        writer.write(count);
+
+        if (done == 3 * B)
+        {
+          std::vector<uint8_t> readBlob(writeBlob.size());
+          blob.read(readBlob.data(), 0, readBlob.size());
+          REQUIRE(writeBlob == readBlob);
+        }
+      }
+      writer.close();
+      imf.close();
+    };
+
+    /// Packets are placed when queued, so the file is the same as one written directly
+    writeFile(serialFile, "");
+    std::vector<char> serialBytes = e57::test::readFileBytes(serialFile);
+    for (const char* configuration : {"writequeue=1", "writequeue=4", "writequeue=64, encoders=2"})
+    {
+      INFO("configuration=" << configuration);
+      writeFile(queuedFile, configuration);
+      std::vector<char> queuedBytes = e57::test::readFileBytes(queuedFile);
+      REQUIRE(serialBytes == queuedBytes);
+    }
+
+    ImageFile            imf(queuedFile.c_str(), "r");
+    CompressedVectorNode cv(imf.root().get("data"));
+
+    std::vector<int64_t>          readInt(N);
+    std::vector<double>           readDouble(N);
+    std::vector<SourceDestBuffer> buffers;
+    buffers.push_back(SourceDestBuffer(imf, "int", readInt.data(), N, true));
+    buffers.push_back(SourceDestBuffer(imf, "double", readDouble.data(), N, true));
+
+    CompressedVectorReader reader = cv.reader(buffers);
+    unsigned               count  = reader.read();
+    reader.close();
+    REQUIRE_EQ(N, count);
+    REQUIRE(writeInt == readInt);
+    REQUIRE(writeDouble == readDouble);
+
+    BlobNode             blob(imf.root().get("blob"));
+    std::vector<uint8_t> readBlob(writeBlob.size());
+    blob.read(readBlob.data(), 0, readBlob.size());
+    REQUIRE(writeBlob == readBlob);
+    imf.close();
+  }
+
+  TEST_CASE("CompressedVectorWriters of several CompressedVectors open at once")
+  {
+    TempFile tempFile;
+
+    const size_t N = 40000;
+    const size_t B = 5000;
+
+    auto writeInt    = [](int v, size_t i) { return static_cast<int64_t>((v * 100003 + i * 7919) % 1000003); };
+    auto writeString = [](int v, size_t i) { return (i % 7 == 0) ? ustring(i % 90, static_cast<char>('a' + v)) : ustring(); };
+
+    struct Vector
+    {
+      std::vector<int64_t>          ints;
+      std::vector<ustring>          strings;
+      std::vector<SourceDestBuffer> buffers;
+      size_t                        done = 0;
+    };
+
+    /// The first writer opened appends to the file, the others keep their packets until the end of the file is free.
+    /// Writers are closed in a different order than opened, and one is opened while another waits to be written.
+    auto writeFile = [&](const char* configuration) {
+      ImageFile     imf(tempFile.c_str(), "w", configuration);
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000217}"));
+
+      std::vector<CompressedVectorNode> cvs;
+      std::vector<Vector>               vectors(3);
+      for (int v = 0; v < 3; ++v)
+      {
+        StructureNode proto(imf);
+        proto.set("int", IntegerNode(imf, 0, 0, 1000002));
+        proto.set("string", StringNode(imf, ""));
+
+        VectorNode           codecs(imf, true);
+        CompressedVectorNode cv(imf, proto, codecs);
+        root.set("data" + std::to_string(v), cv);
+        cvs.push_back(cv);
+
+        vectors[v].ints.resize(B);
+        vectors[v].strings.resize(B);
+        vectors[v].buffers.push_back(SourceDestBuffer(imf, "int", vectors[v].ints.data(), B, true));
+        vectors[v].buffers.push_back(SourceDestBuffer(imf, "string", &vectors[v].strings));
+      }
+
+      auto writeBlock = [&](int v, CompressedVectorWriter& writer) {
+        Vector& vector = vectors[v];
+        for (size_t i = 0; i < B; ++i)
+        {
+          vector.ints[i]    = writeInt(v, vector.done + i);
+          vector.strings[i] = writeString(v, vector.done + i);
+        }
+        writer.write(B);
+        vector.done += B;
+      };
+
+      CompressedVectorWriter writer0 = cvs[0].writer(vectors[0].buffers);
+      CompressedVectorWriter writer1 = cvs[1].writer(vectors[1].buffers);
+      REQUIRE_EQ(2, imf.writerCount());
+
+      /// Still only one writer per CompressedVector, and no readers meanwhile
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_TOO_MANY_WRITERS, [&]() { cvs[0].writer(vectors[0].buffers); }));
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_TOO_MANY_WRITERS, [&]() { cvs[2].reader(vectors[2].buffers); }));
+
+      for (size_t i = 0; i < N / B / 2; ++i)
+      {
+        writeBlock(0, writer0);
+        writeBlock(1, writer1);
+      }
+      while (vectors[1].done < N)
+        writeBlock(1, writer1);
+      writer1.close();
+      REQUIRE_EQ(static_cast<int64_t>(N), cvs[1].childCount());
+
+      CompressedVectorWriter writer2 = cvs[2].writer(vectors[2].buffers);
+      writeBlock(2, writer2);
+      while (vectors[0].done < N)
+        writeBlock(0, writer0);
+      writer0.close();
+
+      while (vectors[2].done < N)
+        writeBlock(2, writer2);
+      writer2.close();
+      REQUIRE_EQ(0, imf.writerCount());
+
+      imf.close();
+    };
+
+    auto readFile = [&]() {
+      ImageFile imf(tempFile.c_str(), "r");
+      for (int v = 0; v < 3; ++v)
+      {
+        CompressedVectorNode cv(imf.root().get("data" + std::to_string(v)));
+        REQUIRE_EQ(static_cast<int64_t>(N), cv.childCount());
+
+        std::vector<int64_t>          ints(N);
+        std::vector<ustring>          strings(N);
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "int", ints.data(), N, true));
+        buffers.push_back(SourceDestBuffer(imf, "string", &strings));
+
+        CompressedVectorReader reader = cv.reader(buffers);
+        REQUIRE_EQ(N, reader.read());
+
+        /// Seeking uses the index packets, whose offsets are only known when a section gets to the end of the file
+        std::vector<int64_t>          tailInts(B);
+        std::vector<ustring>          tailStrings(B);
+        std::vector<SourceDestBuffer> tailBuffers;
+        tailBuffers.push_back(SourceDestBuffer(imf, "int", tailInts.data(), B, true));
+        tailBuffers.push_back(SourceDestBuffer(imf, "string", &tailStrings));
+        CompressedVectorReader tailReader = cv.reader(tailBuffers);
+        tailReader.seek(static_cast<int64_t>(N - B));
+        REQUIRE_EQ(B, tailReader.read());
+        tailReader.close();
+        reader.close();
+
+        for (size_t i = 0; i < N; ++i)
+        {
+          REQUIRE_EQ(writeInt(v, i), ints[i]);
+          REQUIRE_EQ(writeString(v, i), strings[i]);
+        }
+        for (size_t i = 0; i < B; ++i)
+        {
+          REQUIRE_EQ(ints[N - B + i], tailInts[i]);
+          REQUIRE_EQ(strings[N - B + i], tailStrings[i]);
+        }
+      }
+      imf.close();
+    };
+
+    writeFile("");
+    readFile();
+    writeFile("encoders=2 writequeue=4");
+    readFile();
+  }
+
+  TEST_CASE("CompressedVectorWriter waiting for the end of the file spools more than fits in memory")
+  {
+    TempFile tempFile;
+
+    /// Several MB of packets per waiting writer, well past what a waiting section keeps in memory
+    const size_t N = 400000;
+    const size_t B = 25000;
+
+    auto writeDouble = [](int v, size_t i) { return static_cast<double>(i) * 0.5 + v; };
+    auto writeInt    = [](int v, size_t i) { return static_cast<int64_t>((v * 100003 + i * 7919) % 1000003); };
+
+    struct Vector
+    {
+      std::vector<double>           doubles;
+      std::vector<int64_t>          ints;
+      std::vector<SourceDestBuffer> buffers;
+      size_t                        done = 0;
+    };
+
+    /// Closing the owner of the end of the file first hands it to a waiting writer that is still open,
+    /// closing a waiting writer first leaves its whole spool for the owner to write out.
+    for (bool ownerClosesFirst : {true, false})
+    {
+      {
+        ImageFile     imf(tempFile.c_str(), "w");
+        StructureNode root = imf.root();
+        root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+        root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000225}"));
+
+        std::vector<CompressedVectorNode> cvs;
+        std::vector<Vector>               vectors(3);
+        for (int v = 0; v < 3; ++v)
+        {
+          StructureNode proto(imf);
+          proto.set("double", FloatNode(imf, 0.0, E57_DOUBLE));
+          proto.set("int", IntegerNode(imf, 0, 0, 1000002));
+
+          VectorNode           codecs(imf, true);
+          CompressedVectorNode cv(imf, proto, codecs);
+          root.set("data" + std::to_string(v), cv);
+          cvs.push_back(cv);
+
+          vectors[v].doubles.resize(B);
+          vectors[v].ints.resize(B);
+          vectors[v].buffers.push_back(SourceDestBuffer(imf, "double", vectors[v].doubles.data(), B));
+          vectors[v].buffers.push_back(SourceDestBuffer(imf, "int", vectors[v].ints.data(), B, true));
+        }
+
+        std::vector<CompressedVectorWriter> writers;
+        for (int v = 0; v < 3; ++v)
+          writers.push_back(cvs[v].writer(vectors[v].buffers));
+
+        for (size_t done = 0; done < N; done += B)
+        {
+          for (int v = 0; v < 3; ++v)
+          {
+            for (size_t i = 0; i < B; ++i)
+            {
+              vectors[v].doubles[i] = writeDouble(v, done + i);
+              vectors[v].ints[i]    = writeInt(v, done + i);
+            }
+            writers[v].write(B);
+          }
+        }
+
+        if (ownerClosesFirst)
+        {
+          for (int v = 0; v < 3; ++v)
+            writers[v].close();
+        }
+        else
+        {
+          for (int v = 2; v >= 0; --v)
+            writers[v].close();
+        }
+        imf.close();
+      }
+
+      ImageFile imf(tempFile.c_str(), "r");
+      for (int v = 0; v < 3; ++v)
+      {
+        CompressedVectorNode cv(imf.root().get("data" + std::to_string(v)));
+        REQUIRE_EQ(static_cast<int64_t>(N), cv.childCount());
+
+        std::vector<double>           doubles(N);
+        std::vector<int64_t>          ints(N);
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "double", doubles.data(), N));
+        buffers.push_back(SourceDestBuffer(imf, "int", ints.data(), N, true));
+
+        CompressedVectorReader reader = cv.reader(buffers);
+        REQUIRE_EQ(N, reader.read());
+        reader.close();
+
+        for (size_t i = 0; i < N; ++i)
+        {
+          REQUIRE_EQ(writeDouble(v, i), doubles[i]);
+          REQUIRE_EQ(writeInt(v, i), ints[i]);
+        }
+
+        /// The index packets of a spooled section point into the packets copied back from the temporary file
+        std::vector<double>           tailDoubles(B);
+        std::vector<SourceDestBuffer> tailBuffers;
+        tailBuffers.push_back(SourceDestBuffer(imf, "double", tailDoubles.data(), B));
+        CompressedVectorReader tailReader = cv.reader(tailBuffers);
+        tailReader.seek(static_cast<int64_t>(N / 3));
+        REQUIRE_EQ(B, tailReader.read());
+        tailReader.close();
+        for (size_t i = 0; i < B; ++i)
+          REQUIRE_EQ(writeDouble(v, N / 3 + i), tailDoubles[i]);
+      }
       imf.close();
     }
   }
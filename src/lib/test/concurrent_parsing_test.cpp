@@ -30,9 +30,11 @@
 
 #include "test_utils.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <future>
+#include <stdexcept>
 #include <string>
 #include <thread>
 #include <vector>
@@ -314,4 +316,262 @@ TEST_SUITE("Concurrent Parsing Tests")
     for (auto& f : futures)
       REQUIRE(f.get());
   }
+
+  TEST_CASE("Multiple threads read the scans of one open file concurrently")
+  {
+    constexpr int    NUM_SCANS   = 4;
+    constexpr int    NUM_THREADS = 2 * NUM_SCANS + 1;
+    constexpr size_t N           = 50000;
+    constexpr size_t BLOB_SIZE   = 200000;
+
+    TempFile tempFile;
+
+    auto expectedValue = [](int scan, size_t i) { return static_cast<int64_t>((scan * 100003 + i * 7919) % 1000000); };
+    auto expectedByte  = [](size_t i) { return static_cast<uint8_t>(i * 13); };
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000007777}"));
+
+      VectorNode scans(imf, true);
+      root.set("scans", scans);
+
+      for (int s = 0; s < NUM_SCANS; ++s)
+      {
+        StructureNode proto(imf);
+        proto.set("value", IntegerNode(imf, 0, 0, 999999));
+        proto.set("x", FloatNode(imf, 0.0, E57_DOUBLE));
+
+        VectorNode           codecs(imf, true);
+        CompressedVectorNode cv(imf, proto, codecs);
+        StructureNode        scan(imf);
+        scan.set("points", cv);
+        scans.append(scan);
+
+        std::vector<int64_t> values(N);
+        std::vector<double>  xs(N);
+        for (size_t i = 0; i < N; ++i)
+        {
+          values[i] = expectedValue(s, i);
+          xs[i]     = static_cast<double>(values[i]) * 0.5;
+        }
+
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "value", values.data(), N, true));
+        buffers.push_back(SourceDestBuffer(imf, "x", xs.data(), N, true));
+
+        CompressedVectorWriter writer = cv.writer(buffers);
+        writer.write(N);
+        writer.close();
+      }
+
+      std::vector<uint8_t> bytes(BLOB_SIZE);
+      for (size_t i = 0; i < BLOB_SIZE; ++i)
+        bytes[i] = expectedByte(i);
+      BlobNode blob(imf, BLOB_SIZE);
+      root.set("blob", blob);
+      blob.write(bytes.data(), 0, BLOB_SIZE);
+
+      imf.close();
+    }
+
+    for (const char* configuration : {"", "mmap", "prefetch=2", "decoders=2"})
+    {
+      ImageFile  imf(tempFile.c_str(), "r", configuration);
+      VectorNode scans(imf.root().get("scans"));
+
+      /// Two threads per scan, reading in small blocks so the readers interleave, plus one reading the blob
+      std::vector<std::future<void>> futures;
+      std::vector<std::string>       errorMessages(NUM_THREADS);
+
+      for (int i = 0; i < NUM_THREADS; ++i)
+      {
+        futures.push_back(std::async(std::launch::async, [&, i]()
+        {
+          try
+          {
+            if (i == NUM_THREADS - 1)
+            {
+              BlobNode             blob(imf.root().get("blob"));
+              std::vector<uint8_t> bytes(BLOB_SIZE / 4);
+              for (size_t start = 0; start < BLOB_SIZE; start += bytes.size())
+              {
+                blob.read(bytes.data(), static_cast<int64_t>(start), bytes.size());
+                for (size_t j = 0; j < bytes.size(); ++j)
+                {
+                  if (bytes[j] != expectedByte(start + j))
+                    throw std::runtime_error("blob mismatch at " + std::to_string(start + j));
+                }
+              }
+              return;
+            }
+
+            int                  s = i / 2;
+            StructureNode        scan(scans.get(s));
+            CompressedVectorNode cv(scan.get("points"));
+
+            std::vector<int64_t>          values(997);
+            std::vector<double>           xs(values.size());
+            std::vector<SourceDestBuffer> buffers;
+            buffers.push_back(SourceDestBuffer(imf, "value", values.data(), values.size(), true));
+            buffers.push_back(SourceDestBuffer(imf, "x", xs.data(), xs.size(), true));
+
+            CompressedVectorReader reader = cv.reader(buffers);
+            size_t                 next   = 0;
+            if (i % 2 == 1)
+            {
+              next = N / 3;
+              reader.seek(static_cast<int64_t>(next));
+            }
+
+            unsigned count = 0;
+            while ((count = reader.read()) > 0)
+            {
+              for (unsigned j = 0; j < count; ++j)
+              {
+                if (values[j] != expectedValue(s, next + j) || xs[j] != static_cast<double>(values[j]) * 0.5)
+                  throw std::runtime_error("data mismatch in scan " + std::to_string(s) + " at " + std::to_string(next + j));
+              }
+              next += count;
+            }
+            reader.close();
+
+            if (next != N)
+              throw std::runtime_error("count mismatch: expected " + std::to_string(N) + " got " + std::to_string(next));
+          }
+          catch (const std::exception& e)
+          {
+            errorMessages[i] = e.what();
+          }
+        }));
+      }
+
+      for (auto& f : futures)
+        f.wait();
+
+      for (int i = 0; i < NUM_THREADS; ++i)
+      {
+        if (!errorMessages[i].empty())
+          FAIL("Thread ", i, " failed with configuration '", configuration, "': ", errorMessages[i]);
+      }
+
+      REQUIRE_EQ(0, imf.readerCount());
+      imf.close();
+    }
+  }
+
+  TEST_CASE("Multiple threads write the scans of one file concurrently")
+  {
+    constexpr int    NUM_SCANS = 6;
+    constexpr size_t N         = 30000;
+    constexpr size_t B         = 4000;
+
+    TempFile tempFile;
+
+    auto expectedValue = [](int scan, size_t i) { return static_cast<int64_t>((scan * 100003 + i * 7919) % 1000000); };
+    auto expectedName  = [](int scan, size_t i) { return (i % 11 == 0) ? std::string(i % 40, static_cast<char>('a' + scan)) : std::string(); };
+
+    for (const char* configuration : {"", "writequeue=4", "encoders=2"})
+    {
+      {
+        ImageFile     imf(tempFile.c_str(), "w", configuration);
+        StructureNode root = imf.root();
+        root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+        root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000006666}"));
+
+        /// The tree is built up front, only the CompressedVectors are written on the threads
+        VectorNode scans(imf, true);
+        root.set("scans", scans);
+        std::vector<CompressedVectorNode> points;
+        for (int s = 0; s < NUM_SCANS; ++s)
+        {
+          StructureNode proto(imf);
+          proto.set("value", IntegerNode(imf, 0, 0, 999999));
+          proto.set("name", StringNode(imf, ""));
+
+          VectorNode           codecs(imf, true);
+          CompressedVectorNode cv(imf, proto, codecs);
+          StructureNode        scan(imf);
+          scan.set("points", cv);
+          scans.append(scan);
+          points.push_back(cv);
+        }
+
+        std::vector<std::future<void>> futures;
+        std::vector<std::string>       errorMessages(NUM_SCANS);
+
+        for (int s = 0; s < NUM_SCANS; ++s)
+        {
+          futures.push_back(std::async(std::launch::async, [&, s]()
+          {
+            try
+            {
+              std::vector<int64_t>          values(B);
+              std::vector<ustring>          names(B);
+              std::vector<SourceDestBuffer> buffers;
+              buffers.push_back(SourceDestBuffer(imf, "value", values.data(), B, true));
+              buffers.push_back(SourceDestBuffer(imf, "name", &names));
+
+              CompressedVectorWriter writer = points[s].writer(buffers);
+              for (size_t done = 0; done < N; done += B)
+              {
+                size_t count = std::min(B, N - done);
+                for (size_t i = 0; i < count; ++i)
+                {
+                  values[i] = expectedValue(s, done + i);
+                  names[i]  = expectedName(s, done + i);
+                }
+                writer.write(count);
+              }
+              writer.close();
+            }
+            catch (const std::exception& e)
+            {
+              errorMessages[s] = e.what();
+            }
+          }));
+        }
+
+        for (auto& f : futures)
+          f.wait();
+
+        for (int s = 0; s < NUM_SCANS; ++s)
+        {
+          if (!errorMessages[s].empty())
+            FAIL("Writer ", s, " failed with configuration '", configuration, "': ", errorMessages[s]);
+        }
+
+        REQUIRE_EQ(0, imf.writerCount());
+        imf.close();
+      }
+
+      ImageFile  imf(tempFile.c_str(), "r");
+      VectorNode scans(imf.root().get("scans"));
+      for (int s = 0; s < NUM_SCANS; ++s)
+      {
+        StructureNode        scan(scans.get(s));
+        CompressedVectorNode cv(scan.get("points"));
+        REQUIRE_EQ(static_cast<int64_t>(N), cv.childCount());
+
+        std::vector<int64_t>          values(N);
+        std::vector<ustring>          names(N);
+        std::vector<SourceDestBuffer> buffers;
+        buffers.push_back(SourceDestBuffer(imf, "value", values.data(), N, true));
+        buffers.push_back(SourceDestBuffer(imf, "name", &names));
+
+        CompressedVectorReader reader = cv.reader(buffers);
+        REQUIRE_EQ(N, reader.read());
+        reader.close();
+
+        for (size_t i = 0; i < N; ++i)
+        {
+          REQUIRE_EQ(expectedValue(s, i), values[i]);
+          REQUIRE_EQ(expectedName(s, i), names[i]);
+        }
+      }
+      imf.close();
+    }
+  }
 }
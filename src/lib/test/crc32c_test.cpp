@@ -0,0 +1,123 @@
+/*
+ * crc32c_test.cpp - Tests for CRC32C page checksum engines
+ *
+ * Copyright (c) 2024 openE57 Contributors
+ *
+ * Permission is hereby granted, free of charge, to any person or organization
+ * obtaining a copy of the software and accompanying documentation covered by
+ * this license (the "Software") to use, reproduce, display, distribute,
+ * execute, and transmit the Software, and to prepare derivative works of the
+ * Software, and to permit third-parties to whom the Software is furnished to
+ * do so, all subject to the following:
+ *
+ * The copyright notices in the Software and this entire statement, including
+ * the above license grant, this restriction and the following disclaimer,
+ * must be included in all copies of the Software, in whole or in part, and
+ * all derivative works of the Software, unless such copies or derivative
+ * works are solely in the form of machine-executable object code generated by
+ * a source language processor.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+ * SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+ * FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+
+#include <doctest/doctest.h>
+#include <openE57/impl/crc.h>
+#include <openE57/impl/crc32c.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace e57;
+
+namespace
+{
+  std::uint32_t referenceCrc(const void* buf, std::size_t size)
+  {
+    static const auto table = CRC::CRC_32_C().MakeTable();
+    return CRC::Calculate(buf, size, table);
+  }
+
+  std::vector<std::uint8_t> pseudoRandomBytes(std::size_t size, std::uint32_t seed)
+  {
+    std::vector<std::uint8_t> bytes(size);
+    for (auto& b : bytes)
+    {
+      seed = seed * 1664525u + 1013904223u;
+      b    = static_cast<std::uint8_t>(seed >> 24);
+    }
+    return bytes;
+  }
+
+  const utils::Crc32cEngine allEngines[] = {utils::Crc32cEngine::Table, utils::Crc32cEngine::Sse42, utils::Crc32cEngine::Sse42Clmul,
+                                            utils::Crc32cEngine::Armv8};
+} // namespace
+
+TEST_SUITE("CRC32C Tests")
+{
+  TEST_CASE("CRC32C matches standard check value")
+  {
+    const char check[] = "123456789";
+    REQUIRE_EQ(utils::crc32c(check, 9), 0xE3069283u);
+    REQUIRE_EQ(referenceCrc(check, 9), 0xE3069283u);
+    REQUIRE_EQ(utils::crc32c(check, 0), 0u);
+  }
+
+  TEST_CASE("Table engine is always supported and dispatch selects a supported engine")
+  {
+    REQUIRE(utils::crc32c_engine_supported(utils::Crc32cEngine::Table));
+    REQUIRE(utils::crc32c_engine_supported(utils::crc32c_engine()));
+  }
+
+  TEST_CASE("All engines are bit-exact with the table implementation")
+  {
+    /// Cover short lengths, the 1020 byte page payload, and lengths around the multi-stream block boundaries
+    const std::vector<std::uint8_t> data = pseudoRandomBytes(3 * 4096 * 2 + 64, 57);
+
+    std::vector<std::size_t> sizes;
+    for (std::size_t n = 0; n <= 64; n++)
+      sizes.push_back(n);
+    for (std::size_t n : {1007u, 1008u, 1009u, 1019u, 1020u, 1021u, 2040u, 3 * 4096u - 1, 3 * 4096u, 3 * 4096u + 1, 3 * 4096u + 1020u})
+      sizes.push_back(n);
+    sizes.push_back(data.size() - 8);
+
+    for (utils::Crc32cEngine engine : allEngines)
+    {
+      if (!utils::crc32c_engine_supported(engine))
+        continue;
+      for (std::size_t size : sizes)
+      {
+        /// Unaligned starts exercise the head loops of the word at a time engines
+        for (std::size_t start = 0; start < 8; start++)
+        {
+          INFO("engine=" << static_cast<int>(engine) << " size=" << size << " start=" << start);
+          REQUIRE_EQ(utils::crc32c(&data[start], size, engine), referenceCrc(&data[start], size));
+        }
+      }
+    }
+  }
+
+  TEST_CASE("Default dispatch is bit-exact with the table implementation on page payloads")
+  {
+    for (std::uint32_t seed = 0; seed < 64; seed++)
+    {
+      const std::vector<std::uint8_t> page = pseudoRandomBytes(1020, seed);
+      REQUIRE_EQ(utils::crc32c(page.data(), page.size()), referenceCrc(page.data(), page.size()));
+    }
+  }
+
+  TEST_CASE("Unsupported engine falls back to the table implementation")
+  {
+    const std::vector<std::uint8_t> data = pseudoRandomBytes(1020, 1);
+    for (utils::Crc32cEngine engine : allEngines)
+      REQUIRE_EQ(utils::crc32c(data.data(), data.size(), engine), referenceCrc(data.data(), data.size()));
+  }
+}
@@ -34,10 +34,13 @@
 
 #include "test_utils.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
+#include <string>
 #include <vector>
 
 using namespace e57;
@@ -103,6 +106,75 @@ void writeDeterministicE57(const std::string& path)
   imf.close();
 }
 
+// Several data packets of a ScaledInteger, narrow Integers, floats and a string field, written in uneven chunks
+void writeMixedMultiPacketE57(const std::string& path)
+{
+  static constexpr size_t   CHUNK_SIZES[] = {1, 4999, 7, 12345, 333, 2, 8191, 64};
+  static constexpr size_t   MAX_CHUNK     = 12345;
+  static constexpr uint64_t RECORD_COUNT  = 60000;
+
+  std::vector<double>   x(MAX_CHUNK);
+  std::vector<float>    y(MAX_CHUNK);
+  std::vector<double>   timeStamp(MAX_CHUNK);
+  std::vector<uint16_t> intensity(MAX_CHUNK);
+  std::vector<uint8_t>  red(MAX_CHUNK);
+  std::vector<ustring>  name(MAX_CHUNK);
+
+  ImageFile     imf(path.c_str(), "w");
+  StructureNode root = imf.root();
+
+  root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+  root.set("guid", StringNode(imf, FILE_GUID));
+
+  StructureNode proto(imf);
+  proto.set("cartesianX", ScaledIntegerNode(imf, 0, -1000000, 1000000, 0.001, 0.0));
+  proto.set("cartesianY", FloatNode(imf, 0.0, FloatPrecision::E57_SINGLE));
+  proto.set("timeStamp", FloatNode(imf, 0.0, FloatPrecision::E57_DOUBLE));
+  proto.set("intensity", IntegerNode(imf, 0, 0, 4095));
+  proto.set("colorRed", IntegerNode(imf, 0, 0, 255));
+  proto.set("name", StringNode(imf, ""));
+
+  VectorNode           codecs(imf, true);
+  CompressedVectorNode points(imf, proto, codecs);
+
+  VectorNode    data3D(imf, true);
+  StructureNode scan(imf);
+  scan.set("guid", StringNode(imf, SCAN_GUID));
+  scan.set("points", points);
+  data3D.append(scan);
+  root.set("data3D", data3D);
+
+  std::vector<SourceDestBuffer> bufs;
+  bufs.push_back(SourceDestBuffer(imf, "cartesianX", x.data(), MAX_CHUNK, true, true));
+  bufs.push_back(SourceDestBuffer(imf, "cartesianY", y.data(), MAX_CHUNK));
+  bufs.push_back(SourceDestBuffer(imf, "timeStamp", timeStamp.data(), MAX_CHUNK));
+  bufs.push_back(SourceDestBuffer(imf, "intensity", intensity.data(), MAX_CHUNK, true));
+  bufs.push_back(SourceDestBuffer(imf, "colorRed", red.data(), MAX_CHUNK, true));
+  bufs.push_back(SourceDestBuffer(imf, "name", &name));
+
+  CompressedVectorWriter writer = points.writer(bufs);
+  uint64_t               next   = 0;
+  for (size_t chunk = 0; next < RECORD_COUNT; ++chunk)
+  {
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZES[chunk % std::size(CHUNK_SIZES)], RECORD_COUNT - next));
+    for (size_t i = 0; i < count; ++i)
+    {
+      const uint64_t k = next + i;
+      x[i]             = static_cast<double>(k % 2000000) * 0.001 - 1000.0;
+      y[i]             = static_cast<float>(k) * 0.5f;
+      timeStamp[i]     = static_cast<double>(k) * 1e-6;
+      intensity[i]     = static_cast<uint16_t>((k * 37) % 4096);
+      red[i]           = static_cast<uint8_t>(k * 7);
+      name[i]          = (k % 13 == 0) ? ustring(k % 29, static_cast<char>('a' + k % 26)) : ustring();
+    }
+    writer.write(count);
+    next += count;
+  }
+  writer.close();
+
+  imf.close();
+}
+
 // FNV-1a 64-bit: offset_basis=14695981039346656037, prime=1099511628211
 uint64_t fnv1a64(const std::vector<uint8_t>& data)
 {
@@ -136,7 +208,7 @@ TEST_SUITE("E57 Golden File Tests")
   //   3. Copy the printed hash into EXPECTED_HASH and rebuild.
   TEST_CASE("Deterministic XYZ point cloud matches known file hash")
   {
-    static constexpr uint64_t EXPECTED_HASH = 0x8E230DA0FE209BCCULL;
+    static constexpr uint64_t EXPECTED_HASH = 0xED1A8E800EFC4956ULL;
 
     TempFile tempFile;
     REQUIRE_NOTHROW(writeDeterministicE57(tempFile.string()));
@@ -160,6 +232,28 @@ TEST_SUITE("E57 Golden File Tests")
     }
   }
 
+  // Pins how the writer splits records into data packets.  The hash was recorded from the writer that encoded
+  // in rounds of 50 records, before records were scheduled by packet budget, and must not change.
+  TEST_CASE("Mixed field multi-packet point cloud matches known file hash")
+  {
+    static constexpr uint64_t EXPECTED_HASH = 0x253F3C7E37E3B769ULL;
+
+    TempFile tempFile;
+    REQUIRE_NOTHROW(writeMixedMultiPacketE57(tempFile.string()));
+    REQUIRE(tempFile.exists());
+
+    const std::vector<uint8_t> bytes  = readFileBytes(tempFile.string());
+    const uint64_t             actual = fnv1a64(bytes);
+
+    std::ostringstream oss;
+    oss << "0x" << std::uppercase << std::hex << std::setw(16) << std::setfill('0') << actual;
+    INFO("Actual hash: ", oss.str());
+
+    // Many data packets of the largest size, so packet boundaries are covered
+    CHECK(bytes.size() > 16 * 64 * 1024);
+    CHECK_EQ(actual, EXPECTED_HASH);
+  }
+
   TEST_CASE("Deterministic XYZ point cloud survives write-read round-trip")
   {
     TempFile tempFile;
@@ -282,4 +282,121 @@ TEST_SUITE("ImageFile Tests")
     imf1.close();
     imf2.close();
   }
+
+  TEST_CASE("ImageFile mmap configuration reads same data as default")
+  {
+    TempFile      tempFile;
+    const int64_t nBytes = 5000; // spans several 1020 byte logical pages
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("name", StringNode(imf, "mmap test"));
+      BlobNode blob(imf, nBytes);
+      root.set("blob", blob);
+      std::vector<uint8_t> data(nBytes);
+      for (int64_t i = 0; i < nBytes; i++)
+        data[i] = static_cast<uint8_t>(i * 7 + 3);
+      blob.write(data.data(), 0, nBytes);
+      imf.close();
+    }
+
+    ImageFile imf(tempFile.c_str(), "r", "mmap");
+    REQUIRE(imf.isOpen());
+    StructureNode root = imf.root();
+    REQUIRE_EQ(StringNode(root.get("name")).value(), "mmap test");
+
+    BlobNode             blob(root.get("blob"));
+    std::vector<uint8_t> data(nBytes);
+    blob.read(data.data(), 0, nBytes);
+    for (int64_t i = 0; i < nBytes; i++)
+      REQUIRE_EQ(data[i], static_cast<uint8_t>(i * 7 + 3));
+
+    /// Unaligned read crossing a page boundary
+    uint8_t part[100];
+    blob.read(part, 1000, sizeof(part));
+    for (int64_t i = 0; i < 100; i++)
+      REQUIRE_EQ(part[i], static_cast<uint8_t>((1000 + i) * 7 + 3));
+
+    imf.close();
+    REQUIRE(!imf.isOpen());
+  }
+
+  TEST_CASE("ImageFile mmap configuration detects bad checksum")
+  {
+    TempFile tempFile;
+    {
+      ImageFile imf(tempFile.c_str(), "w");
+      imf.root().set("name", StringNode(imf, "corrupt me"));
+      imf.close();
+    }
+    e57::test::corruptBinaryFile(tempFile.string());
+
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_CHECKSUM, [&]() { ImageFile imf(tempFile.c_str(), "r", "mmap"); }));
+  }
+
+  TEST_CASE("ImageFile rejects unknown configuration option")
+  {
+    TempFile tempFile;
+    REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_CONFIGURATION, [&]() { ImageFile imf(tempFile.c_str(), "w", "noSuchOption"); }));
+  }
+
+  TEST_CASE("ImageFile rejects bad prefetch option values")
+  {
+    TempFile tempFile;
+    {
+      ImageFile imf(tempFile.c_str(), "w");
+      imf.close();
+    }
+
+    const char* bad[] = {"prefetch", "prefetch=", "prefetch=0", "prefetch=x", "prefetch=3x", "prefetch=-1", "prefetch=65"};
+    for (const char* configuration : bad)
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_CONFIGURATION, [&]() { ImageFile imf(tempFile.c_str(), "r", configuration); }));
+
+    ImageFile imf(tempFile.c_str(), "r", "prefetch=64, mmap");
+    REQUIRE(imf.isOpen());
+    imf.close();
+  }
+
+  TEST_CASE("ImageFile rejects bad decoders option values")
+  {
+    TempFile tempFile;
+    {
+      ImageFile imf(tempFile.c_str(), "w");
+      imf.close();
+    }
+
+    const char* bad[] = {"decoders", "decoders=", "decoders=0", "decoders=x", "decoders=2x", "decoders=-1", "decoders=65"};
+    for (const char* configuration : bad)
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_CONFIGURATION, [&]() { ImageFile imf(tempFile.c_str(), "r", configuration); }));
+
+    ImageFile imf(tempFile.c_str(), "r", "decoders=64 prefetch=8");
+    REQUIRE(imf.isOpen());
+    imf.close();
+  }
+
+  TEST_CASE("ImageFile rejects bad encoders option values")
+  {
+    TempFile tempFile;
+
+    const char* bad[] = {"encoders", "encoders=", "encoders=0", "encoders=x", "encoders=2x", "encoders=-1", "encoders=65"};
+    for (const char* configuration : bad)
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_CONFIGURATION, [&]() { ImageFile imf(tempFile.c_str(), "w", configuration); }));
+
+    ImageFile imf(tempFile.c_str(), "w", "encoders=64");
+    REQUIRE(imf.isOpen());
+    imf.close();
+  }
+
+  TEST_CASE("ImageFile rejects bad writequeue option values")
+  {
+    TempFile tempFile;
+
+    const char* bad[] = {"writequeue", "writequeue=", "writequeue=0", "writequeue=x", "writequeue=2x", "writequeue=-1", "writequeue=65"};
+    for (const char* configuration : bad)
+      REQUIRE(e57::test::throwsErrorCode(E57_ERROR_BAD_CONFIGURATION, [&]() { ImageFile imf(tempFile.c_str(), "w", configuration); }));
+
+    ImageFile imf(tempFile.c_str(), "w", "writequeue=64 encoders=2");
+    REQUIRE(imf.isOpen());
+    imf.close();
+  }
 }
@@ -473,7 +473,7 @@ TEST_SUITE("CompressedVector Stress Tests")
     }
   }
 
-  TEST_CASE("CompressedVectorReader seek throws not-implemented")
+  TEST_CASE("CompressedVectorReader seek with 64 bit integers")
   {
     TempFile tempFile;
 
@@ -518,7 +518,13 @@ TEST_SUITE("CompressedVector Stress Tests")
       buffers.push_back(SourceDestBuffer(imf, "value", readData, 10, true, true));
 
       CompressedVectorReader reader = cv.reader(buffers);
-      REQUIRE_THROWS_AS(reader.seek(0), E57Exception);
+      reader.seek(4);
+      REQUIRE_EQ(N - 4, reader.read());
+      for (size_t i = 4; i < N; ++i)
+      {
+        REQUIRE_EQ(data[i], readData[i - 4]);
+      }
+      REQUIRE_THROWS_AS(reader.seek(N + 1), E57Exception);
 
       reader.close();
       imf.close();
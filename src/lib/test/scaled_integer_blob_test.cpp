@@ -30,6 +30,7 @@
 
 #include "test_utils.h"
 
+#include <algorithm>
 #include <cstring>
 
 using namespace e57;
@@ -254,6 +255,50 @@ TEST_SUITE("BlobNode Tests")
     }
   }
 
+  TEST_CASE("BlobNode large multi-page read")
+  {
+    TempFile tempFile;
+
+    // Larger than one read batch of physical pages, and not a multiple of the logical page size
+    std::vector<uint8_t> fullData(3 * 1024 * 1024 + 123);
+    for (size_t i = 0; i < fullData.size(); ++i)
+    {
+      fullData[i] = static_cast<uint8_t>(i * 31 + (i >> 10));
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "w");
+      StructureNode root = imf.root();
+      root.set("formatName", StringNode(imf, "ASTM E57 3D Imaging Data File"));
+      root.set("guid", StringNode(imf, "{00000000-0000-0000-0000-000000000012}"));
+
+      BlobNode blob(imf, static_cast<int64_t>(fullData.size()));
+      root.set("largeBlob", blob);
+      blob.write(fullData.data(), 0, fullData.size());
+
+      imf.close();
+    }
+
+    {
+      ImageFile     imf(tempFile.c_str(), "r");
+      StructureNode root = imf.root();
+
+      BlobNode blob(root.get("largeBlob"));
+
+      std::vector<uint8_t> readData(fullData.size());
+      blob.read(readData.data(), 0, readData.size());
+      REQUIRE(readData == fullData);
+
+      // Unaligned range that starts and ends in the middle of pages
+      int64_t              start = 1019;
+      std::vector<uint8_t> partialData(2 * 1024 * 1024 + 7);
+      blob.read(partialData.data(), start, partialData.size());
+      REQUIRE(std::equal(partialData.begin(), partialData.end(), fullData.begin() + start));
+
+      imf.close();
+    }
+  }
+
   TEST_CASE("BlobNode empty blob")
   {
     TempFile  tempFile;
@@ -2,8 +2,9 @@
  * simple_api_advanced_test.cpp - Tests for Simple API methods not previously covered:
  *   Reader::GetData3DSizes(), Reader::ReadData3DGroupsData(),
  *   Writer::WriteData3DGroupsData(), Writer::SetUpData3DPointsData() with optional
- *   buffers (intensity, color, timestamps, spherical), and Reset() on E57Root /
- *   Data3D / Image2D, plus untested ScaledIntegerNode constructors.
+ *   buffers (intensity, color, timestamps, spherical), Reader::ReadData3DPoints(),
+ *   and Reset() on E57Root / Data3D / Image2D, plus untested ScaledIntegerNode
+ *   constructors.
  *
  * Copyright (c) 2024 openE57 Contributors
  *
@@ -73,6 +74,98 @@ void writeScanXYZ(const std::string& path, const std::string& guid, int64_t N)
   writer.Close();
 }
 
+/// Writes a scan with scaled integer coordinates, float intensity and 16 bit color
+void writeScanXYZIntensityColor(const std::string& path, int64_t N)
+{
+  Writer writer(path, "");
+
+  Data3D scan;
+  scan.guid                                = "{00000000-0000-0000-0000-000000000520}";
+  scan.pointFields.cartesianXField         = true;
+  scan.pointFields.cartesianYField         = true;
+  scan.pointFields.cartesianZField         = true;
+  scan.pointFields.intensityField          = true;
+  scan.pointFields.colorRedField           = true;
+  scan.pointFields.colorGreenField         = true;
+  scan.pointFields.colorBlueField          = true;
+  scan.pointFields.pointRangeScaledInteger = 0.001;
+  scan.pointFields.pointRangeMinimum       = -1000.0;
+  scan.pointFields.pointRangeMaximum       = 1000.0;
+  scan.pointFields.intensityScaledInteger  = E57_NOT_SCALED_USE_FLOAT;
+  scan.intensityLimits.intensityMinimum    = 0.0;
+  scan.intensityLimits.intensityMaximum    = 1.0;
+  scan.colorLimits.colorRedMinimum         = 0.0;
+  scan.colorLimits.colorRedMaximum         = 65535.0;
+  scan.colorLimits.colorGreenMinimum       = 0.0;
+  scan.colorLimits.colorGreenMaximum       = 65535.0;
+  scan.colorLimits.colorBlueMinimum        = 0.0;
+  scan.colorLimits.colorBlueMaximum        = 65535.0;
+
+  int32_t idx = writer.NewData3D(scan);
+
+  std::vector<double>   X(static_cast<size_t>(N));
+  std::vector<double>   Y(static_cast<size_t>(N));
+  std::vector<double>   Z(static_cast<size_t>(N));
+  std::vector<double>   intensity(static_cast<size_t>(N));
+  std::vector<uint16_t> colorR(static_cast<size_t>(N));
+  std::vector<uint16_t> colorG(static_cast<size_t>(N));
+  std::vector<uint16_t> colorB(static_cast<size_t>(N));
+  for (int64_t i = 0; i < N; ++i)
+  {
+    size_t k     = static_cast<size_t>(i);
+    X[k]         = static_cast<double>(i % 1000000) * 0.001;
+    Y[k]         = -static_cast<double>(i % 1000) * 0.5;
+    Z[k]         = static_cast<double>(i % 7);
+    intensity[k] = static_cast<double>(i % 100) / 100.0;
+    colorR[k]    = static_cast<uint16_t>(i);
+    colorG[k]    = static_cast<uint16_t>(i * 3);
+    colorB[k]    = static_cast<uint16_t>(i * 7);
+  }
+
+  CompressedVectorWriter cvWriter = writer.SetUpData3DPointsData(idx, N, X.data(), Y.data(), Z.data(), nullptr, intensity.data(), nullptr, colorR.data(),
+                                                                 colorG.data(), colorB.data());
+  cvWriter.write(static_cast<size_t>(N));
+  cvWriter.close();
+
+  writer.Close();
+}
+
+void checkPoints(const Data3DPointsData& pointsData, int64_t N)
+{
+  REQUIRE_EQ(N, pointsData.pointCount);
+
+  /// Only the fields in the prototype get arrays, and each one is aligned
+  REQUIRE(pointsData.cartesianX != nullptr);
+  REQUIRE(pointsData.cartesianY != nullptr);
+  REQUIRE(pointsData.cartesianZ != nullptr);
+  REQUIRE(pointsData.intensity != nullptr);
+  REQUIRE(pointsData.colorRed != nullptr);
+  REQUIRE(pointsData.colorGreen != nullptr);
+  REQUIRE(pointsData.colorBlue != nullptr);
+  REQUIRE(pointsData.cartesianInvalidState == nullptr);
+  REQUIRE(pointsData.sphericalRange == nullptr);
+  REQUIRE(pointsData.rowIndex == nullptr);
+  REQUIRE(pointsData.timeStamp == nullptr);
+  REQUIRE(pointsData.isColorInvalid == nullptr);
+
+  const void* arrays[] = {pointsData.cartesianX, pointsData.cartesianY, pointsData.cartesianZ, pointsData.intensity,
+                          pointsData.colorRed,   pointsData.colorGreen, pointsData.colorBlue};
+  for (const void* array : arrays)
+    REQUIRE_EQ(0U, reinterpret_cast<uintptr_t>(array) % Data3DPointsData::alignment);
+
+  for (int64_t i = 0; i < N; ++i)
+  {
+    size_t k = static_cast<size_t>(i);
+    REQUIRE(e57::test::approxEqual(static_cast<double>(i % 1000000) * 0.001, pointsData.cartesianX[k], 1e-6));
+    REQUIRE(e57::test::approxEqual(-static_cast<double>(i % 1000) * 0.5, pointsData.cartesianY[k], 1e-6));
+    REQUIRE(e57::test::approxEqual(static_cast<double>(i % 7), pointsData.cartesianZ[k], 1e-6));
+    REQUIRE(e57::test::approxEqual(static_cast<double>(i % 100) / 100.0, pointsData.intensity[k], 1e-6));
+    REQUIRE_EQ(static_cast<uint16_t>(i), pointsData.colorRed[k]);
+    REQUIRE_EQ(static_cast<uint16_t>(i * 3), pointsData.colorGreen[k]);
+    REQUIRE_EQ(static_cast<uint16_t>(i * 7), pointsData.colorBlue[k]);
+  }
+}
+
 } // namespace
 
 TEST_SUITE("Reader::GetData3DSizes Tests")
@@ -285,6 +378,72 @@ TEST_SUITE("SetUpData3DPointsData with optional fields Tests")
   }
 }
 
+TEST_SUITE("Reader::ReadData3DPoints Tests")
+{
+  TEST_CASE("ReadData3DPoints allocates and fills the arrays of the prototype fields")
+  {
+    TempFile      tempFile;
+    const int64_t N = 150000;
+    writeScanXYZIntensityColor(tempFile.string(), N);
+
+    Reader           reader(tempFile.string());
+    Data3DPointsData pointsData;
+    REQUIRE(reader.ReadData3DPoints(0, pointsData));
+    checkPoints(pointsData, N);
+
+    /// Reading again replaces the arrays
+    REQUIRE(reader.ReadData3DPoints(0, pointsData));
+    checkPoints(pointsData, N);
+
+    pointsData.Reset();
+    REQUIRE_EQ(0, pointsData.pointCount);
+    REQUIRE(pointsData.cartesianX == nullptr);
+
+    reader.Close();
+  }
+
+  TEST_CASE("ReadData3DPoints lays the arrays out in a caller supplied block")
+  {
+    TempFile      tempFile;
+    const int64_t N = 1000;
+    writeScanXYZIntensityColor(tempFile.string(), N);
+
+    Reader  reader(tempFile.string());
+    int64_t blockSize = reader.GetData3DPointsDataSize(0);
+    REQUIRE(blockSize >= static_cast<int64_t>(N * (4 * sizeof(double) + 3 * sizeof(uint16_t))));
+
+    /// The block doesn't need to be aligned
+    std::vector<char> storage(static_cast<size_t>(blockSize) + 1);
+    char*             block = storage.data() + 1;
+
+    Data3DPointsData pointsData;
+    REQUIRE(!reader.ReadData3DPoints(0, pointsData, block, blockSize - 1));
+    REQUIRE(pointsData.cartesianX == nullptr);
+
+    REQUIRE(reader.ReadData3DPoints(0, pointsData, block, blockSize));
+    checkPoints(pointsData, N);
+    REQUIRE(reinterpret_cast<char*>(pointsData.cartesianX) >= block);
+    REQUIRE(reinterpret_cast<char*>(pointsData.colorBlue + N) <= block + blockSize);
+
+    reader.Close();
+  }
+
+  TEST_CASE("ReadData3DPoints returns false for out-of-range index")
+  {
+    TempFile tempFile;
+    writeScanXYZ(tempFile.string(), "{00000000-0000-0000-0000-000000000521}", 5);
+
+    Reader           reader(tempFile.string());
+    Data3DPointsData pointsData;
+    REQUIRE_EQ(-1, reader.GetData3DPointsDataSize(1));
+    REQUIRE(!reader.ReadData3DPoints(1, pointsData));
+    REQUIRE(!reader.ReadData3DPoints(-1, pointsData));
+    REQUIRE_EQ(0, pointsData.pointCount);
+
+    reader.Close();
+  }
+}
+
 TEST_SUITE("Reset() Methods Tests")
 {
   TEST_CASE("E57Root::Reset resets numeric fields to defaults")
@@ -41,6 +41,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <random>
@@ -127,6 +128,16 @@ namespace test
     }
   }
 
+  /**
+   * @brief Read the whole of a file, e.g. to compare the bytes of files
+   * written in different ways.
+   */
+  inline std::vector<char> readFileBytes(const TempFile& file)
+  {
+    std::ifstream stream(file.c_str(), std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+  }
+
   // ====================================================================
   // Assertion Helpers
   // ====================================================================